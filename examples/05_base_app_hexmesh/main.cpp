@@ -12,6 +12,35 @@
 #include <QApplication>
 #include <cinolib/meshes/meshes.h>
 #include <cinolib/gui/qt/qt_gui_tools.h>
+#include <cinolib/quality_report.h>
+#include <cinolib/profiler.h>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+void batch_vs_single(const cinolib::Hexmesh<> & m)
+{
+    using namespace cinolib;
+
+    Profiler profiler;
+    std::vector<double> q_single(m.num_polys());
+    std::vector<double> q_batch;
+
+    profiler.push("single scaled jacobian");
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        q_single.at(pid) = hex_scaled_jacobian(m.poly_vert(pid,0), m.poly_vert(pid,1), m.poly_vert(pid,2), m.poly_vert(pid,3),
+                                               m.poly_vert(pid,4), m.poly_vert(pid,5), m.poly_vert(pid,6), m.poly_vert(pid,7));
+    }
+    profiler.pop();
+
+    profiler.push("batch scaled jacobian");
+    polys_quality(m, SCALED_JACOBIAN, q_batch);
+    profiler.pop();
+
+    uint n_diff = 0;
+    for(uint pid=0; pid<m.num_polys(); ++pid) if(q_single.at(pid)!=q_batch.at(pid)) ++n_diff;
+    std::cout << n_diff << " elements differ between single and batch evaluation" << std::endl;
+}
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -25,6 +54,9 @@ int main(int argc, char **argv)
 
     DrawableHexmesh<> m(s.c_str());
 
+    batch_vs_single(m);
+    std::cout << quality_report(m) << std::endl;
+
     GLcanvas gui;
     gui.push_obj(&m);
     gui.show();
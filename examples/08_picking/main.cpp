@@ -4,12 +4,15 @@
  * into a point in space. The mesh point that minimizes the distance
  * from it is then selected and colored in RED for visual feedback.
  *
- * Notice that despite this implementation of picking is sub-optimal
- * (its complexity is O(n), with n being the number of mesh vertices)
- * it is fast enough to work in real time with meshes of moderate size.
+ * Picking queries are accelerated with a kd-tree, which is built at
+ * the first query and then reused until the mesh changes. Its cost is
+ * therefore O(log n), with n being the number of mesh vertices.
  *
- * For huge meshes, better performances can be achieved by using a spatial
- * data structure, such as Octrees or AABB trees.
+ * SHIFT + click casts a ray from the camera through the mouse position,
+ * and picks the first triangle hit by it (accelerated with a BVH), whose
+ * vertices are then colored in RED.
+ * Differently from the click unprojection, this does not need to read
+ * the Z buffer, and does not depend on what has been rendered.
  *
  * Enjoy!
 */
@@ -37,6 +40,7 @@ int main(int argc, char **argv)
     gui.show();
     gui.push_obj(&m);
     gui.push_marker(vec2i(10, gui.height()-20), "CMD + click to select a vertex", Color::BLACK(), 12, 0);
+    gui.push_marker(vec2i(10, gui.height()-40), "SHIFT + click to select a triangle", Color::BLACK(), 12, 0);
 
     Profiler profiler;
 
@@ -56,6 +60,21 @@ int main(int argc, char **argv)
                 c->updateGL();
             }
         }
+        else if (e->modifiers() == Qt::ShiftModifier)
+        {
+            vec3d orig, dir;
+            vec2i click(e->x(), e->y());
+            c->unproject_ray(click, orig, dir);
+            profiler.push("Pick Triangle (ray)");
+            int pid = m.pick_poly(orig, dir);
+            profiler.pop();
+            if (pid>=0)
+            {
+                for(uint vid : m.adj_p2v(pid)) m.vert_data(vid).color = Color::RED();
+                m.updateGL();
+                c->updateGL();
+            }
+        }
     };
 
     // CMD+1 to show mesh controls.
@@ -79,6 +79,9 @@ int main(int argc, char **argv)
         profiler.push("Compute MCF");
         MCF(m_uvw, iters.value(), t.value(), conformalized.isChecked());
         profiler.pop();
+        profiler.push("Update normals");
+        m_uvw.update_normals();
+        profiler.pop();
         m_uvw.updateGL();
         gui_uvw.fit_scene();
     });
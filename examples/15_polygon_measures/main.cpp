@@ -16,6 +16,8 @@
 #include <cinolib/polygon_maximum_inscribed_circle.h>
 #include <cinolib/smallest_enclosing_disk.h>
 #include <cinolib/geometry/n_sided_poygon.h>
+#include <cinolib/geometry/polygon_utils.h>
+#include <cinolib/random_generator.h>
 
 using namespace cinolib;
 
@@ -73,6 +75,22 @@ int main(int argc, char **argv)
 
     Profiler profiler;
 
+    // ear cut triangulation of random star shaped polygons of increasing size
+    for(uint n : {10, 100, 1000, 10000})
+    {
+        std::vector<vec2d> poly;
+        for(uint i=0; i<n; ++i)
+        {
+            double angle = 2.0*M_PI*i/n;
+            double r     = 0.5 + random_double(i);
+            poly.push_back(vec2d(r*cos(angle), r*sin(angle)));
+        }
+        std::vector<uint> tris;
+        profiler.push("triangulate polygon with " + std::to_string(n) + " verts");
+        polygon_triangulate(poly, tris);
+        profiler.pop();
+    }
+
     QSlider::connect(&slider, &QSlider::valueChanged, [&]()
     {
         float t = static_cast<float>(slider.value()-slider.minimum())/static_cast<float>(slider.maximum()-slider.minimum());
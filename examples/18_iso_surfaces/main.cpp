@@ -65,6 +65,14 @@ int main(int argc, char **argv)
 
     Profiler profiler;
 
+    // extract 99 iso-surfaces in one pass, and report the throughput
+    std::vector<float> isovalues;
+    for(uint i=1; i<100; ++i) isovalues.push_back(static_cast<float>(i)/100.0);
+    profiler.push("extract 99 iso-surfaces");
+    Isosurface<> all_iso(m, isovalues);
+    double t = profiler.pop();
+    std::cout << m.num_polys()*isovalues.size()/t << " tets/second (" << all_iso.tris.size()/3 << " triangles)" << std::endl;
+
     QSlider::connect(&sl_iso, &QSlider::valueChanged, [&]()
     {
         profiler.push("update iso-surface");
@@ -2,6 +2,11 @@
  * and create a triangle mesh containing all its slices
  * and support structures.
  *
+ * If a (closed) triangle mesh is given in input instead,
+ * the mesh is first sliced into layers, which are saved
+ * in CLI format and then loaded as above. In this case
+ * the second argument is the layer thickness.
+ *
  * Enjoy!
 */
 
@@ -9,6 +14,10 @@
 #include <cinolib/meshes/meshes.h>
 #include <cinolib/gui/qt/qt_gui_tools.h>
 #include <cinolib/drawable_sliced_object.h>
+#include <cinolib/profiler.h>
+#include <cinolib/layer_slicing.h>
+#include <cinolib/io/write_CLI.h>
+#include <cinolib/string_utilities.h>
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -21,10 +30,45 @@ int main(int argc, char **argv)
     std::string s = (argc>1) ? std::string(argv[1]) : std::string(DATA_PATH) + "/T_supported.cli";
     double hatch  = (argc>2) ? atof(argv[2]) : 0.01;
 
+    Profiler profiler;
+
+    if(get_file_extension(s) != "cli")
+    {
+        Trimesh<> m(s.c_str());
+        double thickness = (argc>2) ? atof(argv[2]) : m.bbox().delta_z()/1000.0;
+        std::vector<double> z;
+        std::vector<std::vector<std::vector<vec3d>>> internal_polylines, external_polylines;
+        profiler.push("slice mesh");
+        slice_into_layers(m, thickness, z, internal_polylines, external_polylines);
+        double t = profiler.pop();
+        std::cout << z.size()/t << " layers/second (" << z.size() << " layers)" << std::endl;
+
+        s = s + ".cli";
+        std::vector<std::vector<std::vector<vec3d>>> open_polylines(z.size());
+        write_CLI(s.c_str(), z, internal_polylines, external_polylines, open_polylines);
+        hatch = 0.01;
+    }
+
     std::cout << "load " << s << std::endl;
     std::cout << "hatch is: " << hatch << std::endl;
 
+    profiler.push("load, process and triangulate slices");
     DrawableSlicedObj<> obj(s.c_str(), hatch);
+    profiler.pop();
+
+    // time one million point in slice queries
+    uint n_queries = 1000000;
+    uint n_inside  = 0;
+    profiler.push("point in slice queries");
+    for(uint i=0; i<n_queries; ++i)
+    {
+        uint  sid = i%obj.num_slices();
+        vec3d p   = obj.bbox().min + vec3d(obj.bbox().delta_x() * (i%1000)/1000.0,
+                                           obj.bbox().delta_y() * (i/1000)/1000.0, 0);
+        if(obj.slice_contains(sid, vec2d(p.x(),p.y()))) ++n_inside;
+    }
+    double t = profiler.pop();
+    std::cout << n_queries/t << " queries/second (" << n_inside << " points inside)" << std::endl;
 
     GLcanvas gui;
     gui.push_obj(&obj);
@@ -1,6 +1,10 @@
 /* This sample program computes the ambient occlusion of an input mesh,
  * and allows to smoothly blend it with the standard mesh shading to obtain
- * the desired shadows
+ * the desired shadows. AO is computed both on the GPU (rendering the mesh
+ * from many directions) and on the CPU (ray tracing, which does not need
+ * an OpenGL context), reporting timings and the ray tracing throughput.
+ * CPU AO is also computed on a scaled down copy of the mesh, to check that
+ * the result does not depend on the scale
  *
  * Enjoy!
 */
@@ -10,6 +14,7 @@
 #include <cinolib/meshes/meshes.h>
 #include <cinolib/gui/qt/qt_gui_tools.h>
 #include <cinolib/ambient_occlusion.h>
+#include <cinolib/ambient_occlusion_cpu.h>
 #include <cinolib/profiler.h>
 
 using namespace cinolib;
@@ -36,10 +41,22 @@ int main(int argc, char **argv)
     window.resize(600,600);
 
     Profiler profiler;
-    profiler.push("Compute AO");
+    profiler.push("Compute AO (GPU)");
     AO_srf<DrawableQuadmesh<>> AO(m);
     profiler.pop();
-    AO.copy_to_mesh(m);
+
+    profiler.push("Compute AO (CPU)");
+    AO_srf_cpu<DrawableQuadmesh<>> AO_cpu(m, 256);
+    double t = profiler.pop();
+    std::cout << AO_cpu.num_rays() << " rays traced (" << AO_cpu.num_rays()/t << " rays/s)" << std::endl;
+
+    // AO must not depend on the units the mesh is stored in (e.g. meters vs millimeters)
+    Quadmesh<> m_small(m.vector_verts(), m.vector_polys());
+    m_small.scale(0.001);
+    AO_srf_cpu<Quadmesh<>> AO_small(m_small, 256);
+    std::cout << "max AO difference with the mesh scaled by 0.001: " << (AO_cpu.values()-AO_small.values()).cwiseAbs().maxCoeff() << std::endl;
+
+    AO_cpu.copy_to_mesh(m);
     m.updateGL();
 
     QSlider::connect(&slider, &QSlider::valueChanged, [&]()
@@ -7,6 +7,7 @@
 #include <cinolib/string_utilities.h>
 #include <cinolib/stl_container_utilities.h>
 #include <cinolib/meshes/trimesh.h>
+#include <cinolib/profiler.h>
 
 using namespace cinolib;
 
@@ -38,9 +39,13 @@ int main(int argc, char **argv)
     }
     else if(ext.compare("STL")==0 || ext.compare("stl")==0)
     {
+        // STL files are triangle soups. Duplicated verts are merged while reading
+        Profiler profiler;
+        profiler.push("read STL");
         std::vector<uint> tris;
         read_STL(argv[1], verts, tris);
         polys = polys_from_serialized_vids(tris,3);
+        profiler.pop();
     }
     else if(ext.compare("HEDRA")==0 || ext.compare("hedra")==0)
     {
@@ -85,8 +90,12 @@ int main(int argc, char **argv)
     }
     else if(ext.compare("STL")==0 || ext.compare("stl")==0)
     {
-        Trimesh<> tmp(verts,polys);
-        tmp.save(argv[2]); // STL need surface normals, so I make the mesh
+        // STL need surface normals, so I make the mesh. Adjacencies are not
+        // needed to compute them, hence the mesh is built in soup mode
+        Trimesh<> tmp;
+        tmp.set_soup(true);
+        tmp.init(verts,polys);
+        tmp.save(argv[2]);
     }
     else if(ext.compare("NODE")==0 || ext.compare("node")==0 ||
             ext.compare("ELE")==0  || ext.compare("ele")==0)
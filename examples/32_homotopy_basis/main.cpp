@@ -46,15 +46,20 @@ int main(int argc, char **argv)
     m.show_wireframe(false);
     gui.push_obj(&m);
 
+    // search for the globally shortest basis, testing all vertices as candidate roots
+    // (roots are evaluated in parallel, and discarded as soon as they cannot beat the
+    // best basis found so far). Set data.max_roots to test only a subset of the vertices
     Profiler profiler;
-    std::vector<std::vector<uint>> basis;
-    std::vector<bool> tree, cotree;
-
-    uint root = 152; // best for torus
-    profiler.push("Homotopy basis");
-    double len = homotopy_basis(m, root, basis, tree, cotree);
+    HomotopyBasisData data;
+    data.globally_shortest = true;
+    profiler.push("Globally shortest homotopy basis");
+    homotopy_basis(m, data);
     profiler.pop();
-    std::cout << "Shortest homotopy basis centered at vertex " << root << ". Length is " << len << std::endl;
+    std::cout << data << std::endl;
+
+    const std::vector<std::vector<uint>> & basis  = data.loops;
+    const std::vector<bool>              & tree   = data.tree;
+    const std::vector<bool>              & cotree = data.cotree;
 
     // Visualization part
     DrawableSegmentSoup ss_basis;
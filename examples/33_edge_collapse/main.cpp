@@ -10,6 +10,47 @@
 #include <QApplication>
 #include <cinolib/meshes/meshes.h>
 #include <cinolib/gui/qt/qt_gui_tools.h>
+#include <cinolib/profiler.h>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// compares the batched editing operators (one connectivity rebuild for the whole
+// list of edges) with the equivalent sequence of single element operations
+template<class Mesh>
+void batch_vs_single(const std::string & filename)
+{
+    using namespace cinolib;
+
+    Profiler profiler;
+    Mesh m_single(filename.c_str());
+    Mesh m_batch (filename.c_str());
+
+    std::vector<uint> eids;
+    for(uint eid=0; eid<m_batch.num_edges(); eid+=2) eids.push_back(eid);
+
+    MeshIdMaps id_maps;
+    profiler.push("batch split");
+    std::vector<int> res = m_batch.edges_split(eids, id_maps);
+    profiler.pop();
+
+    uint n_split = 0;
+    for(int vid : res) if(vid>=0) ++n_split;
+    profiler.push("single split (x" + std::to_string(n_split) + ")");
+    for(uint i=0; i<n_split; ++i) m_single.edge_split(i%m_single.num_edges());
+    profiler.pop();
+
+    eids.clear();
+    for(uint eid=0; eid<m_batch.num_edges(); eid+=2) eids.push_back(eid);
+    profiler.push("batch collapse");
+    res = m_batch.edges_collapse(eids, id_maps);
+    profiler.pop();
+
+    uint n_collapse = 0;
+    for(int vid : res) if(vid>=0) ++n_collapse;
+    profiler.push("single collapse (x" + std::to_string(n_collapse) + ")");
+    for(uint i=0, n=0; i<m_single.num_edges() && n<n_collapse; ++i) if(m_single.edge_collapse(i)>=0) ++n;
+    profiler.pop();
+}
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -19,6 +60,9 @@ int main(int argc, char **argv)
 
     QApplication a(argc, argv);
 
+    batch_vs_single<Trimesh<>>(std::string(DATA_PATH) + "/bunny.obj");
+    batch_vs_single<Tetmesh<>>(std::string(DATA_PATH) + "/sphere.mesh");
+
     std::string s = (argc==2) ? std::string(argv[1]) : std::string(DATA_PATH) + "/circle.obj";
 
     DrawableTrimesh<> m(s.c_str());
@@ -1,7 +1,9 @@
 /* This is a base application for cinolib (https://github.com/maxicino/cinolib).
  *
  * It will take in input a triangle mesh, and compute the Hermite RBF that
- * interpolates its vertices and (per vertex) normals
+ * interpolates its vertices and (per vertex) normals. Before that, it will
+ * benchmark fitting and evaluation times of the global (dense) HRBF and of its
+ * partition of unity counterpart, for a growing number of oriented points
  *
  * Enjoy!
 */
@@ -11,17 +13,61 @@
 #include <cinolib/meshes/meshes.h>
 #include <cinolib/tetgen_wrap.h>
 #include <cinolib/RBF_Hermite.h>
+#include <cinolib/RBF_Hermite_PU.h>
 #include <cinolib/RBF_kernels.h>
+#include <cinolib/sphere_coverage.h>
 #include <cinolib/profiler.h>
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// fit/eval time versus number of points, for points sampling the unit sphere
+// (normals coincide with positions). The HRBF is evaluated on a 32^3 grid
+void benchmark()
+{
+    using namespace cinolib;
+
+    Profiler profiler;
+    vec3d min(-1.5,-1.5,-1.5);
+    vec3d max( 1.5, 1.5, 1.5);
+
+    for(uint n=250; n<=128000; n*=2)
+    {
+        std::vector<vec3d> points;
+        sphere_coverage(n, points);
+
+        profiler.push("n = " + std::to_string(n));
+
+        if(n<=1000) // the dense solver is O(n^3)...
+        {
+            profiler.push("dense HRBF fit");
+            Hermite_RBF<CubicRBF> HRBF(points, points);
+            profiler.pop();
+            profiler.push("dense HRBF eval");
+            HRBF.eval_grid(min, max, 32, 32, 32);
+            profiler.pop();
+        }
+
+        profiler.push("PU HRBF fit");
+        Hermite_RBF_PU<CubicRBF> HRBF_PU(points, points);
+        profiler.pop();
+        profiler.push("PU HRBF eval");
+        HRBF_PU.eval_grid(min, max, 32, 32, 32);
+        profiler.pop();
+
+        profiler.pop();
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 int main(int argc, char **argv)
 {
     using namespace cinolib;
 
     QApplication a(argc, argv);
 
+    benchmark();
+
     std::string s = (argc==2) ? std::string(argv[1]) : std::string(DATA_PATH) + "/sphere_coarse.obj";
 
     // load, center the mesh in the origin, and scale it
@@ -36,9 +82,10 @@ int main(int argc, char **argv)
     tetgen_wrap(srf_target.bbox().corners(1.5), srf_target.bbox().tris(), dummy, "qa0.00002", vol_sampling);
 
     // HRBF computatin,  using x^3 as RBF kernel
+    // (the partition of unity version scales to inputs with many thousands of points)
     Profiler profiler;
     profiler.push("Make HRBF");
-    Hermite_RBF<CubicRBF> HRBF(srf_target.vector_verts(), srf_target.vector_vert_normals());
+    Hermite_RBF_PU<CubicRBF> HRBF(srf_target.vector_verts(), srf_target.vector_vert_normals());
     profiler.pop();
 
     // evaluate the BRBF at each volume point
@@ -8,6 +8,8 @@ INCLUDEPATH    += $$PWD/../../include
 DEFINES        += CINOLIB_USES_OPENGL
 DEFINES        += CINOLIB_USES_QT
 QMAKE_CXXFLAGS += -Wno-deprecated-declarations # gluQuadric gluSphere and gluCylinde are deprecated in macOS 10.9
+DATA_PATH       = \\\"$$PWD/../data/\\\"
+DEFINES        += DATA_PATH=$$DATA_PATH
 SOURCES        += main.cpp
 
 # just for Linux
@@ -5,6 +5,13 @@
  *   Robert Bridson
  *   SIGGRAPH Technical Sketch, 2007
  *
+ * and on the surface of a mesh, using the parallel
+ * phase group sampler described in:
+ *
+ *   Parallel Poisson Disk Sampling
+ *   Li-Yi Wei
+ *   ACM SIGGRAPH, 2008
+ *
  * Enjoy!
 */
 
@@ -30,8 +37,10 @@ int main(int argc, char **argv)
     QWidget window;
     GLcanvas gui_2d;
     GLcanvas gui_3d;
+    GLcanvas gui_srf;
     gui_2d.setMinimumSize(400,400);
     gui_3d.setMinimumSize(400,400);
+    gui_srf.setMinimumSize(400,400);
     QDoubleSpinBox sb_radius(&window);
     QPushButton but_compute_samples("Update samples", &window);
     sb_radius.setMinimum(1e-4);
@@ -45,6 +54,7 @@ int main(int argc, char **argv)
     layout.addWidget(&but_compute_samples,0,2);
     layout.addWidget(&gui_2d,1,0,1,3);
     layout.addWidget(&gui_3d,1,3,1,3);
+    layout.addWidget(&gui_srf,1,6,1,3);
     window.setLayout(&layout);
     window.show();
 
@@ -55,10 +65,18 @@ int main(int argc, char **argv)
     m_2d.show_wireframe_width(6);
     m_3d.show_wireframe_width(3);
 
+    std::string s = (argc==2) ? std::string(argv[1]) : std::string(DATA_PATH) + "/bunny.obj";
+    DrawableTrimesh<> m_srf(s.c_str());
+    DrawableTrimesh<> m_srf_samples;
+    m_srf_samples.show_mesh_points();
+    m_srf_samples.show_wireframe_width(3);
+    gui_srf.push_obj(&m_srf);
+
     QPushButton::connect(&but_compute_samples, &QPushButton::clicked, [&]()
     {
         m_2d.clear();
         m_3d.clear();
+        m_srf_samples.clear();
 
         std::vector<vec2d> samples_2d;
         profiler.push("Poisson sampling 2D");
@@ -75,6 +93,27 @@ int main(int argc, char **argv)
         for(auto p : samples_3d) m_3d.vert_add(p);
         m_3d.vert_set_color(Color::BLACK());
         gui_3d.push_obj(&m_3d);
+
+        // same as above, but with a sparse (hashed) acceleration grid
+        std::vector<vec3d> samples_3d_sparse;
+        profiler.push("Poisson sampling 3D (sparse grid)");
+        Poisson_sampling_sparse<3,vec3d>(sb_radius.value(), vec3d(0,0,0), vec3d(1,1,1), samples_3d_sparse);
+        profiler.pop();
+        // grid memory is estimated from the number of cells (dense) or of hash map
+        // entries (sparse: key, value, node and bucket pointers). It is not measured
+        std::cout << samples_3d.size() << " samples. Estimated grid memory: dense "
+                  << std::pow(std::ceil(std::sqrt(3.0)/(0.999*sb_radius.value())),3)*sizeof(int)/1024 << "KB, sparse ~"
+                  << samples_3d_sparse.size()*(sizeof(unsigned long int)+sizeof(int)+3*sizeof(void*))/1024 << "KB" << std::endl;
+
+        // surface sampling (radius is relative to the bounding box diagonal)
+        std::vector<vec3d> samples_srf;
+        profiler.push("Poisson sampling on surface");
+        Poisson_sampling(m_srf, sb_radius.value()*m_srf.bbox().diag(), samples_srf);
+        profiler.pop();
+        std::cout << samples_srf.size() << " samples on surface" << std::endl;
+        for(auto p : samples_srf) m_srf_samples.vert_add(p);
+        m_srf_samples.vert_set_color(Color::BLACK());
+        gui_srf.push_obj(&m_srf_samples, false);
     });
 
     emit(but_compute_samples.click());
@@ -0,0 +1,93 @@
+/* This sample program measures the effect of element ordering on
+ * adjacency intensive tasks (Laplacian assembly, sparse matrix-vector
+ * products and Dijkstra). Element ids are first scrambled, to emulate
+ * a mesh coming from a file with no locality at all, and then sorted
+ * along a Morton curve, a Hilbert curve, or with the reverse Cuthill-McKee
+ * algorithm (command line tool).
+ *
+ * usage: mesh_reordering [mesh.obj] [loop subdivision levels]
+ *
+ * Enjoy!
+*/
+
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <cinolib/meshes/trimesh.h>
+#include <cinolib/reorder.h>
+#include <cinolib/laplacian.h>
+#include <cinolib/dijkstra.h>
+#include <cinolib/subdivision_loop.h>
+#include <cinolib/profiler.h>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+std::vector<int> random_permutation(const uint n, std::mt19937 & rng)
+{
+    std::vector<int> p(n);
+    std::iota(p.begin(), p.end(), 0);
+    std::shuffle(p.begin(), p.end(), rng);
+    return p;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+void benchmark(const Trimesh<> & m, const uint source, const std::string & tag)
+{
+    Profiler profiler;
+    const uint n_runs = 5;
+
+    profiler.push(tag + " - Laplacian assembly (x5)");
+    Eigen::SparseMatrix<double> L;
+    for(uint i=0; i<n_runs; ++i) L = laplacian(m, COTANGENT);
+    double t_lap = profiler.pop() / n_runs;
+
+    profiler.push(tag + " - SpMV (x100)");
+    Eigen::VectorXd x = Eigen::VectorXd::Ones(m.num_verts());
+    for(uint i=0; i<100; ++i) x = (L*x).normalized();
+    double t_spmv = profiler.pop() / 100;
+
+    profiler.push(tag + " - Dijkstra (x5)");
+    std::vector<double> dist;
+    for(uint i=0; i<n_runs; ++i) dijkstra_exhaustive(m, source, dist);
+    double t_dijkstra = profiler.pop() / n_runs;
+
+    std::cout << "\n" << tag << " (average times)\n"
+              << "\tLaplacian assembly : " << t_lap      << "s\n"
+              << "\tSpMV               : " << t_spmv     << "s\n"
+              << "\tDijkstra           : " << t_dijkstra << "s\n" << std::endl;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+int main(int argc, char **argv)
+{
+    std::string s = (argc>1) ? std::string(argv[1]) : std::string(DATA_PATH) + "bunny.obj";
+    uint n_levels = (argc>2) ? atoi(argv[2]) : 2;
+
+    Trimesh<> m_in(s.c_str()), m;
+    subdivision_loop(m_in, m, n_levels);
+    std::cout << m.num_verts() << " verts, " << m.num_polys() << " polys" << std::endl;
+
+    // scramble all element ids (vertices, edges and triangles)
+    std::mt19937 rng(0);
+    MeshIdMaps scramble;
+    scramble.v_map = random_permutation(m.num_verts(), rng);
+    scramble.e_map = random_permutation(m.num_edges(), rng);
+    scramble.p_map = random_permutation(m.num_polys(), rng);
+    m.permute(scramble);
+    benchmark(m, 0, "SCRAMBLED");
+
+    for(int strategy : { REORDER_MORTON, REORDER_HILBERT, REORDER_RCM })
+    {
+        Trimesh<> m_sorted = m;
+        Profiler profiler;
+        profiler.push("reorder " + reorder_strategy_txt[strategy]);
+        MeshIdMaps id_maps = reorder(m_sorted, (ReorderStrategy)strategy);
+        profiler.pop();
+        benchmark(m_sorted, id_maps.v_map.at(0), reorder_strategy_txt[strategy]); // same source vertex
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+/* This sample program splits a triangle mesh into balanced parts with
+ * the multilevel partitioner, extracts all parts (plus one halo layer)
+ * as standalone submeshes, and smooths them in parallel, one thread per
+ * part. Since each part contains the full one ring of the vertices it owns,
+ * gathering the owned vertices back gives the same result of smoothing the
+ * whole mesh at once, up to round off (command line tool).
+ *
+ * usage: mesh_partitioning [mesh.obj] [number of parts]
+ *
+ * Enjoy!
+*/
+
+#include <cinolib/meshes/trimesh.h>
+#include <cinolib/mesh_partitioning.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/profiler.h>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// one step of uniform Laplacian smoothing of the first n_verts vertices
+void smooth(Trimesh<> & m, const uint n_verts)
+{
+    std::vector<vec3d> pos(n_verts);
+    for(uint vid=0; vid<n_verts; ++vid)
+    {
+        vec3d c(0,0,0);
+        for(uint nbr : m.adj_v2v(vid)) c += m.vert(nbr);
+        pos.at(vid) = c / static_cast<double>(m.adj_v2v(vid).size());
+    }
+    for(uint vid=0; vid<n_verts; ++vid) m.vert(vid) = pos.at(vid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+int main(int argc, char **argv)
+{
+    std::string s = (argc>1) ? std::string(argv[1]) : std::string(DATA_PATH) + "bunny.obj";
+    uint n_parts  = (argc>2) ? atoi(argv[2]) : 8;
+
+    Trimesh<> m(s.c_str());
+    Profiler profiler;
+
+    profiler.push("partition");
+    std::vector<int> parts = mesh_partition(m, n_parts);
+    profiler.pop();
+
+    std::vector<std::vector<uint>> dual(m.num_polys());
+    for(uint pid=0; pid<m.num_polys(); ++pid) dual.at(pid) = m.adj_p2p(pid);
+    std::cout << "\nedge cut  : " << graph_edge_cut(dual, parts) << " (of " << m.num_edges() << " edges)"
+              << "\nimbalance : " << graph_partition_imbalance(parts, n_parts) << "\n" << std::endl;
+
+    profiler.push("export parts");
+    std::vector<Trimesh<>>     subm;
+    std::vector<PartitionMaps> maps;
+    export_partition(m, parts, 1, subm, maps);
+    profiler.pop();
+
+    for(uint i=0; i<n_parts; ++i)
+    {
+        std::cout << "part " << i << " : "
+                  << maps.at(i).n_own_polys << " polys (" << subm.at(i).num_polys() << " with halo), "
+                  << maps.at(i).n_own_verts << " verts (" << subm.at(i).num_verts() << " with halo)" << std::endl;
+    }
+
+    Trimesh<> m_ref = m;
+    profiler.push("smooth whole mesh");
+    smooth(m_ref, m_ref.num_verts());
+    profiler.pop();
+
+    profiler.push("smooth parts (in parallel)");
+    PARALLEL_FOR(0, n_parts, 1, [&](uint i)
+    {
+        smooth(subm.at(i), maps.at(i).n_own_verts);
+    });
+    gather_partition_verts(m, subm, maps);
+    profiler.pop();
+
+    double err = 0;
+    for(uint vid=0; vid<m.num_verts(); ++vid) err = std::max(err, m.vert(vid).dist(m_ref.vert(vid)));
+    std::cout << "\nmax distance from whole mesh smoothing: " << err << "\n" << std::endl;
+
+    return 0;
+}
@@ -61,8 +61,23 @@ bool Moller_Trumbore_intersection(const vec3d  & ray_orig,
                                         double & t,
                                         vec3d  & bary)
 {
-    const double EPSILON = 0.0000001;
+    return Moller_Trumbore_intersection(ray_orig, ray_dir, v0, v1, v2, hits_backside, are_coplanar, t, bary, 0.0000001);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+CINO_INLINE
+bool Moller_Trumbore_intersection(const vec3d  & ray_orig,
+                                  const vec3d  & ray_dir,
+                                  const vec3d  & v0,
+                                  const vec3d  & v1,
+                                  const vec3d  & v2,
+                                        bool   & hits_backside,
+                                        bool   & are_coplanar,
+                                        double & t,
+                                        vec3d  & bary,
+                                  const double   eps)
+{
     are_coplanar  = false;
     hits_backside = false;
 
@@ -75,7 +90,7 @@ bool Moller_Trumbore_intersection(const vec3d  & ray_orig,
     // NOTE: this does not mean they do not intersect, but they may not
     // meet at a single point, hence Moller-Trumbore is not the right tool...
     //
-    if(fabs(det) < EPSILON)
+    if(fabs(det) < eps)
     {
         are_coplanar = true;
         return false;
@@ -83,7 +98,7 @@ bool Moller_Trumbore_intersection(const vec3d  & ray_orig,
 
     // if the determinant is negative the triangle is backfacing
     //
-    if(det<-EPSILON) hits_backside = true;
+    if(det<-eps) hits_backside = true;
 
     double invDet = 1.0/det;
 
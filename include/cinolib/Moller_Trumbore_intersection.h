@@ -64,6 +64,22 @@ bool Moller_Trumbore_intersection(const vec3d  & ray_orig,
                                         bool   & are_coplanar,  // true if ray and triangle are coplanar (no intersection will be computed)
                                         double & t,
                                         vec3d  & bary);
+
+// same as above, but rays and triangles are deemed coplanar if |det| < eps.
+// The determinant scales with |ray_dir| and with the triangle edges, hence
+// for meshes of arbitrary scale eps should be relative to these quantities
+//
+CINO_INLINE
+bool Moller_Trumbore_intersection(const vec3d  & ray_orig,
+                                  const vec3d  & ray_dir,
+                                  const vec3d  & v0,
+                                  const vec3d  & v1,
+                                  const vec3d  & v2,
+                                        bool   & hits_backside,
+                                        bool   & are_coplanar,
+                                        double & t,
+                                        vec3d  & bary,
+                                  const double   eps);
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -37,6 +37,11 @@
 #include <cinolib/random_generator.h>
 #include <cinolib/serialize_index.h>
 #include <cinolib/min_max_inf.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/geometry/triangle_utils.h>
+#include <unordered_map>
+#include <algorithm>
+#include <array>
 
 namespace cinolib
 {
@@ -69,14 +74,39 @@ void sample_annulus(const double radius, const Point & center, uint & seed, Poin
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-template<uint Dim, class Point>
+// acceleration grids for the Bridson sampler. Each cell stores the index of the
+// (unique) sample it contains, or -1 if it is empty
+
+struct PoissonDenseGrid
+{
+    std::vector<int> cells;
+    PoissonDenseGrid(const unsigned long int size) : cells(size,-1) {}
+    int  get(const unsigned long int index) const { return cells[index]; }
+    void set(const unsigned long int index, const int sample) { cells[index] = sample; }
+};
+
+struct PoissonSparseGrid
+{
+    std::unordered_map<unsigned long int,int> cells;
+    PoissonSparseGrid(const unsigned long int) {}
+    int get(const unsigned long int index) const
+    {
+        auto query = cells.find(index);
+        return (query==cells.end()) ? -1 : query->second;
+    }
+    void set(const unsigned long int index, const int sample) { cells[index] = sample; }
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint Dim, class Point, class Grid>
 CINO_INLINE
-void Poisson_sampling(const double          radius,
-                      const Point           min,
-                      const Point           max,
-                      std::vector<Point> &  samples,
-                      uint                  seed,
-                      const int             max_attempts)
+void Poisson_sampling_Bridson(const double          radius,
+                              const Point           min,
+                              const Point           max,
+                              std::vector<Point> &  samples,
+                              uint                  seed,
+                              const int             max_attempts)
 {
     samples.clear();
     std::vector<uint> active_list;
@@ -90,7 +120,7 @@ void Poisson_sampling(const double          radius,
         dim_extent[i] = static_cast<uint>(std::ceil((max[i]-min[i])/step));
         grid_size *= dim_extent[i];
     }
-    std::vector<int> grid(grid_size, -1); // -1 indicates no sample there; otherwise index of sample point
+    Grid grid(grid_size); // -1 indicates no sample there; otherwise index of sample point
 
     // first sample
     Point x;
@@ -100,8 +130,8 @@ void Poisson_sampling(const double          radius,
     }
     samples.push_back(x);
     active_list.push_back(0);
-    uint index = serialize_nD_index<Dim,Point>(dim_extent, (x-min)/step);
-    grid[index] = 0;
+    unsigned long int index = serialize_nD_index<Dim,Point>(dim_extent, (x-min)/step);
+    grid.set(index, 0);
 
     while(!active_list.empty())
     {
@@ -141,10 +171,11 @@ void Poisson_sampling(const double          radius,
             {
                 // check if there's a sample at j that's too close to x
                 index = serialize_nD_index<Dim,Point>(dim_extent, j);
-                if(grid[index]>=0 && grid[index]!=p)
+                int s = grid.get(index);
+                if(s>=0 && s!=p)
                 {
                     // if there is a sample point different from p
-                    if((x - samples[grid[index]]).length_squared()<radius*radius) goto reject_sample;
+                    if((x - samples[s]).length_squared()<radius*radius) goto reject_sample;
                 }
 
                 // move on to next j
@@ -178,7 +209,7 @@ void Poisson_sampling(const double          radius,
             samples.push_back(x);
             active_list.push_back(id);
             index=serialize_nD_index<Dim,Point>(dim_extent, (x-min)/step);
-            grid[index]=(int)id;
+            grid.set(index, (int)id);
         }
         else
         {
@@ -189,4 +220,250 @@ void Poisson_sampling(const double          radius,
     }
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint Dim, class Point>
+CINO_INLINE
+void Poisson_sampling(const double          radius,
+                      const Point           min,
+                      const Point           max,
+                      std::vector<Point> &  samples,
+                      uint                  seed,
+                      const int             max_attempts)
+{
+    Poisson_sampling_Bridson<Dim,Point,PoissonDenseGrid>(radius, min, max, samples, seed, max_attempts);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint Dim, class Point>
+CINO_INLINE
+void Poisson_sampling_sparse(const double          radius,
+                             const Point           min,
+                             const Point           max,
+                             std::vector<Point> &  samples,
+                             uint                  seed,
+                             const int             max_attempts)
+{
+    Poisson_sampling_Bridson<Dim,Point,PoissonSparseGrid>(radius, min, max, samples, seed, max_attempts);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Poisson_sampling(const double               radius,
+                      const std::vector<vec3d> & candidates,
+                            std::vector<vec3d> & samples,
+                            uint                 seed)
+{
+    assert(radius>0);
+    samples.clear();
+    if(candidates.empty()) return;
+
+    vec3d min( inf_double, inf_double, inf_double);
+    for(const vec3d & p : candidates) min = min.min(p);
+
+    // cells of size radius: samples closer than radius are in the same cell or in adjacent ones.
+    // Cell coordinates are packed in a 64 bit key (21 bits per dimension)
+    auto cell_coords = [&](const vec3d & p)
+    {
+        std::array<uint,3> c;
+        for(uint i=0; i<3; ++i)
+        {
+            c[i] = static_cast<uint>((p[i]-min[i])/radius);
+            assert(c[i] < (1u<<21) && "Poisson_sampling: radius too small for the domain size");
+        }
+        return c;
+    };
+    auto cell_key = [](const std::array<uint,3> & c)
+    {
+        return ((unsigned long int)c[0]<<42) | ((unsigned long int)c[1]<<21) | (unsigned long int)c[2];
+    };
+
+    // sort candidates by cell, and randomly within each cell
+    std::vector<std::pair<unsigned long int,uint>> order(candidates.size());
+    PARALLEL_FOR(0, candidates.size(), 10000, [&](uint i)
+    {
+        order[i] = std::make_pair(cell_key(cell_coords(candidates[i])), random_uint(seed+i));
+    });
+    std::vector<uint> perm(candidates.size());
+    for(uint i=0; i<perm.size(); ++i) perm[i] = i;
+    std::sort(perm.begin(), perm.end(), [&](const uint a, const uint b) { return order[a] < order[b]; });
+
+    // compact cells (CSR layout)
+    std::vector<uint> cell_beg;
+    std::unordered_map<unsigned long int,uint> cell_id;
+    for(uint i=0; i<perm.size(); ++i)
+    {
+        if(i==0 || order[perm[i]].first != order[perm[i-1]].first)
+        {
+            cell_id[order[perm[i]].first] = cell_beg.size();
+            cell_beg.push_back(i);
+        }
+    }
+    uint n_cells = cell_beg.size();
+    cell_beg.push_back(perm.size());
+
+    // split cells in 27 phase groups, according to their coordinates modulo 3
+    std::array<std::vector<uint>,27> groups;
+    for(uint cid=0; cid<n_cells; ++cid)
+    {
+        std::array<uint,3> c = cell_coords(candidates[perm[cell_beg[cid]]]);
+        groups[(c[0]%3)*9 + (c[1]%3)*3 + c[2]%3].push_back(cid);
+    }
+
+    // process phase groups in sequence, and cells within a group in parallel.
+    // A cell writes only its own samples, and reads only the samples of its
+    // adjacent cells, which belong to other phase groups
+    std::vector<std::vector<vec3d>> cell_samples(n_cells);
+    double sq_radius = radius*radius;
+    for(const std::vector<uint> & group : groups)
+    {
+        PARALLEL_FOR(0, group.size(), 64, [&](uint i)
+        {
+            uint cid = group[i];
+            std::array<uint,3> c = cell_coords(candidates[perm[cell_beg[cid]]]);
+
+            // gather the adjacent cells that contain some candidate
+            std::vector<uint> nbrs;
+            for(int dx=-1; dx<=1; ++dx)
+            for(int dy=-1; dy<=1; ++dy)
+            for(int dz=-1; dz<=1; ++dz)
+            {
+                if(dx==0 && dy==0 && dz==0) continue;
+                if((dx<0 && c[0]==0) || (dy<0 && c[1]==0) || (dz<0 && c[2]==0)) continue;
+                std::array<uint,3> nc = {{ c[0]+dx, c[1]+dy, c[2]+dz }};
+                auto query = cell_id.find(cell_key(nc));
+                if(query!=cell_id.end()) nbrs.push_back(query->second);
+            }
+
+            for(uint j=cell_beg[cid]; j<cell_beg[cid+1]; ++j)
+            {
+                const vec3d & p = candidates[perm[j]];
+                bool accept = true;
+                for(const vec3d & s : cell_samples[cid])
+                {
+                    if(p.dist_squared(s)<sq_radius) { accept = false; break; }
+                }
+                for(uint k=0; accept && k<nbrs.size(); ++k)
+                for(const vec3d & s : cell_samples[nbrs[k]])
+                {
+                    if(p.dist_squared(s)<sq_radius) { accept = false; break; }
+                }
+                if(accept) cell_samples[cid].push_back(p);
+            }
+        });
+    }
+
+    for(const auto & cs : cell_samples)
+    {
+        samples.insert(samples.end(), cs.begin(), cs.end());
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void Poisson_sampling(const AbstractPolygonMesh<M,V,E,P> & m,
+                      const double                         radius,
+                            std::vector<vec3d>           & samples,
+                            uint                           seed,
+                      const int                            max_attempts)
+{
+    // flat list of triangles and their areas
+    std::vector<uint>   tris;
+    std::vector<double> area_cumsum;
+    double area = 0.0;
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        const std::vector<uint> & t = m.poly_tessellation(pid);
+        for(uint i=0; i+2<t.size(); i+=3)
+        {
+            tris.push_back(t[i  ]);
+            tris.push_back(t[i+1]);
+            tris.push_back(t[i+2]);
+            area += triangle_area(m.vert(t[i]), m.vert(t[i+1]), m.vert(t[i+2]));
+            area_cumsum.push_back(area);
+        }
+    }
+    if(area==0.0) { samples.clear(); return; }
+
+    // generate candidates with uniform density, so that each triangle
+    // receives an expected number of candidates proportional to its area
+    uint n_cand = std::max(1u, static_cast<uint>(max_attempts*area/(radius*radius)));
+    std::vector<vec3d> candidates(n_cand);
+    PARALLEL_FOR(0, n_cand, 10000, [&](uint i)
+    {
+        uint   s   = seed + 3*i;
+        double a   = random_double(s) * area;
+        uint   tid = std::min<uint>(std::lower_bound(area_cumsum.begin(), area_cumsum.end(), a) - area_cumsum.begin(), area_cumsum.size()-1);
+        double u   = random_double(s+1);
+        double v   = random_double(s+2);
+        if(u+v>1) { u = 1-u; v = 1-v; }
+        vec3d  A   = m.vert(tris[3*tid]);
+        candidates[i] = A + u*(m.vert(tris[3*tid+1])-A) + v*(m.vert(tris[3*tid+2])-A);
+    });
+
+    Poisson_sampling(radius, candidates, samples, seed+3*n_cand);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void Poisson_sampling(const Tetmesh<M,V,E,F,P> & m,
+                      const double               radius,
+                            std::vector<vec3d> & samples,
+                            uint                 seed,
+                      const int                  max_attempts)
+{
+    std::vector<double> vol_cumsum(m.num_polys());
+    double vol = 0.0;
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        vol += m.poly_volume(pid);
+        vol_cumsum[pid] = vol;
+    }
+    if(vol==0.0) { samples.clear(); return; }
+
+    // generate candidates with uniform density, so that each tet receives
+    // an expected number of candidates proportional to its volume. Points
+    // are uniformly distributed in each tet by folding the unit cube. See:
+    //
+    // Generating Random Points in a Tetrahedron
+    // C. Rocchini and P. Cignoni
+    // Journal of Graphics Tools, 2000
+    uint n_cand = std::max(1u, static_cast<uint>(max_attempts*vol/(radius*radius*radius)));
+    std::vector<vec3d> candidates(n_cand);
+    PARALLEL_FOR(0, n_cand, 10000, [&](uint i)
+    {
+        uint   seed_i = seed + 4*i;
+        double v      = random_double(seed_i) * vol;
+        uint   pid    = std::min<uint>(std::lower_bound(vol_cumsum.begin(), vol_cumsum.end(), v) - vol_cumsum.begin(), vol_cumsum.size()-1);
+        double s      = random_double(seed_i+1);
+        double t      = random_double(seed_i+2);
+        double u      = random_double(seed_i+3);
+        if(s+t>1) { s = 1-s; t = 1-t; }
+        if(t+u>1)
+        {
+            double tmp = u;
+            u = 1-s-t;
+            t = 1-tmp;
+        }
+        else if(s+t+u>1)
+        {
+            double tmp = u;
+            u = s+t+u-1;
+            s = 1-t-tmp;
+        }
+        candidates[i] = (1-s-t-u) * m.poly_vert(pid,0) +
+                                s * m.poly_vert(pid,1) +
+                                t * m.poly_vert(pid,2) +
+                                u * m.poly_vert(pid,3);
+    });
+
+    Poisson_sampling(radius, candidates, samples, seed+4*n_cand);
+}
+
 }
@@ -37,7 +37,10 @@
 #define CINO_POISSON_SAMPLING
 
 #include <cinolib/cino_inline.h>
+#include <cinolib/meshes/abstract_polygonmesh.h>
+#include <cinolib/meshes/tetmesh.h>
 #include <sys/types.h>
+#include <vector>
 
 namespace cinolib
 {
@@ -59,6 +62,74 @@ void Poisson_sampling(const double         radius,
                       uint                 seed=0,
                       const int            max_attempts=30);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Same as above, but the acceleration grid is sparse (hashed) and stores
+ * only the cells that actually contain a sample. The dense version allocates
+ * an int for each cell in the box, which becomes prohibitive for small radii
+ * and/or high dimensions. Memory is here proportional to the number of samples.
+*/
+
+template<uint Dim, class Point>
+CINO_INLINE
+void Poisson_sampling_sparse(const double         radius,
+                             const Point          min,
+                             const Point          max,
+                             std::vector<Point> & samples,
+                             uint                 seed=0,
+                             const int            max_attempts=30);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Parallel Poisson disk sampling by dart throwing over a pool of candidate
+ * points (e.g. uniformly distributed over some domain). Candidates are bucketed
+ * in a sparse grid with cells of size radius, and cells are processed in 3^3
+ * phase groups: two cells of the same group are at least 2*radius apart, hence
+ * all cells in a group can be processed in parallel without conflicts. See:
+ *
+ * Parallel Poisson Disk Sampling
+ * Li-Yi Wei
+ * ACM SIGGRAPH, 2008
+ *
+ * The output is a maximal sampling of the candidate set: each candidate is
+ * either accepted or closer than radius to some accepted sample.
+*/
+
+CINO_INLINE
+void Poisson_sampling(const double               radius,
+                      const std::vector<vec3d> & candidates,
+                            std::vector<vec3d> & samples,
+                            uint                 seed=0);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Poisson disk sampling of a surface mesh. Candidates are generated uniformly
+ * (i.e. with density proportional to the area of each polygon), and max_attempts
+ * candidates are thrown for each expected sample. Distances are Euclidean.
+*/
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void Poisson_sampling(const AbstractPolygonMesh<M,V,E,P> & m,
+                      const double                         radius,
+                            std::vector<vec3d>           & samples,
+                            uint                           seed=0,
+                      const int                            max_attempts=30);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Poisson disk sampling of the volume of a tetmesh. Candidates are generated
+ * uniformly (i.e. with density proportional to the volume of each tet), and
+ * max_attempts candidates are thrown for each expected sample.
+*/
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void Poisson_sampling(const Tetmesh<M,V,E,F,P> & m,
+                      const double               radius,
+                            std::vector<vec3d> & samples,
+                            uint                 seed=0,
+                      const int                  max_attempts=30);
 }
 
 #ifndef  CINO_STATIC_LIB
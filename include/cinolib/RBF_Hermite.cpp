@@ -34,6 +34,8 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/RBF_Hermite.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/sampling.h>
 
 namespace cinolib
 {
@@ -108,12 +110,28 @@ CINO_INLINE
 ScalarField Hermite_RBF<RBF>::eval(const std::vector<vec3d> & plist) const
 {
     ScalarField f(plist.size());
-    for(uint i=0; i<plist.size(); ++i) f[i] = eval(plist.at(i));
+    PARALLEL_FOR(0, plist.size(), 100, [&](uint i)
+    {
+        f[i] = eval(plist.at(i));
+    });
     return f;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class RBF>
+CINO_INLINE
+ScalarField Hermite_RBF<RBF>::eval_grid(const vec3d & min,
+                                        const vec3d & max,
+                                        const uint    nx,
+                                        const uint    ny,
+                                        const uint    nz) const
+{
+    return eval(sample_within_box(min, max, nx, ny, nz));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class RBF>
 CINO_INLINE
 double Hermite_RBF<RBF>::eval(const vec3d & p) const
@@ -60,6 +60,10 @@ namespace cinolib
  *     A Closed-Form Formulation of HRBF-Based Surface Reconstruction
  *     S. Liu, C.C.L. Wang, G. Brunnett, J. Wang
  *     Computer-Aided Design (2016)
+ *
+ * NOTE: fitting solves a dense (4n x 4n) system, which costs O(n^3) time and O(n^2)
+ * memory. For more than a few thousands points use Hermite_RBF_PU (RBF_Hermite_PU.h),
+ * which blends many small local fits.
 */
 
 template<class RBF>
@@ -73,10 +77,18 @@ class Hermite_RBF
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        ScalarField eval     (const std::vector<vec3d> & plist) const; // evaluate RBF at points plist
+        ScalarField eval     (const std::vector<vec3d> & plist) const; // evaluate RBF at points plist (in parallel)
         double      eval     (const vec3d & p) const;                  // evaluate RBF at point p
         vec3d       eval_grad(const vec3d & p) const;                  // evaluate nabla RBF at point p
 
+        // evaluate RBF at the nodes of a regular grid spanning the box [min,max]
+        // (see sample_within_box in sampling.h for the ordering of the nodes)
+        ScalarField eval_grid(const vec3d & min,
+                              const vec3d & max,
+                              const uint    nx,
+                              const uint    ny,
+                              const uint    nz) const;
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         Eigen::VectorXd  alpha;  // vector of scalar values alpha
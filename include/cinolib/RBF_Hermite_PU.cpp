@@ -0,0 +1,260 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/RBF_Hermite_PU.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/sampling.h>
+#include <algorithm>
+#include <cmath>
+
+namespace cinolib
+{
+
+// Wendland blending function, for t in [0,1]
+CINO_INLINE
+double wendland(const double t)
+{
+    return std::pow(1.0-t,4)*(4.0*t+1.0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// derivative of the Wendland blending function
+CINO_INLINE
+double wendland_dt(const double t)
+{
+    return -20.0*t*std::pow(1.0-t,3);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+CINO_INLINE
+Hermite_RBF_PU<RBF>::Hermite_RBF_PU(const std::vector<vec3d> & points,
+                                    const std::vector<vec3d> & normals,
+                                    const uint                 points_per_cell,
+                                    const double               overlap)
+{
+    assert(points.size()==normals.size());
+    assert(points_per_cell>0);
+    assert(overlap>=1.0);
+
+    if(points.empty()) return;
+
+    std::vector<uint> ids(points.size());
+    for(uint i=0; i<ids.size(); ++i) ids[i] = i;
+    make_cells(points, ids, 0, ids.size(), points_per_cell, overlap);
+
+    KdTree points_tree;
+    points_tree.build(points);
+
+    uint max_points = 8*points_per_cell;
+    cell_rbf.resize(cell_center.size());
+    PARALLEL_FOR(0, cell_center.size(), 8, [&](uint cid)
+    {
+        // cells spanning sparse and dense regions may catch way too many points:
+        // keep only the closest ones and shrink the cell accordingly
+        std::vector<uint> in_cell;
+        points_tree.radius_search(cell_center.at(cid), cell_radius.at(cid), in_cell);
+        if(in_cell.size() > max_points)
+        {
+            points_tree.k_nearest(cell_center.at(cid), max_points, in_cell);
+            cell_radius.at(cid) = cell_center.at(cid).dist(points.at(in_cell.back()));
+        }
+        std::sort(in_cell.begin(), in_cell.end()); // make the local system independent from the tree layout
+
+        std::vector<vec3d> p, n;
+        p.reserve(in_cell.size());
+        n.reserve(in_cell.size());
+        for(uint id : in_cell)
+        {
+            // coincident points would make the local system singular: keep only the first one
+            bool duplicate = false;
+            for(const vec3d & q : p) if(q==points.at(id)) { duplicate = true; break; }
+            if(duplicate) continue;
+
+            p.push_back(points.at(id));
+            n.push_back(normals.at(id));
+        }
+        cell_rbf.at(cid) = Hermite_RBF<RBF>(p, n);
+    });
+
+    max_radius = *std::max_element(cell_radius.begin(), cell_radius.end());
+    cell_tree.build(cell_center);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+CINO_INLINE
+void Hermite_RBF_PU<RBF>::make_cells(const std::vector<vec3d> & points,
+                                           std::vector<uint>  & ids,
+                                     const uint                 beg,
+                                     const uint                 end,
+                                     const uint                 points_per_cell,
+                                     const double               overlap)
+{
+    vec3d min = points.at(ids.at(beg));
+    vec3d max = min;
+    for(uint i=beg+1; i<end; ++i)
+    {
+        min = min.min(points.at(ids.at(i)));
+        max = max.max(points.at(ids.at(i)));
+    }
+
+    if(end-beg <= points_per_cell)
+    {
+        cell_center.push_back((min+max)*0.5);
+        cell_radius.push_back(overlap * 0.5 * max.dist(min));
+        return;
+    }
+
+    vec3d delta = max - min;
+    int   axis  = 0;
+    if(delta[1] > delta[axis]) axis = 1;
+    if(delta[2] > delta[axis]) axis = 2;
+
+    uint mid = beg + (end-beg)/2;
+    std::nth_element(ids.begin()+beg, ids.begin()+mid, ids.begin()+end, [&](const uint a, const uint b)
+    {
+        return points.at(a)[axis] < points.at(b)[axis];
+    });
+
+    make_cells(points, ids, beg, mid, points_per_cell, overlap);
+    make_cells(points, ids, mid, end, points_per_cell, overlap);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+CINO_INLINE
+void Hermite_RBF_PU<RBF>::cells_around(const vec3d & p, std::vector<uint> & cells) const
+{
+    std::vector<uint> candidates;
+    cell_tree.radius_search(p, max_radius, candidates);
+
+    cells.clear();
+    for(uint cid : candidates)
+    {
+        if(p.dist(cell_center.at(cid)) < cell_radius.at(cid)) cells.push_back(cid);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+CINO_INLINE
+ScalarField Hermite_RBF_PU<RBF>::eval(const std::vector<vec3d> & plist) const
+{
+    ScalarField f(plist.size());
+    PARALLEL_FOR(0, plist.size(), 100, [&](uint i)
+    {
+        f[i] = eval(plist.at(i));
+    });
+    return f;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+CINO_INLINE
+ScalarField Hermite_RBF_PU<RBF>::eval_grid(const vec3d & min,
+                                           const vec3d & max,
+                                           const uint    nx,
+                                           const uint    ny,
+                                           const uint    nz) const
+{
+    return eval(sample_within_box(min, max, nx, ny, nz));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+CINO_INLINE
+double Hermite_RBF_PU<RBF>::eval(const vec3d & p) const
+{
+    assert(!cell_rbf.empty());
+
+    std::vector<uint> cells;
+    cells_around(p, cells);
+
+    if(cells.empty()) return cell_rbf.at(cell_tree.nearest(p)).eval(p);
+
+    double val  = 0;
+    double wsum = 0;
+    for(uint cid : cells)
+    {
+        double w = wendland(p.dist(cell_center.at(cid))/cell_radius.at(cid));
+        val  += w * cell_rbf.at(cid).eval(p);
+        wsum += w;
+    }
+    return val/wsum;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+CINO_INLINE
+vec3d Hermite_RBF_PU<RBF>::eval_grad(const vec3d & p) const
+{
+    assert(!cell_rbf.empty());
+
+    std::vector<uint> cells;
+    cells_around(p, cells);
+
+    if(cells.empty()) return cell_rbf.at(cell_tree.nearest(p)).eval_grad(p);
+
+    // f = F/W, with F = sum_i w_i f_i and W = sum_i w_i
+    // grad f = (grad F - f grad W)/W
+    double F = 0, W = 0;
+    vec3d  grad_F(0,0,0), grad_W(0,0,0);
+    for(uint cid : cells)
+    {
+        vec3d  d   = p - cell_center.at(cid);
+        double len = d.length();
+        double r   = cell_radius.at(cid);
+        double w   = wendland(len/r);
+        vec3d  gw  = (len>0) ? d * (wendland_dt(len/r)/(r*len)) : vec3d(0,0,0);
+        double fi  = cell_rbf.at(cid).eval(p);
+
+        F      += w * fi;
+        W      += w;
+        grad_F += cell_rbf.at(cid).eval_grad(p) * w + gw * fi;
+        grad_W += gw;
+    }
+    return (grad_F - grad_W * (F/W)) / W;
+}
+
+}
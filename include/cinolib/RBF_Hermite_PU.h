@@ -0,0 +1,129 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_RBF_HERMITE_PU_H
+#define CINO_RBF_HERMITE_PU_H
+
+#include <cinolib/RBF_Hermite.h>
+#include <cinolib/kd_tree.h>
+
+namespace cinolib
+{
+
+/* Partition of unity Hermite RBF interpolation, for large sets of oriented points.
+ *
+ * The bounding volume of the input points is recursively split along the median
+ * of its largest axis, until each leaf contains at most points_per_cell points.
+ * Each leaf becomes a spherical cell, centered at the center of the leaf bbox and
+ * with a radius equal to the half diagonal of the leaf bbox, enlarged by the overlap
+ * factor. A small Hermite_RBF is fitted on the points falling inside each cell (cells
+ * are fitted in parallel), and the global interpolant is the blend of the local ones
+ *
+ *     f(x) = sum_i w_i(x) f_i(x) / sum_i w_i(x)
+ *
+ * where w_i is the Wendland function (1-t)^4(4t+1), with t = |x-c_i|/r_i, which
+ * vanishes outside of cell i. Cells containing more than 8*points_per_cell points
+ * (e.g. leaves spanning both sparse and dense regions) are shrunk to the ball of
+ * the closest 8*points_per_cell points, so that local systems remain small.
+ * Coincident points (e.g. vertices duplicated along texture seams) are fitted
+ * only once, using the normal of the one that comes first in the input list.
+ *
+ * Fitting costs O(n) local solves of bounded size, and evaluating f at a point only
+ * involves the few cells containing it (retrieved with a kd-tree). Points not covered
+ * by any cell are evaluated with the local interpolant of the closest cell.
+ *
+ * Reference:
+ *
+ *     Multi-level Partition of Unity Implicits
+ *     Y. Ohtake, A. Belyaev, M. Alexa, G. Turk, H.P. Seidel
+ *     ACM Transactions on Graphics (2003)
+*/
+
+template<class RBF>
+class Hermite_RBF_PU
+{
+    public:
+
+        Hermite_RBF_PU(){}
+        Hermite_RBF_PU(const std::vector<vec3d> & points,
+                       const std::vector<vec3d> & normals,
+                       const uint                 points_per_cell = 16,
+                       const double               overlap         = 1.5);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        ScalarField eval     (const std::vector<vec3d> & plist) const; // evaluate RBF at points plist (in parallel)
+        double      eval     (const vec3d & p) const;                  // evaluate RBF at point p
+        vec3d       eval_grad(const vec3d & p) const;                  // evaluate nabla RBF at point p
+
+        // evaluate RBF at the nodes of a regular grid spanning the box [min,max]
+        // (see sample_within_box in sampling.h for the ordering of the nodes)
+        ScalarField eval_grid(const vec3d & min,
+                              const vec3d & max,
+                              const uint    nx,
+                              const uint    ny,
+                              const uint    nz) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint num_cells() const { return cell_center.size(); }
+
+    protected:
+
+        void make_cells(const std::vector<vec3d> & points,
+                              std::vector<uint>  & ids,
+                        const uint                 beg,
+                        const uint                 end,
+                        const uint                 points_per_cell,
+                        const double               overlap);
+
+        void cells_around(const vec3d & p, std::vector<uint> & cells) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        std::vector<vec3d>            cell_center;
+        std::vector<double>           cell_radius;
+        std::vector<Hermite_RBF<RBF>> cell_rbf;        // local interpolant of each cell
+        KdTree                        cell_tree;       // spatial index of the cell centers
+        double                        max_radius = 0;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "RBF_Hermite_PU.cpp"
+#endif
+
+#endif // CINO_RBF_HERMITE_PU_H
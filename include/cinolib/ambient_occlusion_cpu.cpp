@@ -0,0 +1,223 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/ambient_occlusion_cpu.h>
+#include <cinolib/parallel_for.h>
+#include <random>
+#include <cmath>
+
+namespace cinolib
+{
+
+template<class Mesh>
+CINO_INLINE
+AO_srf_cpu<Mesh>::AO_srf_cpu(const Mesh   & m,
+                             const uint     n_rays,
+                             const double   max_dist,
+                             const bool     per_vertex,
+                             const uint     seed) : per_vertex(per_vertex)
+{
+    // occluders: tessellation of all visible polys
+    BVH bvh;
+    std::vector<vec3d> tri_verts;
+    std::vector<uint>  tri_ids;
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        if(m.poly_data(pid).flags[HIDDEN]) continue;
+        for(uint vid : m.poly_tessellation(pid)) tri_verts.push_back(m.vert(vid));
+        for(uint i=0; i<m.poly_tessellation(pid).size()/3; ++i) tri_ids.push_back(pid);
+    }
+    bvh.build(tri_verts, tri_ids);
+
+    // samples: either poly centroids (skipping the poly itself) or vertices.
+    // Samples of hidden elements are not traced (their AO is set to 1)
+    std::vector<vec3d> p, n;
+    std::vector<int>   skip;
+    if(per_vertex)
+    {
+        for(uint vid=0; vid<m.num_verts(); ++vid)
+        {
+            bool hidden = true;
+            for(uint pid : m.adj_v2p(vid)) if(!m.poly_data(pid).flags[HIDDEN]) hidden = false;
+            p.push_back(m.vert(vid));
+            n.push_back(hidden ? vec3d(0,0,0) : m.vert_data(vid).normal);
+            skip.push_back(-1);
+        }
+    }
+    else
+    {
+        for(uint pid=0; pid<m.num_polys(); ++pid)
+        {
+            bool hidden = m.poly_data(pid).flags[HIDDEN];
+            p.push_back(m.poly_centroid(pid));
+            n.push_back(hidden ? vec3d(0,0,0) : m.poly_data(pid).normal);
+            skip.push_back(pid);
+        }
+    }
+
+    AO_trace(bvh, p, n, skip, n_rays, max_dist, 1e-6*m.bbox().diag(), seed, ao);
+    for(const vec3d & v : n) if(v.length_squared()>0) n_rays_tot += n_rays;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AO_srf_cpu<Mesh>::copy_to_mesh(Mesh & m)
+{
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        if(m.poly_data(pid).flags[HIDDEN])
+        {
+            m.poly_data(pid).AO = 1.0;
+        }
+        else if(per_vertex)
+        {
+            double avg = 0;
+            for(uint vid : m.adj_p2v(pid)) avg += ao[vid];
+            m.poly_data(pid).AO = avg/static_cast<double>(m.verts_per_poly(pid));
+        }
+        else
+        {
+            m.poly_data(pid).AO = ao[pid];
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+AO_vol_cpu<Mesh>::AO_vol_cpu(const Mesh   & m,
+                             const uint     n_rays,
+                             const double   max_dist,
+                             const uint     seed)
+{
+    // occluders and samples: the visible faces
+    BVH bvh;
+    std::vector<vec3d> tri_verts;
+    std::vector<uint>  tri_ids;
+    std::vector<vec3d> p, n;
+    std::vector<int>   skip;
+    visible.resize(m.num_faces(), false);
+    for(uint fid=0; fid<m.num_faces(); ++fid)
+    {
+        uint pid_beneath;
+        if(m.face_is_visible(fid, pid_beneath))
+        {
+            visible.at(fid) = true;
+            for(uint vid : m.face_tessellation(fid)) tri_verts.push_back(m.vert(vid));
+            for(uint i=0; i<m.face_tessellation(fid).size()/3; ++i) tri_ids.push_back(fid);
+            n.push_back(m.poly_face_normal(pid_beneath, fid));
+        }
+        else n.push_back(vec3d(0,0,0));
+        p.push_back(m.face_centroid(fid));
+        skip.push_back(fid);
+    }
+    bvh.build(tri_verts, tri_ids);
+
+    AO_trace(bvh, p, n, skip, n_rays, max_dist, 1e-6*m.bbox().diag(), seed, ao);
+    for(const vec3d & v : n) if(v.length_squared()>0) n_rays_tot += n_rays;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AO_vol_cpu<Mesh>::copy_to_mesh(Mesh & m)
+{
+    for(uint fid=0; fid<m.num_faces(); ++fid)
+    {
+        m.face_data(fid).AO = (visible.at(fid)) ? ao[fid] : 1.0;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void AO_trace(const BVH                & bvh,
+              const std::vector<vec3d> & p,
+              const std::vector<vec3d> & n,
+              const std::vector<int>   & skip,
+              const uint                 n_rays,
+              const double               max_dist,
+              const double               offset,
+              const uint                 seed,
+                    ScalarField        & ao)
+{
+    assert(p.size()==n.size() && p.size()==skip.size());
+    assert(n_rays>0);
+
+    ao = ScalarField(p.size());
+    PARALLEL_FOR(0, p.size(), 64, [&](uint i)
+    {
+        // samples with null normal are not traced
+        if(n.at(i).length_squared()==0)
+        {
+            ao[i] = 1.0;
+            return;
+        }
+
+        // local frame (u,v,w), with w aligned with the surface normal
+        vec3d w = n.at(i);
+        w.normalize();
+        vec3d u = (std::fabs(w.x())>0.9) ? vec3d(0,1,0) : vec3d(1,0,0);
+        u = u.cross(w); u.normalize();
+        vec3d v = w.cross(u);
+
+        vec3d o = p.at(i) + w*offset;
+        int   s = skip.at(i);
+
+        std::mt19937 rng(seed ^ (i*2654435761u));
+        std::uniform_real_distribution<double> U(0.0,1.0);
+
+        uint n_hits = 0;
+        for(uint r=0; r<n_rays; ++r)
+        {
+            // cosine weighted direction (Malley's method: uniform disk sample, lifted to the hemisphere)
+            double rad = std::sqrt(U(rng));
+            double phi = 2.0*M_PI*U(rng);
+            double x   = rad*std::cos(phi);
+            double y   = rad*std::sin(phi);
+            double z   = std::sqrt(std::max(0.0, 1.0-x*x-y*y));
+            vec3d  dir = u*x + v*y + w*z;
+
+            if(bvh.any_hit(o, dir, max_dist, [s](const uint id){ return (int)id==s; })) ++n_hits;
+        }
+        ao[i] = 1.0 - static_cast<double>(n_hits)/static_cast<double>(n_rays);
+    });
+}
+
+}
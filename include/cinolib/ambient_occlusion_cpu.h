@@ -0,0 +1,123 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_AMBIENT_OCCLUSION_CPU_H
+#define CINO_AMBIENT_OCCLUSION_CPU_H
+
+#include <cinolib/scalar_field.h>
+#include <cinolib/bvh.h>
+
+namespace cinolib
+{
+
+/* CPU counterparts of AO_srf and AO_vol (ambient_occlusion.h), which do not need
+ * an OpenGL context (e.g. to run on headless machines). For each sample point, rays
+ * are cast in the hemisphere above the surface (with cosine weighted distribution)
+ * and tested against a BVH of the mesh. The AO value of a sample is the fraction of
+ * rays that travel at least max_dist without hitting the mesh, hence it is in [0,1]
+ * with 1 meaning fully unoccluded.
+ *
+ * Samples are processed in parallel. Each sample owns its random number generator,
+ * seeded with the sample id, so the output does not depend on how samples are split
+ * across threads. AO_srf_cpu samples poly centroids (default) or vertices, in which
+ * case copy_to_mesh assigns to each poly the average of its vertices. AO_vol_cpu
+ * samples the centroids of the visible faces.
+*/
+
+template<class Mesh>
+class AO_srf_cpu
+{
+    ScalarField ao;
+    bool        per_vertex;
+    size_t      n_rays_tot = 0;
+
+    public:
+
+        AO_srf_cpu(const Mesh   & m,
+                   const uint     n_rays     = 256,
+                   const double   max_dist   = inf_double,
+                   const bool     per_vertex = false,
+                   const uint     seed       = 0);
+
+        void copy_to_mesh(Mesh & m);
+
+        const ScalarField & values()   const { return ao;         } // one value per poly (or per vertex)
+              size_t        num_rays() const { return n_rays_tot; } // total number of traced rays
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+class AO_vol_cpu
+{
+    ScalarField       ao;
+    std::vector<bool> visible;
+    size_t            n_rays_tot = 0;
+
+    public:
+
+        AO_vol_cpu(const Mesh   & m,
+                   const uint     n_rays   = 256,
+                   const double   max_dist = inf_double,
+                   const uint     seed     = 0);
+
+        void copy_to_mesh(Mesh & m);
+
+        const ScalarField & values()   const { return ao;         } // one value per face
+              size_t        num_rays() const { return n_rays_tot; } // total number of traced rays
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// traces n_rays occlusion rays from each point p[i], in the hemisphere centered
+// at n[i]. Triangles with the same id as skip[i] are ignored (use -1 to ignore none)
+CINO_INLINE
+void AO_trace(const BVH                & bvh,
+              const std::vector<vec3d> & p,
+              const std::vector<vec3d> & n,
+              const std::vector<int>   & skip,
+              const uint                 n_rays,
+              const double               max_dist,
+              const double               offset,
+              const uint                 seed,
+                    ScalarField        & ao);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "ambient_occlusion_cpu.cpp"
+#endif
+
+#endif // CINO_AMBIENT_OCCLUSION_CPU_H
@@ -0,0 +1,291 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/bvh.h>
+#include <cinolib/Moller_Trumbore_intersection.h>
+#include <algorithm>
+
+namespace cinolib
+{
+
+CINO_INLINE
+void BVH::build(const std::vector<vec3d> & tri_verts, const std::vector<uint> & tri_ids)
+{
+    assert(tri_verts.size() == 3*tri_ids.size());
+    clear();
+    if(tri_ids.empty()) return;
+
+    std::vector<vec3d> centroids(tri_ids.size());
+    std::vector<uint>  tris(tri_ids.size());
+    for(uint i=0; i<tri_ids.size(); ++i)
+    {
+        centroids[i] = (tri_verts[3*i] + tri_verts[3*i+1] + tri_verts[3*i+2])/3.0;
+        tris[i]      = i;
+    }
+
+    nodes.reserve(2*tri_ids.size()/tris_per_leaf + 1);
+    build(tris, centroids, 0, tris.size());
+
+    // store triangles in tree order
+    verts.resize(3*tris.size());
+    ids.resize(tris.size());
+    eps.resize(tris.size());
+    for(uint i=0; i<tris.size(); ++i)
+    {
+        verts[3*i  ] = tri_verts[3*tris[i]  ];
+        verts[3*i+1] = tri_verts[3*tris[i]+1];
+        verts[3*i+2] = tri_verts[3*tris[i]+2];
+        ids[i]       = tri_ids[tris[i]];
+        // the Moller-Trumbore determinant is |dir|*|e0|*|e1| times a scale free factor,
+        // hence an absolute threshold would discard all the hits on small triangles
+        eps[i] = 1e-7 * (verts[3*i+1]-verts[3*i]).length() * (verts[3*i+2]-verts[3*i]).length();
+    }
+
+    // node bboxes (children come after their father, so a backward visit is bottom-up)
+    for(int nid=nodes.size()-1; nid>=0; --nid)
+    {
+        Node & n = nodes[nid];
+        if(n.left<0)
+        {
+            for(uint i=3*n.beg; i<3*n.end; ++i)
+            {
+                n.bbox.min = n.bbox.min.min(verts[i]);
+                n.bbox.max = n.bbox.max.max(verts[i]);
+            }
+        }
+        else
+        {
+            n.bbox = AABB(std::vector<AABB>{ nodes[n.left].bbox, nodes[n.right].bbox });
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint BVH::build(std::vector<uint> & tris, const std::vector<vec3d> & centroids, const uint beg, const uint end)
+{
+    uint nid = nodes.size();
+    nodes.push_back(Node());
+    nodes[nid].beg = beg;
+    nodes[nid].end = end;
+
+    if(end-beg <= tris_per_leaf) return nid;
+
+    // split at the median centroid along the axis of maximum extent
+    vec3d min( inf_double,  inf_double,  inf_double);
+    vec3d max(-inf_double, -inf_double, -inf_double);
+    for(uint i=beg; i<end; ++i)
+    {
+        min = min.min(centroids[tris[i]]);
+        max = max.max(centroids[tris[i]]);
+    }
+    vec3d delta = max - min;
+    int   a     = (delta.x()>=delta.y() && delta.x()>=delta.z()) ? 0 : ((delta.y()>=delta.z()) ? 1 : 2);
+    uint  mid   = beg + (end-beg)/2;
+    std::nth_element(tris.begin()+beg, tris.begin()+mid, tris.begin()+end, [&](const uint i, const uint j)
+    {
+        return centroids[i][a] < centroids[j][a];
+    });
+
+    int left  = build(tris, centroids, beg, mid);
+    int right = build(tris, centroids, mid, end);
+    nodes[nid].left  = left;
+    nodes[nid].right = right;
+    return nid;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BVH::clear()
+{
+    nodes.clear();
+    verts.clear();
+    ids.clear();
+    eps.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool BVH::intersects_ray(const vec3d & p, const vec3d & dir, double & t, uint & id) const
+{
+    return intersects_ray(p, dir, t, id, [](const uint){ return false; });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Skip>
+CINO_INLINE
+bool BVH::intersects_ray(const vec3d & p, const vec3d & dir, double & t, uint & id, const Skip & skip) const
+{
+    t = inf_double;
+    if(nodes.empty()) return false;
+
+    double dir_len = dir.length();
+
+    // depth first visit, closest child first. Nodes farther than the current hit are pruned
+    std::vector<std::pair<double,uint>> stack;
+    double t_box;
+    vec3d  pos;
+    if(!nodes[0].bbox.intersects_ray(p, dir, t_box, pos)) return false;
+    stack.push_back(std::make_pair(t_box,0));
+
+    while(!stack.empty())
+    {
+        std::pair<double,uint> top = stack.back();
+        stack.pop_back();
+        if(top.first > t) continue;
+
+        const Node & n = nodes[top.second];
+        if(n.left<0)
+        {
+            for(uint i=n.beg; i<n.end; ++i)
+            {
+                if(skip(ids[i])) continue;
+                bool   backside, coplanar;
+                double t_tri;
+                vec3d  bary;
+                if(Moller_Trumbore_intersection(p, dir, verts[3*i], verts[3*i+1], verts[3*i+2], backside, coplanar, t_tri, bary, eps[i]*dir_len) &&
+                   t_tri>=0 && (t_tri<t || (t_tri==t && ids[i]<id)))
+                {
+                    t  = t_tri;
+                    id = ids[i];
+                }
+            }
+        }
+        else
+        {
+            double t_left, t_right;
+            bool hit_left  = nodes[n.left ].bbox.intersects_ray(p, dir, t_left,  pos) && t_left  <= t;
+            bool hit_right = nodes[n.right].bbox.intersects_ray(p, dir, t_right, pos) && t_right <= t;
+            // push the farthest first, so that the closest is visited first
+            if(hit_left && hit_right && t_left<t_right)
+            {
+                stack.push_back(std::make_pair(t_right, n.right));
+                stack.push_back(std::make_pair(t_left,  n.left));
+            }
+            else
+            {
+                if(hit_left)  stack.push_back(std::make_pair(t_left,  n.left));
+                if(hit_right) stack.push_back(std::make_pair(t_right, n.right));
+            }
+        }
+    }
+    return t<inf_double;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool BVH::any_hit(const vec3d & p, const vec3d & dir, const double max_t) const
+{
+    return any_hit(p, dir, max_t, [](const uint){ return false; });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// slab test between a ray p + t*dir (with inv_dir = 1/dir) and a box, for t in [0,max_t].
+// Divisions are precomputed once per ray, as this is the innermost test of any traversal
+CINO_INLINE
+bool ray_hits_box(const AABB & box, const vec3d & p, const vec3d & inv_dir, const double max_t)
+{
+    double t_min = 0.0;
+    double t_max = max_t;
+    for(int i=0; i<3; ++i)
+    {
+        double t0 = (box.min[i] - p[i]) * inv_dir[i];
+        double t1 = (box.max[i] - p[i]) * inv_dir[i];
+        if(t0>t1) std::swap(t0,t1);
+        t_min = std::max(t_min, t0);
+        t_max = std::min(t_max, t1);
+        if(t_min>t_max) return false;
+    }
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Skip>
+CINO_INLINE
+bool BVH::any_hit(const vec3d & p, const vec3d & dir, const double max_t, const Skip & skip) const
+{
+    if(nodes.empty()) return false;
+
+    double dir_len = dir.length();
+
+    // null components of dir yield infinite inverses, which the slab test handles
+    // correctly, unless the origin lies exactly on a slab (0*inf = nan). Nudge them
+    vec3d inv_dir;
+    for(int i=0; i<3; ++i) inv_dir[i] = 1.0/((dir[i]==0) ? 1e-300 : dir[i]);
+
+    // depth first visit. Nodes farther than max_t are pruned. The tree is balanced,
+    // hence its depth is logarithmic in the number of triangles and a small fixed
+    // size stack suffices (no allocations, as this is typically called a lot)
+    uint stack[64];
+    uint size = 0;
+    if(!ray_hits_box(nodes[0].bbox, p, inv_dir, max_t)) return false;
+    stack[size++] = 0;
+
+    while(size>0)
+    {
+        const Node & n = nodes[stack[--size]];
+        if(n.left<0)
+        {
+            for(uint i=n.beg; i<n.end; ++i)
+            {
+                if(skip(ids[i])) continue;
+                bool   backside, coplanar;
+                double t_tri;
+                vec3d  bary;
+                if(Moller_Trumbore_intersection(p, dir, verts[3*i], verts[3*i+1], verts[3*i+2], backside, coplanar, t_tri, bary, eps[i]*dir_len) &&
+                   t_tri>=0 && t_tri<=max_t)
+                {
+                    return true;
+                }
+            }
+        }
+        else
+        {
+            if(ray_hits_box(nodes[n.right].bbox, p, inv_dir, max_t)) stack[size++] = n.right;
+            if(ray_hits_box(nodes[n.left ].bbox, p, inv_dir, max_t)) stack[size++] = n.left;
+            assert(size<=64);
+        }
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,116 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_BVH_H
+#define CINO_BVH_H
+
+#include <vector>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/aabb.h>
+
+namespace cinolib
+{
+
+/* Bounding Volume Hierarchy for ray queries on a set of triangles.
+ * Triangles are recursively split at the median of their centroids
+ * along the axis of maximum extent, yielding a balanced binary tree
+ * of AABBs. Nodes live in a flat array, and triangles are stored
+ * in tree order, so that each leaf references a contiguous range.
+ *
+ * Usage:
+ *
+ *  i)  Build the tree from a list of triangles (3 verts each), and a list of ids, one
+ *      per triangle (e.g. the id of the mesh element the triangle belongs to)
+ *  ii) Query intersects_ray to find the first triangle hit by a ray, or any_hit
+ *      to know whether a ray hits something within a given distance
+*/
+
+class BVH
+{
+    public:
+
+        explicit BVH(const uint tris_per_leaf = 4) : tris_per_leaf(tris_per_leaf) {}
+
+        void build(const std::vector<vec3d> & tri_verts, const std::vector<uint> & tri_ids);
+        void clear();
+
+        bool empty() const { return ids.empty(); }
+        uint size()  const { return ids.size();  }
+
+        // QUERIES :::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // first hit between the triangles and the ray R(t) := p + t * dir, with t>=0
+        bool intersects_ray(const vec3d & p, const vec3d & dir, double & t, uint & id) const;
+
+        // same as above, but triangles for which skip(id) returns true are ignored
+        template<class Skip>
+        bool intersects_ray(const vec3d & p, const vec3d & dir, double & t, uint & id, const Skip & skip) const;
+
+        // true if the ray R(t) := p + t * dir hits any triangle for 0 <= t <= max_t.
+        // Cheaper than intersects_ray, as the visit stops at the first hit found
+        // (e.g. for shadow and occlusion rays, where the closest hit is not needed)
+        bool any_hit(const vec3d & p, const vec3d & dir, const double max_t) const;
+
+        // same as above, but triangles for which skip(id) returns true are ignored
+        template<class Skip>
+        bool any_hit(const vec3d & p, const vec3d & dir, const double max_t, const Skip & skip) const;
+
+    protected:
+
+        uint build(std::vector<uint> & tris, const std::vector<vec3d> & centroids, const uint beg, const uint end);
+
+        struct Node
+        {
+            AABB bbox;
+            uint beg, end;      // range of triangles (leaves only)
+            int  left  = -1;    // children (inner nodes only)
+            int  right = -1;
+        };
+
+        std::vector<Node>   nodes; // root is nodes[0]
+        std::vector<vec3d>  verts; // 3 verts per triangle, in tree order
+        std::vector<uint>   ids;   // triangle ids, in tree order
+        std::vector<double> eps;   // coplanarity threshold of each triangle, in tree order (see build)
+        uint tris_per_leaf;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "bvh.cpp"
+#endif
+
+#endif // CINO_BVH_H
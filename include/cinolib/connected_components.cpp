@@ -34,7 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/connected_components.h>
-#include <cinolib/bfs.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
@@ -43,8 +43,9 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint connected_components(const AbstractMesh<M,V,E,P> & m)
 {
-    std::vector<std::unordered_set<uint>> ccs;
-    return connected_components(m, ccs);
+    std::vector<int>  label;
+    std::vector<uint> cc_size;
+    return connected_components(m, label, cc_size);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -54,24 +55,116 @@ CINO_INLINE
 uint connected_components(const AbstractMesh<M,V,E,P> & m,
                           std::vector<std::unordered_set<uint>> & ccs)
 {
+    std::vector<int>  label;
+    std::vector<uint> cc_size;
+    uint n_ccs = connected_components(m, label, cc_size);
+
     ccs.clear();
-    uint seed = 0;
-    std::vector<bool> visited(m.num_verts(), false);
+    ccs.resize(n_ccs);
+    for(uint i=0; i<n_ccs; ++i) ccs.at(i).reserve(cc_size.at(i));
+    for(uint vid=0; vid<m.num_verts(); ++vid) ccs.at(label.at(vid)).insert(vid);
+
+    return n_ccs;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    do
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components(const AbstractMesh<M,V,E,P> & m,
+                          std::vector<int>            & label,
+                          std::vector<uint>           & cc_size,
+                          const std::vector<bool>     & v_mask,
+                          const std::vector<bool>     & e_mask)
+{
+    assert(v_mask.empty() || v_mask.size()==m.num_verts());
+    assert(e_mask.empty() || e_mask.size()==m.num_edges());
+    m.adjacency_require(ADJ_EDGES); // before going parallel (see set_soup)
+
+    std::vector<std::atomic<uint>> parent(m.num_verts());
+    PARALLEL_FOR(0, m.num_verts(), 10000, [&](const uint vid)
+    {
+        parent[vid].store(vid);
+    });
+
+    PARALLEL_FOR(0, m.num_edges(), 10000, [&](const uint eid)
     {
-        std::unordered_set<uint> cc;
-        bfs(m, seed, cc);
+        if(!e_mask.empty() && e_mask[eid]) return;
+        uint v0 = m.edge_vert_id(eid,0);
+        uint v1 = m.edge_vert_id(eid,1);
+        if(!v_mask.empty() && (v_mask[v0] || v_mask[v1])) return;
+        union_find_merge(parent, v0, v1);
+    });
+
+    return union_find_labels(parent, v_mask, label, cc_size);
+}
 
-        ccs.push_back(cc);
-        for(uint vid : cc) visited.at(vid) = true;
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        seed = 0;
-        while (seed < num_verts() && visited.at(seed)) ++seed;
-    }
-    while (seed < m.num_verts());
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components_on_dual(const AbstractPolygonMesh<M,V,E,P> & m,
+                                  std::vector<int>                   & label,
+                                  std::vector<uint>                  & cc_size,
+                                  const std::vector<bool>            & p_mask,
+                                  const std::vector<bool>            & e_mask)
+{
+    assert(p_mask.empty() || p_mask.size()==m.num_polys());
+    assert(e_mask.empty() || e_mask.size()==m.num_edges());
+    m.adjacency_require(ADJ_EDGES);
+
+    std::vector<std::atomic<uint>> parent(m.num_polys());
+    PARALLEL_FOR(0, m.num_polys(), 10000, [&](const uint pid)
+    {
+        parent[pid].store(pid);
+    });
+
+    PARALLEL_FOR(0, m.num_edges(), 10000, [&](const uint eid)
+    {
+        if(!e_mask.empty() && e_mask[eid]) return;
+        int prev = -1; // non manifold edges may have more than two incident polygons
+        for(uint pid : m.adj_e2p(eid))
+        {
+            if(!p_mask.empty() && p_mask[pid]) continue;
+            if(prev>=0) union_find_merge(parent, prev, pid);
+            prev = pid;
+        }
+    });
+
+    return union_find_labels(parent, p_mask, label, cc_size);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+uint connected_components_on_dual(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                                  std::vector<int>                        & label,
+                                  std::vector<uint>                       & cc_size,
+                                  const std::vector<bool>                 & p_mask,
+                                  const std::vector<bool>                 & f_mask)
+{
+    assert(p_mask.empty() || p_mask.size()==m.num_polys());
+    assert(f_mask.empty() || f_mask.size()==m.num_faces());
+    m.adjacency_require(ADJ_FACES);
+
+    std::vector<std::atomic<uint>> parent(m.num_polys());
+    PARALLEL_FOR(0, m.num_polys(), 10000, [&](const uint pid)
+    {
+        parent[pid].store(pid);
+    });
+
+    PARALLEL_FOR(0, m.num_faces(), 10000, [&](const uint fid)
+    {
+        if(!f_mask.empty() && f_mask[fid]) return;
+        if(m.adj_f2p(fid).size()<2) return;
+        uint p0 = m.adj_f2p(fid).front();
+        uint p1 = m.adj_f2p(fid).back();
+        if(!p_mask.empty() && (p_mask[p0] || p_mask[p1])) return;
+        union_find_merge(parent, p0, p1);
+    });
 
-    return ccs.size();
+    return union_find_labels(parent, p_mask, label, cc_size);
 }
 
 }
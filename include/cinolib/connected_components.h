@@ -37,9 +37,13 @@
 #define CINO_CONNECTED_COMPONENTS_H
 
 #include <vector>
+#include <unordered_set>
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
+#include <cinolib/union_find.h>
 #include <cinolib/meshes/abstract_mesh.h>
+#include <cinolib/meshes/abstract_polygonmesh.h>
+#include <cinolib/meshes/abstract_polyhedralmesh.h>
 
 namespace cinolib
 {
@@ -55,6 +59,52 @@ CINO_INLINE
 uint connected_components(const AbstractMesh<M,V,E,P> & m,
                           std::vector<std::unordered_set<uint>> & ccs);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Compact connected components: label[vid] is the component of vertex vid,
+ * and cc_size[i] the number of vertices in the i-th component. Components
+ * are computed with a concurrent union-find that processes edges in parallel,
+ * and are sorted by their smallest vertex id.
+ *
+ *     v_mask : if v_mask[vid] = true, vertex vid is ignored (label[vid] = -1)
+ *     e_mask : if e_mask[eid] = true, vertices are not connected through eid
+ *
+ * Empty masks mean that nothing is masked. Returns the number of components.
+*/
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components(const AbstractMesh<M,V,E,P> & m,
+                          std::vector<int>            & label,
+                          std::vector<uint>           & cc_size,
+                          const std::vector<bool>     & v_mask = std::vector<bool>(),
+                          const std::vector<bool>     & e_mask = std::vector<bool>());
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// same as above, but on the dual graph of a surface mesh (polygons are connected
+// through their shared edges, unless e_mask[eid] = true)
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components_on_dual(const AbstractPolygonMesh<M,V,E,P> & m,
+                                  std::vector<int>                   & label,
+                                  std::vector<uint>                  & cc_size,
+                                  const std::vector<bool>            & p_mask = std::vector<bool>(),
+                                  const std::vector<bool>            & e_mask = std::vector<bool>());
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// same as above, but on the dual graph of a volume mesh (polyhedra are connected
+// through their shared faces, unless f_mask[fid] = true)
+//
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+uint connected_components_on_dual(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                                  std::vector<int>                        & label,
+                                  std::vector<uint>                       & cc_size,
+                                  const std::vector<bool>                 & p_mask = std::vector<bool>(),
+                                  const std::vector<bool>                 & f_mask = std::vector<bool>());
 }
 
 #ifndef  CINO_STATIC_LIB
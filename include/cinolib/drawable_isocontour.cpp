@@ -66,6 +66,17 @@ DrawableIsocontour<M,V,E,P>::DrawableIsocontour(AbstractPolygonMesh<M,V,E,P> & m
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+DrawableIsocontour<M,V,E,P>::DrawableIsocontour(AbstractPolygonMesh<M,V,E,P> & m, const std::vector<float> & iso_values)
+: Isocontour<M,V,E,P>(m, iso_values)
+{
+    color     = Color::RED();
+    thickness = 1.0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void DrawableIsocontour<M,V,E,P>::draw(const float scene_size) const
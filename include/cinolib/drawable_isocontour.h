@@ -53,6 +53,7 @@ class DrawableIsocontour : public Isocontour<M,V,E,P>, public DrawableObject
 
         explicit DrawableIsocontour();
         explicit DrawableIsocontour(AbstractPolygonMesh<M,V,E,P> & m, double iso_value);
+        explicit DrawableIsocontour(AbstractPolygonMesh<M,V,E,P> & m, const std::vector<float> & iso_values);
 
         ~DrawableIsocontour(){}
 
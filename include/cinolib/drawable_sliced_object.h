@@ -87,6 +87,18 @@ class DrawableSlicedObj : public AbstractDrawablePolygonMesh<SlicedObj<M,V,E,P>>
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+        explicit DrawableSlicedObj(const Trimesh<M,V,E,P> & m, const double layer_thickness, const double hatch_size = 0.01)
+        : SlicedObj<M,V,E,P>(m, layer_thickness, hatch_size)
+        {
+            this->init_drawable_stuff();
+            this->show_marked_edge_color(Color::BLACK());
+            this->show_marked_edge_width(3.0);
+            this->show_wireframe(false);
+            this->updateGL();
+        }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
         ObjectType object_type() const { return DRAWABLE_SLICED_OBJ; }
 };
 
@@ -45,6 +45,7 @@
 /* 
 * These methods take in input a surface/volumetric mesh M and a label L, and output
 * a submesh M' containing all and only the polygons/polyhedra having L as label.
+* To split a mesh in many parts at once see export_partition (mesh_partitioning.h)
 */
 
 namespace cinolib
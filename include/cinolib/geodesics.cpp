@@ -62,9 +62,9 @@ ScalarField compute_geodesics(      Mesh              & m,
     time *= time;
     time *= time_scalar;
 
-    Eigen::SparseMatrix<float> L   = laplacian(m, laplacian_mode);
-    Eigen::SparseMatrix<float> MM  = mass_matrix(m);
-    Eigen::SparseMatrix<float> G   = gradient_matrix(m);
+    Eigen::SparseMatrix<double> L   = laplacian(m, laplacian_mode);
+    Eigen::SparseMatrix<double> MM  = mass_matrix(m);
+    Eigen::SparseMatrix<double> G   = gradient_matrix(m);
     Eigen::VectorXd             rhs = Eigen::VectorXd::Zero(m.num_verts());
 
     for(uint vid : heat_charges) rhs[vid] = 1.0;
@@ -81,7 +81,7 @@ ScalarField compute_geodesics(      Mesh              & m,
     // as the matrix changes every time
     if(hard_constrain_charges)
     {
-        std::map<uint,float> bcs;
+        std::map<uint,double> bcs;
         for(uint vid : heat_charges) bcs[vid] = 1.0;
         solve_square_system_with_bc(-L, G.transpose() * grad, geodesics, bcs, SIMPLICIAL_LDLT);
     }
@@ -120,14 +120,14 @@ ScalarField compute_geodesics_amortized(      Mesh              & m,
         time *= time;
         time *= time_scalar;
 
-        Eigen::SparseMatrix<float> L   = laplacian(m, laplacian_mode);
-        Eigen::SparseMatrix<float> MM  = mass_matrix(m);
+        Eigen::SparseMatrix<double> L   = laplacian(m, laplacian_mode);
+        Eigen::SparseMatrix<double> MM  = mass_matrix(m);
         Eigen::VectorXd            rhs = Eigen::VectorXd::Zero(m.num_verts());
 
         for(uint vid : heat_charges) rhs[vid] = 1.0;
 
         ScalarField heat(m.num_verts());
-        cache.heat_flow_cache = new Eigen::SimplicialLLT<Eigen::SparseMatrix<float>>(MM - time * L);
+        cache.heat_flow_cache = new Eigen::SimplicialLLT<Eigen::SparseMatrix<double>>(MM - time * L);
         assert(cache.heat_flow_cache->info() == Eigen::Success);
         heat = cache.heat_flow_cache->solve(rhs).eval();
 
@@ -136,7 +136,7 @@ ScalarField compute_geodesics_amortized(      Mesh              & m,
         grad.normalize();
 
         ScalarField geodesics(m.num_verts());
-        cache.integration_cache = new Eigen::SimplicialLDLT<Eigen::SparseMatrix<float>>(-L);
+        cache.integration_cache = new Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>>(-L);
         assert(cache.integration_cache->info() == Eigen::Success);
         geodesics = cache.integration_cache->solve(cache.gradient_matrix.transpose() * grad).eval();
         geodesics.normalize_in_01();
@@ -81,9 +81,9 @@ ScalarField compute_geodesics(      Mesh              & m,
 
 typedef struct
 {
-    Eigen::SimplicialLLT<Eigen::SparseMatrix<float>>  *heat_flow_cache   = NULL;
-    Eigen::SimplicialLDLT<Eigen::SparseMatrix<float>> *integration_cache = NULL;
-    Eigen::SparseMatrix<float>                         gradient_matrix;
+    Eigen::SimplicialLLT<Eigen::SparseMatrix<double>>  *heat_flow_cache   = NULL;
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> *integration_cache = NULL;
+    Eigen::SparseMatrix<double>                         gradient_matrix;
 }
 GeodesicsCache;
 
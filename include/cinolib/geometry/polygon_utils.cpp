@@ -38,6 +38,7 @@
 #include <cinolib/geometry/triangle_utils.h>
 #include <cinolib/predicates.h>
 #include <map>
+#include <cmath>
 
 namespace cinolib
 {
@@ -151,7 +152,12 @@ int polygon_find_ear(const std::vector<vec2d> & poly)
     return curr;
 }
 
-// Implementation of the ear-cut triangulation algorithm
+// Implementation of the ear-cut triangulation algorithm. Vertices are kept in a
+// doubly linked list, and only reflex vertices are tested against candidate ears.
+// Reflex vertices are bucketed in a uniform grid, so that each ear test only visits
+// the cells overlapping the bounding box of the ear. Since a convex vertex can never
+// become reflex while clipping ears, the grid is built once and reflex vertices that
+// become convex (or get removed) are just skipped
 //
 CINO_INLINE
 bool polygon_triangulate(std::vector<vec2d> & poly,
@@ -163,37 +169,106 @@ bool polygon_triangulate(std::vector<vec2d> & poly,
     //
     if(!polygon_is_CCW(poly))
         for(auto & p : poly) p.x() = -p.x();
-   
-    std::map<uint,uint> v_map;
-    for(uint vid=0; vid<poly.size(); ++vid) v_map[vid] = vid;
 
-    std::vector<vec2d> sub_poly = poly;
-    while(sub_poly.size() >= 3)
+    uint n = poly.size();
+    if(n<3) return false;
+
+    std::vector<uint> prev(n), next(n);
+    for(uint vid=0; vid<n; ++vid)
+    {
+        prev.at(vid) = (vid+n-1)%n;
+        next.at(vid) = (vid+1)%n;
+    }
+
+    // flat corners are treated as reflex: they may still block an ear
+    std::vector<bool> reflex(n), removed(n,false);
+    auto update_reflex = [&](const uint vid)
+    {
+        reflex.at(vid) = (orient2d(poly.at(prev.at(vid)), poly.at(vid), poly.at(next.at(vid))) <= 0);
+    };
+    std::vector<uint> reflex_verts;
+    for(uint vid=0; vid<n; ++vid)
+    {
+        update_reflex(vid);
+        if(reflex.at(vid)) reflex_verts.push_back(vid);
+    }
+
+    // bucket reflex vertices in a uniform grid (about one vertex per cell)
+    vec2d bb_min = poly.front(), bb_max = poly.front();
+    for(const vec2d & p : poly)
+    {
+        bb_min = bb_min.min(p);
+        bb_max = bb_max.max(p);
+    }
+    uint   res    = std::max(1u, static_cast<uint>(std::sqrt(static_cast<double>(reflex_verts.size()))));
+    vec2d  delta  = bb_max - bb_min;
+    double cell_x = (delta.x()>0) ? delta.x()/res : 1.0;
+    double cell_y = (delta.y()>0) ? delta.y()/res : 1.0;
+    auto cell = [&](const double v, const double min, const double size)
+    {
+        return std::min(res-1, static_cast<uint>(std::max(0.0, (v-min)/size)));
+    };
+    std::vector<std::vector<uint>> grid(res*res);
+    for(uint vid : reflex_verts)
     {
-        int curr = polygon_find_ear(sub_poly);
-        if(curr<0)
+        grid.at(cell(poly.at(vid).y(), bb_min.y(), cell_y)*res + cell(poly.at(vid).x(), bb_min.x(), cell_x)).push_back(vid);
+    }
+
+    auto is_ear = [&](const uint vid) -> bool
+    {
+        const vec2d & a = poly.at(prev.at(vid));
+        const vec2d & b = poly.at(vid);
+        const vec2d & c = poly.at(next.at(vid));
+        if(orient2d(a,b,c) <= 0) return false; // reflex or flat corner
+
+        vec2d t_min = a.min(b).min(c);
+        vec2d t_max = a.max(b).max(c);
+        uint  x_beg = cell(t_min.x(), bb_min.x(), cell_x), x_end = cell(t_max.x(), bb_min.x(), cell_x);
+        uint  y_beg = cell(t_min.y(), bb_min.y(), cell_y), y_end = cell(t_max.y(), bb_min.y(), cell_y);
+        for(uint y=y_beg; y<=y_end; ++y)
+        for(uint x=x_beg; x<=x_end; ++x)
+        for(uint r : grid.at(y*res+x))
         {
-            //std::cerr << "WARNING: ear cut algorithm failure (is the polygon degenerate?)" << std::endl;
-            tris.clear();
-            return false;
+            if(removed.at(r) || !reflex.at(r)) continue;
+            if(r == prev.at(vid) || r == vid || r == next.at(vid)) continue;
+            if(point_in_triangle_2d(poly.at(r), a, b, c) >= STRICTLY_INSIDE) return false;
         }
-        uint prev = (curr+sub_poly.size()-1)%sub_poly.size(),next = (curr+1)%sub_poly.size();
-        
-        tris.push_back(v_map.at(prev));
-        tris.push_back(v_map.at(curr));
-        tris.push_back(v_map.at(next));
-
-        // update poly and v_map
-        std::map<uint,uint> tmp_v_map;
-        std::vector<vec2d>  tmp_poly;
-        for(uint vid=0; vid<sub_poly.size(); ++vid)
+        return true;
+    };
+
+    uint curr   = 0;
+    uint n_left = n;
+    uint n_fail = 0; // consecutive non ears
+    while(n_left >= 3)
+    {
+        if(is_ear(curr))
         {
-            if ((int)vid==curr) continue;
-            tmp_poly.push_back(sub_poly.at(vid));
-            tmp_v_map[tmp_poly.size()-1] = v_map.at(vid);
+            uint p = prev.at(curr);
+            uint q = next.at(curr);
+            tris.push_back(p);
+            tris.push_back(curr);
+            tris.push_back(q);
+
+            removed.at(curr) = true;
+            next.at(p) = q;
+            prev.at(q) = p;
+            --n_left;
+            if(reflex.at(p)) update_reflex(p);
+            if(reflex.at(q)) update_reflex(q);
+            curr   = q;
+            n_fail = 0;
+        }
+        else
+        {
+            curr = next.at(curr);
+            if(++n_fail > n_left)
+            {
+                // no ear could be found (usually means the polygon is degenerate)
+                //std::cerr << "WARNING: ear cut algorithm failure (is the polygon degenerate?)" << std::endl;
+                tris.clear();
+                return false;
+            }
         }
-        sub_poly = tmp_poly;
-        v_map    = tmp_v_map;
     }
     return true;
 }
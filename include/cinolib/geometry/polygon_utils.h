@@ -82,7 +82,9 @@ bool polygon_flatten(const std::vector<vec3d> & poly3d,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-// Implementation of the ear-cut triangulation algorithm
+// Implementation of the ear-cut triangulation algorithm. Reflex vertices
+// are bucketed in a uniform grid to speed up ear tests, which makes it
+// practical also for polygons with thousands of vertices
 //
 CINO_INLINE
 bool polygon_triangulate(std::vector<vec2d> & poly, std::vector<uint> & tris);
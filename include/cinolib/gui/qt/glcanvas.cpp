@@ -880,6 +880,23 @@ bool GLcanvas::unproject(const vec2i & p2d, vec3d & p3d)
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+CINO_INLINE
+void GLcanvas::unproject_ray(const vec2i & p2d, vec3d & ray_orig, vec3d & ray_dir)
+{
+    GLint viewport[4] =
+    {
+        0,        height(), // top left corner
+        width(), -height()  // bottom right corner
+    };
+
+    vec3d p_far;
+    gluUnProject(p2d.x(), p2d.y(), 0.0, trackball.modelview, trackball.projection, viewport, &ray_orig.x(), &ray_orig.y(), &ray_orig.z());
+    gluUnProject(p2d.x(), p2d.y(), 1.0, trackball.modelview, trackball.projection, viewport, &p_far.x(),    &p_far.y(),    &p_far.z());
+    ray_dir = p_far - ray_orig;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 bool GLcanvas::project(const vec3d & p3d, vec2i & p2d, GLdouble & depth)
 {
@@ -141,6 +141,7 @@ class GLcanvas : public QGLWidget
         bool depth_test   (const vec3d & p3d);
         bool project      (const vec3d & p3d, vec2i & p2d, GLdouble & depth);
         bool unproject    (const vec2i & p2d, vec3d & p3d);
+        void unproject_ray(const vec2i & p2d, vec3d & ray_orig, vec3d & ray_dir); // ray from the near to the far plane (no Z buffer read)
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
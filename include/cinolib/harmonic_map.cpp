@@ -40,13 +40,36 @@
 namespace cinolib
 {
 
+CINO_INLINE
+Eigen::SparseMatrix<double> polyharmonic_matrix(const Eigen::SparseMatrix<double> & L, const uint n)
+{
+    assert(n > 0);
+
+    // exponentiation by squaring: O(log n) sparse products instead of n-1
+    Eigen::SparseMatrix<double> base = -L; // keep it PSD
+    Eigen::SparseMatrix<double> Ln;
+    bool first = true;
+    for(uint e=n; e>0; e>>=1)
+    {
+        if(e & 1)
+        {
+            if(first) Ln = base; else Ln = (Ln * base).pruned();
+            first = false;
+        }
+        if(e > 1) base = (base * base).pruned();
+    }
+    return Ln;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 ScalarField harmonic_map(const AbstractMesh<M,V,E,P> & m,
-                         const std::map<uint,float> & bc,
+                         const std::map<uint,double> & bc,
                          const uint                    n,
-                         const short                     laplacian_mode,
-                         const short                     solver)
+                         const short                   laplacian_mode,
+                         const short                   solver)
 {
     assert(n > 0);
     assert(bc.size() > 0);
@@ -55,18 +78,14 @@ ScalarField harmonic_map(const AbstractMesh<M,V,E,P> & m,
 
     ScalarField f(m.num_verts());
 
-    Eigen::SparseMatrix<float> L   = laplacian(m, laplacian_mode);
-    Eigen::SparseMatrix<float> Ln = -L;
-    Eigen::VectorXd            rhs = Eigen::VectorXd::Zero(m.num_verts());
-
-    for(uint i=1; i<n; ++i) Ln=Ln*(-L); // keep it PSD
+    Eigen::SparseMatrix<double> Ln  = polyharmonic_matrix(laplacian(m, laplacian_mode), n);
+    Eigen::VectorXd             rhs = Eigen::VectorXd::Zero(m.num_verts());
 
     solve_square_system_with_bc(Ln, rhs, f, bc, solver);
 
     return f;
 }
 
-
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<class M, class V, class E, class P>
@@ -74,38 +93,33 @@ CINO_INLINE
 std::vector<vec3d> harmonic_map_3d(const AbstractMesh<M,V,E,P> & m,
                                    const std::map<uint,vec3d>  & bc,
                                    const uint                    n,
-                                   const short                     laplacian_mode,
-                                   const short                     solver)
+                                   const short                   laplacian_mode,
+                                   const short                   solver)
 {
     assert(n > 0);
     assert(bc.size() > 0);
     assert(laplacian_mode == COTANGENT || laplacian_mode == UNIFORM);
     assert(solver == SIMPLICIAL_LLT || solver == SIMPLICIAL_LDLT || solver == SparseLU || solver == BiCGSTAB);
 
-    ScalarField f(3*m.num_verts());
-
-    Eigen::SparseMatrix<float> L   = laplacian(m, laplacian_mode, 3);
-    Eigen::SparseMatrix<float> Ln = -L;
-    Eigen::VectorXd             rhs = Eigen::VectorXd::Zero(3*m.num_verts());
-
-    for(uint i=1; i<n; ++i) Ln  = Ln * (-L); // keep it PSD
+    // x, y and z are decoupled and share the same (nv x nv) operator:
+    // factorize it once and solve for the three coordinates as multiple
+    // right hand sides, rather than assembling a (3nv x 3nv) block system
+    Eigen::SparseMatrix<double> Ln  = polyharmonic_matrix(laplacian(m, laplacian_mode), n);
+    Eigen::MatrixXd             rhs = Eigen::MatrixXd::Zero(m.num_verts(), 3);
+    Eigen::MatrixXd             xyz;
 
-    uint y_off = m.num_verts();
-    uint z_off = m.num_verts() + y_off;
-    std::map<uint,float> bc_1d;
+    std::map<uint,std::vector<double>> bc_xyz;
     for(auto obj : bc)
     {
         vec3d pos = obj.second;
-        bc_1d[obj.first] = pos.x();
-        bc_1d[y_off+obj.first] = pos.y();
-        bc_1d[z_off+obj.first] = pos.z();
+        bc_xyz[obj.first] = { pos.x(), pos.y(), pos.z() };
     }
 
-    solve_square_system_with_bc(Ln, rhs, f, bc_1d, solver);
+    solve_square_system_with_bc(Ln, rhs, xyz, bc_xyz, solver);
 
     std::vector<vec3d> res(m.num_verts());
     for(uint vid=0; vid<m.num_verts(); ++vid)
-        res.at(vid) = vec3d(f[vid], f[y_off+vid], f[z_off+vid]);
+        res.at(vid) = vec3d(xyz(vid,0), xyz(vid,1), xyz(vid,2));
 
     return res;
 }
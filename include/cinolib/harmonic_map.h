@@ -47,6 +47,16 @@
 namespace cinolib
 {
 
+/* Returns the (semi positive definite) polyharmonic operator (-L)^n.
+ * Powers are computed by repeated squaring, hence only O(log n) sparse
+ * matrix products are necessary.
+*/
+
+CINO_INLINE
+Eigen::SparseMatrix<double> polyharmonic_matrix(const Eigen::SparseMatrix<double> & L, const uint n);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 /*
  * Solve the (n)-harmonic problem  L phi = 0,
  * subject to certain Dirichlet boundary conditions
@@ -62,10 +72,10 @@ namespace cinolib
 template<class M, class V, class E, class P>
 CINO_INLINE
 ScalarField harmonic_map(const AbstractMesh<M,V,E,P> & m,
-                         const std::map<uint,float> & bc,
+                         const std::map<uint,double> & bc,
                          const uint                    n = 1,
-                         const short                     laplacian_mode = COTANGENT,
-                         const short                     solver = SIMPLICIAL_LLT);
+                         const short                   laplacian_mode = COTANGENT,
+                         const short                   solver = SIMPLICIAL_LLT);
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -74,8 +84,8 @@ CINO_INLINE
 std::vector<vec3d> harmonic_map_3d(const AbstractMesh<M,V,E,P> & m,
                                    const std::map<uint,vec3d>  & bc,
                                    const uint                    n = 1,
-                                   const short                     laplacian_mode = COTANGENT,
-                                   const short                     solver = SIMPLICIAL_LLT);
+                                   const short                   laplacian_mode = COTANGENT,
+                                   const short                   solver = SIMPLICIAL_LLT);
 }
 
 #ifndef  CINO_STATIC_LIB
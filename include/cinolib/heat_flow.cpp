@@ -54,13 +54,13 @@ ScalarField heat_flow(const AbstractMesh<M,V,E,P> & m,
 
     ScalarField heat(m.num_verts());
 
-    Eigen::SparseMatrix<float> L   = laplacian(m, laplacian_mode);
-    Eigen::SparseMatrix<float> MM  = mass_matrix(m);
+    Eigen::SparseMatrix<double> L   = laplacian(m, laplacian_mode);
+    Eigen::SparseMatrix<double> MM  = mass_matrix(m);
     Eigen::VectorXd             rhs = Eigen::VectorXd::Zero(m.num_verts());
 
     if (hard_contraint_bcs) // heat flow as a boundary problem (charges do not lose heat)
     {
-        std::map<uint,float> bcs;
+        std::map<uint,double> bcs;
         for(uint vid: heat_charges) bcs[vid] = 1.0;
         solve_square_system_with_bc(MM - time * L, rhs, heat, bcs);
     }
@@ -37,6 +37,11 @@
 #include <cinolib/shortest_path_tree.h>
 #include <cinolib/mst.h>
 #include <cinolib/stl_container_utilities.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 namespace cinolib
 {
@@ -47,6 +52,11 @@ std::ostream & operator<<(std::ostream & in, const HomotopyBasisData & data)
     in << ":::::::::::::::::::: HOMOTOPY BASIS INFO ::::::::::::::::;::\n";
     in << "Root              : " << data.root                      << "\n";
     in << "Globally shortest : " << data.globally_shortest         << "\n";
+    if(data.globally_shortest)
+    {
+        in << "Candidate roots   : " << ((data.max_roots>0) ? std::to_string(data.max_roots) : std::string("all")) << "\n";
+        in << "Pruned roots      : " << data.roots_pruned              << "\n";
+    }
     in << "Length            : " << data.length                    << "\n";
     in << "Detach basis loops: " << data.detach_loops              << "\n";
     if(data.detach_loops)
@@ -76,54 +86,91 @@ std::ostream & operator<<(std::ostream & in, const RefinementStats & stats)
 
 template<class M, class V, class E, class P>
 CINO_INLINE
-double homotopy_basis(AbstractPolygonMesh<M,V,E,P>   & m,
-                      const uint                       root,
-                      std::vector<std::vector<uint>> & basis,
-                      std::vector<bool>              & tree,
-                      std::vector<bool>              & cotree)
+double homotopy_basis_length(const AbstractPolygonMesh<M,V,E,P> & m,
+                             const uint                           root,
+                                   HomotopyBasisWorkspace       & ws,
+                             const double                         max_length)
 {
     assert(root<m.num_verts());
 
-    shortest_path_tree(m, root, tree);
+    shortest_path_tree(m, root, ws.tree, ws.dist, ws.parent);
+
+    // Each non tree edge closes a loop with the tree paths connecting its endpoints with the root.
+    // The basis is made of 2*genus such loops, hence the sum of the 2*genus shortest loops is a
+    // lower bound for its length. If the bound is already too high, skip the cotree altogether
+    // (a tiny tolerance accounts for the different summation order, so that ties are never pruned)
+    uint n_loops = 2*m.genus();
+    ws.loop_lengths.clear();
+    for(uint eid=0; eid<m.num_edges(); ++eid)
+    {
+        if(ws.tree.at(eid)) continue;
+        ws.loop_lengths.push_back(m.edge_length(eid) + ws.dist.at(m.edge_vert_id(eid,0)) + ws.dist.at(m.edge_vert_id(eid,1)));
+    }
+    assert(n_loops<=ws.loop_lengths.size());
+    std::nth_element(ws.loop_lengths.begin(), ws.loop_lengths.begin()+n_loops, ws.loop_lengths.end());
+    double lower_bound = 0.0;
+    for(uint i=0; i<n_loops; ++i) lower_bound += ws.loop_lengths.at(i);
+    if(lower_bound > max_length*(1.0+1e-10)) return inf_double;
 
     // Compute the cotree as the Maximum Spanning Tree of the dual of M,
     // without considering dual edges that cross edges of primal tree.
     //
-    // I'm using a classical Minimum Spanning Tree algorithm (Prim's) with negative weights
-    std::vector<float> edge_weights(m.num_edges(),0);
-    std::vector<bool>  edge_mask(m.num_edges()); // restrict Dijkstra to the edges in tree only
-    for(uint eid=0; eid<m.num_edges(); ++eid) edge_mask.at(eid) = !tree.at(eid);
+    // I'm using a classical Minimum Spanning Tree algorithm (Prim's) with negative weights.
+    // Tree paths are shortest paths, hence the length of the tree path from a vertex
+    // to the root is its geodesic distance from the root
+    ws.edge_weights.assign(m.num_edges(),0);
     for(uint eid=0; eid<m.num_edges(); ++eid)
     {
-        if(tree.at(eid)) continue;
-        std::vector<uint> tmp;
-        edge_weights.at(eid) -= m.edge_length(eid);
-        edge_weights.at(eid) -= dijkstra_mask_on_edges(m, m.edge_vert_id(eid,0), root, edge_mask, tmp);
-        edge_weights.at(eid) -= dijkstra_mask_on_edges(m, m.edge_vert_id(eid,1), root, edge_mask, tmp);
+        if(ws.tree.at(eid)) continue;
+        ws.edge_weights.at(eid) -= m.edge_length(eid);
+        ws.edge_weights.at(eid) -= ws.dist.at(m.edge_vert_id(eid,0));
+        ws.edge_weights.at(eid) -= ws.dist.at(m.edge_vert_id(eid,1));
     }
-    MST_on_dual_mask_on_edges(m, edge_weights, tree, cotree); // use tree as edge mask
+    MST_on_dual_mask_on_edges(m, ws.edge_weights, ws.tree, ws.cotree); // use tree as edge mask
 
-    // Find the edges neither in tree, nor in cotree
-    std::vector<uint> generators;
+    // Find the edges neither in tree, nor in cotree, and sum the lengths of their loops
+    // (all terms are positive, so the partial sum can be used to stop early)
+    ws.generators.clear();
+    double length = 0.0;
     for(uint eid=0; eid<m.num_edges(); ++eid)
-        if(!tree.at(eid) && !cotree.at(eid)) generators.push_back(eid);
-   
-    assert(m.genus()*2 == (int)generators.size());
+    {
+        if(ws.tree.at(eid) || ws.cotree.at(eid)) continue;
+        ws.generators.push_back(eid);
+        length += m.edge_length(eid);
+        length += ws.dist.at(m.edge_vert_id(eid,0));
+        length += ws.dist.at(m.edge_vert_id(eid,1));
+        if(length > max_length) return inf_double;
+    }
+    assert(m.genus()*2 == (int)ws.generators.size());
+
+    return length;
+}
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double homotopy_basis(AbstractPolygonMesh<M,V,E,P>   & m,
+                      const uint                       root,
+                      std::vector<std::vector<uint>> & basis,
+                      std::vector<bool>              & tree,
+                      std::vector<bool>              & cotree)
+{
+    HomotopyBasisWorkspace ws;
+    double length = homotopy_basis_length(m, root, ws);
 
-    // Start from each such edge, and close a loop with its two endpoints
+    // Start from each generator, and close a loop with the tree paths of its two endpoints
     basis.clear();
-    double length = 0.0;
-    for(uint eid : generators)
+    for(uint eid : ws.generators)
     {
         std::vector<uint> e0_to_root, e1_to_root;
-        length += m.edge_length(eid);
-        length += dijkstra_mask_on_edges(m, m.edge_vert_id(eid,0), root, edge_mask, e0_to_root);
-        length += dijkstra_mask_on_edges(m, m.edge_vert_id(eid,1), root, edge_mask, e1_to_root);
+        for(int vid=m.edge_vert_id(eid,0); vid!=-1; vid=ws.parent.at(vid)) e0_to_root.push_back(vid);
+        for(int vid=m.edge_vert_id(eid,1); vid!=-1; vid=ws.parent.at(vid)) e1_to_root.push_back(vid);
         e1_to_root.pop_back();
         std::reverse(e1_to_root.begin(), e1_to_root.end());
         std::copy(e1_to_root.begin(), e1_to_root.end(), std::back_inserter(e0_to_root));
         basis.push_back(e0_to_root);
     }
+    tree.swap(ws.tree);
+    cotree.swap(ws.cotree);
     return length;
 }
 
@@ -137,36 +184,61 @@ void homotopy_basis(AbstractPolygonMesh<M,V,E,P> & m,
     //
     if(data.globally_shortest)
     {
-        double best_length = inf_double;
-        uint   best_root;
-        std::vector<std::vector<uint>> best_basis;
-        std::vector<bool>              best_tree;
-        std::vector<bool>              best_cotree;
-
-        for(uint vid=0; vid<m.num_verts(); ++vid)
+        // The input root is tested first, so that its length can be used to prune the
+        // other candidates as early as possible. If max_roots is set, only a subset of
+        // evenly spread vertices is tested. Since the input root is always among the
+        // candidates, the output basis is never longer than the one centered at it
+        std::vector<uint> roots(1, data.root);
+        uint n_roots = (data.max_roots>0) ? std::min(data.max_roots, m.num_verts()) : m.num_verts();
+        for(uint i=0; i<n_roots; ++i)
         {
-            double length = homotopy_basis(m, vid, data.loops, data.tree, data.cotree);
+            uint vid = static_cast<uint>((static_cast<uint64_t>(i)*m.num_verts())/n_roots);
+            if(vid!=data.root) roots.push_back(vid);
+        }
 
-            if(length < best_length)
+        // Workers only read the mesh, hence all adjacencies must exist beforehand
+        m.adjacency_require(ADJ_ALL);
+
+        // Roots are distributed across a pool of workers, each owning its own workspace.
+        // Workers pull roots from a shared counter, as pruning makes per root costs very
+        // uneven. Ties are broken in favor of the smallest vertex id, hence the output
+        // does not depend on the order in which roots are evaluated
+        double             best_length = inf_double;
+        uint               best_root   = data.root;
+        std::mutex         mutex;
+        std::atomic<uint>  next(0);
+        std::atomic<uint>  n_pruned(0);
+        const uint n_threads = std::max(1u, std::thread::hardware_concurrency());
+        PARALLEL_FOR(0, n_threads, 2, [&](uint)
+        {
+            HomotopyBasisWorkspace ws;
+            for(uint i=next++; i<roots.size(); i=next++)
             {
-                best_root   = vid;
-                best_length = length;
-                best_basis  = data.loops;
-                best_tree   = data.tree;
-                best_cotree = data.cotree;
+                double bound;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    bound = best_length;
+                }
+                double length = homotopy_basis_length(m, roots.at(i), ws, bound);
+                if(length==inf_double)
+                {
+                    ++n_pruned;
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                if(length < best_length || (length==best_length && roots.at(i)<best_root))
+                {
+                    best_length = length;
+                    best_root   = roots.at(i);
+                }
             }
-        }
-        data.loops  = best_basis;
-        data.root   = best_root;
-        data.length = best_length;
-        data.tree   = best_tree;
-        data.cotree = best_cotree;
-    }
-    else
-    {
-        data.length = homotopy_basis(m, data.root, data.loops, data.tree, data.cotree);
+        });
+        data.root         = best_root;
+        data.roots_pruned = n_pruned;
     }
 
+    data.length = homotopy_basis(m, data.root, data.loops, data.tree, data.cotree);
+
     if(data.detach_loops) detach_loops(dynamic_cast<Trimesh<M,V,E,P>&>(m), data);
 }
 
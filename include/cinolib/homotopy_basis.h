@@ -107,6 +107,7 @@ typedef struct
     // INPUT: SETTINGS
     bool  globally_shortest  = false; // cost for globally shortest is O(n^2 log n). When this is set to true, root will contain the root of the globally shortest basis
     uint  root               = 0;     // cost for a base centered at root is O(n log n)
+    uint  max_roots          = 0;     // globally shortest only: if >0, test only max_roots candidate roots evenly spread across the vertex list, plus root (the result is never longer than the basis centered at root)
 
     // INPUT: REFINEMENT OPTIONS AND STATISTICS
     bool  detach_loops       = false;                 // refine mesh topology to detach loops traversing the same edges
@@ -117,6 +118,7 @@ typedef struct
     // OUTPUT: BASIS AND LENGTH
     std::vector<std::vector<uint>> loops;
     float length = 0.0; // length of the basis
+    uint  roots_pruned = 0; // globally shortest only: candidate roots discarded before their basis was complete
 
     // OUTPUT: AUXILIARY DATA (may be useful for visual inspection/debugging)
     // note: tree and cotree reference the input mesh. If loops are detached they are useless
@@ -128,11 +130,36 @@ HomotopyBasisData;
 CINO_INLINE
 std::ostream & operator<<(std::ostream & in, const HomotopyBasisData & data);
 
+// Buffers used to compute the homotopy basis centered at a given root. When many roots are
+// evaluated (e.g. to find the globally shortest basis) each thread owns one workspace, which
+// is reused across roots to avoid reallocating everything at each evaluation
+typedef struct
+{
+    std::vector<double> dist;         // geodesic distance from the root
+    std::vector<int>    parent;       // next vertex along the tree path to the root
+    std::vector<bool>   tree;         // one element per edge. True if it is a part of the tree
+    std::vector<bool>   cotree;       // one element per edge. True if it is a part of the cotree
+    std::vector<float>  edge_weights; // cotree weights
+    std::vector<double> loop_lengths; // length of the loop closed by each non tree edge
+    std::vector<uint>   generators;   // edges that are neither in the tree nor in the cotree
+}
+HomotopyBasisWorkspace;
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void homotopy_basis(AbstractPolygonMesh<M,V,E,P> & m,
                     HomotopyBasisData            & data);
 
+// Computes tree, cotree and generators of the basis centered at root (stored in ws)
+// and returns its length, without assembling the loops. Computation is interrupted
+// as soon as the basis is known to be longer than max_length, and inf_double is returned
+template<class M, class V, class E, class P>
+CINO_INLINE
+double homotopy_basis_length(const AbstractPolygonMesh<M,V,E,P> & m,
+                             const uint                           root,
+                                   HomotopyBasisWorkspace       & ws,
+                             const double                         max_length = inf_double);
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 double homotopy_basis(AbstractPolygonMesh<M,V,E,P>   & m,
@@ -43,7 +43,7 @@
 *********************************************************************************/
 #include <cinolib/io/read_STL.h>
 #include <cinolib/io/io_utilities.h>
-#include <map>
+#include <cinolib/merge_duplicated_verts.h>
 
 namespace cinolib
 {
@@ -82,8 +82,6 @@ void read_STL(const char         * filename,
         exit(-1);
     }
 
-    std::map<vec3d,uint> vmap;
-
     if(seek_keyword(fp, "solid")) // ASCII file
     {
         while(seek_keyword(fp, "facet"))
@@ -105,23 +103,8 @@ void read_STL(const char         * filename,
                 if(!eat_double(fp, v.y())) assert(false && "could not parse y coord");
                 if(!eat_double(fp, v.z())) assert(false && "could not parse z coord");
 
-                if(merge_duplicated_verts)
-                {
-                    auto it = vmap.find(v);
-                    if(it == vmap.end())
-                    {
-                        uint fresh_id = vmap.size();
-                        vmap[v] = fresh_id;
-                        verts.push_back(v);
-                        tris.push_back(fresh_id);
-                    }
-                    else tris.push_back(it->second);
-                }
-                else
-                {
-                    tris.push_back(verts.size());
-                    verts.push_back(v);
-                }
+                tris.push_back(verts.size());
+                verts.push_back(v);
             }
             if(!seek_keyword(fp, "endloop"))  assert(false && "could not find keyword ENDLOOP");
             if(!seek_keyword(fp, "endfacet")) assert(false && "could not find keyword ENDFACET");
@@ -143,6 +126,9 @@ void read_STL(const char         * filename,
         // read triangles
         unsigned int nt;
         if(fread(&nt, sizeof(unsigned int), 1, fp)!=1) assert(false && "error reading number of triangles");
+        normals.reserve(nt);
+        verts.reserve(3*nt);
+        tris.reserve(3*nt);
         for(unsigned int i=0; i<nt; ++i)
         {
             // read normal
@@ -157,24 +143,9 @@ void read_STL(const char         * filename,
                 float vf[3];
                 if(fread(&vf, sizeof(float), 3, fp)!=3) assert(false && "error reading vertex");
 
-                vec3d v(vf[0], vf[1], vf[2]);                
-                if(merge_duplicated_verts)
-                {
-                    auto it = vmap.find(v);
-                    if(it == vmap.end())
-                    {
-                        uint fresh_id = vmap.size();
-                        vmap[v] = fresh_id;
-                        verts.push_back(v);
-                        tris.push_back(fresh_id);
-                    }
-                    else tris.push_back(it->second);
-                }
-                else
-                {
-                    tris.push_back(verts.size());
-                    verts.push_back(v);
-                }
+                vec3d v(vf[0], vf[1], vf[2]);
+                tris.push_back(verts.size());
+                verts.push_back(v);
             }
 
             // read (and discard) attribute
@@ -183,6 +154,10 @@ void read_STL(const char         * filename,
         }
         fclose(fp);
     }
+
+    // triangles are read as a soup (i.e. three fresh verts per triangle), and
+    // duplicated verts are merged at the end with a spatial hash
+    if(merge_duplicated_verts) cinolib::merge_duplicated_verts(verts, tris);
 }
 
 }
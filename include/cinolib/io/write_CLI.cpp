@@ -0,0 +1,87 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/write_CLI.h>
+#include <iostream>
+
+namespace cinolib
+{
+
+CINO_INLINE
+void write_CLI(const char                                         * filename,
+               const std::vector<double>                          & z,
+               const std::vector<std::vector<std::vector<vec3d>>> & internal_polylines, // inner holes
+               const std::vector<std::vector<std::vector<vec3d>>> & external_polylines, // outer slice boundary
+               const std::vector<std::vector<std::vector<vec3d>>> & open_polylines)     // support structures
+{
+    assert(internal_polylines.size() == z.size());
+    assert(external_polylines.size() == z.size());
+    assert(open_polylines.size()     == z.size());
+
+    setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
+
+    FILE *fp = fopen(filename, "w");
+
+    if(!fp)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write_CLI() : couldn't save file " << filename << std::endl;
+        exit(-1);
+    }
+
+    fprintf(fp, "$$HEADERSTART\n$$ASCII\n$$UNITS/1\n$$LAYERS/%d\n$$HEADEREND\n$$GEOMETRYSTART\n", static_cast<int>(z.size()));
+
+    // type: 0 = internal, 1 = external, 2 = open (see read_CLI)
+    auto write_polyline = [fp](const std::vector<vec3d> & pl, const int type)
+    {
+        bool closed = (type != 2);
+        fprintf(fp, "$$POLYLINE/0,%d,%d", type, static_cast<int>(pl.size() + (closed ? 1 : 0)));
+        for(const vec3d & p : pl) fprintf(fp, ",%.17g,%.17g", p.x(), p.y());
+        if(closed) fprintf(fp, ",%.17g,%.17g", pl.front().x(), pl.front().y());
+        fprintf(fp, "\n");
+    };
+
+    for(uint sid=0; sid<z.size(); ++sid)
+    {
+        fprintf(fp, "$$LAYER/%.17g\n", z.at(sid));
+        for(const auto & pl : external_polylines.at(sid)) write_polyline(pl, 1);
+        for(const auto & pl : internal_polylines.at(sid)) write_polyline(pl, 0);
+        for(const auto & pl : open_polylines.at(sid))     write_polyline(pl, 2);
+    }
+
+    fprintf(fp, "$$GEOMETRYEND\n");
+    fclose(fp);
+}
+
+}
@@ -0,0 +1,69 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_WRITE_CLI_H
+#define CINO_WRITE_CLI_H
+
+#include <vector>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec3.h>
+
+namespace cinolib
+{
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Reference for COMMON LAYER INTERFACE (CLI) file format:
+// http://www.hmilch.net/downloads/cli_format.html
+//
+// NOTE: input vectors have as many entries as the number of slices, with
+// the same layout produced by read_CLI. Internal and external polylines
+// are closed (the first point is not repeated at the end), open polylines
+// are written as they are. The z coordinates of the polylines are ignored,
+// and each layer is written at the height specified in z.
+//
+CINO_INLINE
+void write_CLI(const char                                         * filename,
+               const std::vector<double>                          & z,
+               const std::vector<std::vector<std::vector<vec3d>>> & internal_polylines, // inner holes
+               const std::vector<std::vector<std::vector<vec3d>>> & external_polylines, // outer slice boundary
+               const std::vector<std::vector<std::vector<vec3d>>> & open_polylines);    // support structures
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "write_CLI.cpp"
+#endif
+
+#endif // CINO_WRITE_CLI_H
@@ -36,7 +36,12 @@
 #include <cinolib/isocontour.h>
 #include <cinolib/cino_inline.h>
 #include <cinolib/interval.h>
-#include <queue>
+#include <cinolib/parallel_for.h>
+#include <unordered_map>
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <set>
 
 namespace cinolib
 {
@@ -44,97 +49,209 @@ namespace cinolib
 template<class M, class V, class E, class P>
 CINO_INLINE
 Isocontour<M,V,E,P>::Isocontour()
-{
-    iso_value = 0;
-}
+{}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<class M, class V, class E, class P>
 CINO_INLINE
-Isocontour<M,V,E,P>::Isocontour(AbstractPolygonMesh<M,V,E,P> & m, float iso_value) : iso_value(iso_value)
+Isocontour<M,V,E,P>::Isocontour(AbstractPolygonMesh<M,V,E,P> & m, float iso_value)
+: Isocontour(m, std::vector<float>(1,iso_value))
+{}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+Isocontour<M,V,E,P>::Isocontour(AbstractPolygonMesh<M,V,E,P> & m, const std::vector<float> & iso_values)
+: iso_values(iso_values)
 {
+    // A vertex with f == iso is treated as if it were slightly above the iso value.
+    // This way each triangle is crossed by at most one segment, with endpoints on
+    // two of its edges, and curves passing through vertices remain connected
+
+    auto f = [&m](const uint vid) { return m.vert_data(vid).uvw[0]; };
+    m.adjacency_require(ADJ_EDGES); // edge ids are queried by the parallel extraction
+
+    // flatten the tessellation of all polys
+    std::vector<uint> tris, tri_pid;
     for(uint pid=0; pid<m.num_polys(); ++pid)
-    for(uint i=0; i< m.poly_tessellation(pid).size()/3; ++i)
     {
-        uint   vid0 = m.poly_tessellation(pid).at(3*i+0),vid1 = m.poly_tessellation(pid).at(3*i+1),vid2 = m.poly_tessellation(pid).at(3*i+2);
-        
-        float f0=m.vert_data(vid0).uvw[0],f1=m.vert_data(vid1).uvw[0],f2=m.vert_data(vid2).uvw[0];
-        
-        // There are seven possible cases:
-        // 1) the curve coincides with (v0,v1)
-        // 2) the curve coincides with (v1,v2)
-        // 3) the curve coincides with (v2,v0)
-        // 4) the curve enters from (v0,v1) and exits from (v0,v2)
-        // 5) the curve enters from (v0,v1) and exits from (v1,v2)
-        // 6) the curve enters from (v1,v2) and exits from (v2,v0)
-        // 7) the does not pass fromm here
-
-        bool through_v0=(iso_value == f0),through_v1=(iso_value==f1),through_v2=(iso_value==f2);
-        bool crosses_v0_v1 = is_into_interval<float>(iso_value, f0, f1, true),crosses_v1_v2 = is_into_interval<float>(iso_value, f1, f2, true),crosses_v2_v0 = is_into_interval<float>(iso_value, f2, f0, true);
-
-        float alpha0 = std::fabs(iso_value - f0)/fabs(f1 - f0),alpha1 = std::fabs(iso_value - f1)/fabs(f2 - f1),alpha3 = std::fabs(iso_value - f2)/fabs(f0 - f2);;
-        
-        if (through_v0 && through_v1) // case 1) the curve coincides with (v0,v1)
+        const std::vector<uint> & t = m.poly_tessellation(pid);
+        tris.insert(tris.end(), t.begin(), t.end());
+        tri_pid.insert(tri_pid.end(), t.size()/3, pid);
+    }
+    uint n_tris = tri_pid.size();
+    uint n_iso  = iso_values.size();
+
+    // sort iso values, so that the values crossing a triangle form a contiguous range
+    std::vector<uint> order(n_iso);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](uint i, uint j){ return iso_values.at(i) < iso_values.at(j); });
+    std::vector<float> sorted_iso(n_iso);
+    for(uint i=0; i<n_iso; ++i) sorted_iso.at(i) = iso_values.at(order.at(i));
+
+    // interval index: a triangle is crossed by all the iso values in (min,max]. The
+    // range [tri_beg,tri_end) of sorted iso values in it is empty for most triangles
+    std::vector<uint> tri_beg(n_tris), tri_end(n_tris);
+    PARALLEL_FOR(0, n_tris, 1000, [&](const uint tid)
+    {
+        double f0 = f(tris.at(3*tid+0));
+        double f1 = f(tris.at(3*tid+1));
+        double f2 = f(tris.at(3*tid+2));
+        double min = std::min(f0, std::min(f1,f2));
+        double max = std::max(f0, std::max(f1,f2));
+        tri_beg.at(tid) = std::upper_bound(sorted_iso.begin(), sorted_iso.end(), min) - sorted_iso.begin();
+        tri_end.at(tid) = std::upper_bound(sorted_iso.begin(), sorted_iso.end(), max) - sorted_iso.begin();
+    });
+
+    // bucket triangles per iso value (CSR layout)
+    std::vector<uint> bucket_off(n_iso+1, 0);
+    for(uint tid=0; tid<n_tris; ++tid)
+    for(uint k=tri_beg.at(tid); k<tri_end.at(tid); ++k) ++bucket_off.at(k+1);
+    for(uint k=0; k<n_iso; ++k) bucket_off.at(k+1) += bucket_off.at(k);
+    std::vector<uint> bucket(bucket_off.back());
+    std::vector<uint> fill(bucket_off.begin(), bucket_off.end()-1);
+    for(uint tid=0; tid<n_tris; ++tid)
+    for(uint k=tri_beg.at(tid); k<tri_end.at(tid); ++k) bucket.at(fill.at(k)++) = tid;
+
+    // extract the curves of each iso value independently
+    std::vector<std::vector<Polyline>> iso_curves(n_iso);
+    PARALLEL_FOR(0, n_iso, 2, [&](const uint k)
+    {
+        double iso = sorted_iso.at(k);
+
+        // crossing points are identified by the (sorted) endpoints of the edge they
+        // lie on. This welds the points shared by adjacent triangles for free
+        auto key = [](uint v0, uint v1) -> uint64_t
         {
-            segs.push_back(m.vert(vid0));
-            segs.push_back(m.vert(vid1));
-        }
-        else if (through_v1 && through_v2) // case 2) the curve coincides with (v1,v2)
+            if(v0>v1) std::swap(v0,v1);
+            return (uint64_t(v0)<<32) | uint64_t(v1);
+        };
+
+        struct Seg { uint64_t from, to; uint pid; };
+        std::vector<Seg> segments;
+        segments.reserve(bucket_off.at(k+1) - bucket_off.at(k));
+        for(uint i=bucket_off.at(k); i<bucket_off.at(k+1); ++i)
         {
-            segs.push_back(m.vert(vid1));
-            segs.push_back(m.vert(vid2));
+            uint tid = bucket.at(i);
+            Seg  s   = { 0, 0, tri_pid.at(tid) };
+            for(uint j=0; j<3; ++j)
+            {
+                uint v0 = tris.at(3*tid+j);
+                uint v1 = tris.at(3*tid+(j+1)%3);
+                bool above0 = (f(v0) >= iso);
+                bool above1 = (f(v1) >= iso);
+                // orient the segment from the edge going down to the edge going up,
+                // which leaves the above region on the left
+                if( above0 && !above1) s.from = key(v0,v1); else
+                if(!above0 &&  above1) s.to   = key(v0,v1);
+            }
+            segments.push_back(s);
         }
-        else if (through_v2 && through_v0) // 3) the curve coincides with (v2,v0)
+
+        std::unordered_map<uint64_t,uint> outgoing;
+        std::unordered_map<uint64_t,uint> incoming;
+        outgoing.reserve(segments.size());
+        incoming.reserve(segments.size());
+        for(uint sid=0; sid<segments.size(); ++sid)
         {
-            segs.push_back(m.vert(vid2));
-            segs.push_back(m.vert(vid0));
+            outgoing.insert(std::make_pair(segments.at(sid).from, sid)); // keeps the first, if non manifold
+            incoming.insert(std::make_pair(segments.at(sid).to,   sid));
         }
-        else if (crosses_v0_v1 && crosses_v1_v2) // case 4) the curve enters from (v0,v1) and exits from (v0,v2)
+
+        auto add_point = [&](Polyline & pl, const uint64_t node)
         {
-            //float alpha0 = std::fabs(iso_value - f0)/fabs(f1 - f0),alpha1 = std::fabs(iso_value - f1)/fabs(f2 - f1);
-            segs.push_back((1.0-alpha0)*m.vert(vid0) + alpha0*m.vert(vid1));
-            segs.push_back((1.0-alpha1)*m.vert(vid1) + alpha1*m.vert(vid2));
+            uint   v0    = node >> 32;
+            uint   v1    = node & 0xffffffff;
+            double alpha = (iso - f(v0))/(f(v1) - f(v0));
+            pl.points.push_back((1.0-alpha)*m.vert(v0) + alpha*m.vert(v1));
+            pl.edges.push_back(m.edge_id(v0,v1));
+        };
+
+        std::vector<bool> visited(segments.size(), false);
+        auto trace = [&](uint sid)
+        {
+            Polyline pl;
+            pl.iso_value = iso_values.at(order.at(k));
+            pl.closed    = false;
+            uint64_t start = segments.at(sid).from;
+            add_point(pl, start);
+            while(true)
+            {
+                visited.at(sid) = true;
+                pl.polys.push_back(segments.at(sid).pid);
+                uint64_t node = segments.at(sid).to;
+                if(node==start) { pl.closed = true; break; }
+                add_point(pl, node);
+                auto it = outgoing.find(node);
+                if(it==outgoing.end() || visited.at(it->second)) break;
+                sid = it->second;
+            }
+            iso_curves.at(k).push_back(pl);
+        };
+
+        // open curves start where no segment comes in. Whatever remains is closed
+        for(uint sid=0; sid<segments.size(); ++sid)
+        {
+            if(!visited.at(sid) && incoming.find(segments.at(sid).from)==incoming.end()) trace(sid);
         }
-        else if (crosses_v0_v1 && crosses_v2_v0) // case 5) the curve enters from (v0,v1) and exits from (v1,v2)
+        for(uint sid=0; sid<segments.size(); ++sid)
         {
-            //float alpha0 = std::fabs(iso_value - f0)/fabs(f1 - f0),alpha1 = std::fabs(iso_value - f2)/fabs(f0 - f2);
-            segs.push_back((1.0-alpha0)*m.vert(vid0) + alpha0*m.vert(vid1));
-            segs.push_back((1.0-alpha3)*m.vert(vid2) + alpha3*m.vert(vid0));
+            if(!visited.at(sid)) trace(sid);
         }
-        else if (crosses_v1_v2 && crosses_v2_v0) // 6) the curve enters from (v1,v2) and exits from (v2,v0)
+    });
+
+    // gather results following the input order of iso values
+    std::vector<uint> rank(n_iso);
+    for(uint i=0; i<n_iso; ++i) rank.at(order.at(i)) = i;
+    for(uint i=0; i<n_iso; ++i)
+    {
+        std::vector<Polyline> & c = iso_curves.at(rank.at(i));
+        std::move(c.begin(), c.end(), std::back_inserter(curves));
+    }
+
+    for(const Polyline & pl : curves)
+    {
+        for(uint i=0; i<pl.polys.size(); ++i)
         {
-            //float alpha0 = std::fabs(iso_value - f1)/fabs(f2 - f1),alpha1 = std::fabs(iso_value - f2)/fabs(f0 - f2);
-            segs.push_back((1.0-alpha1)*m.vert(vid1) + alpha1*m.vert(vid2));
-            segs.push_back((1.0-alpha3)*m.vert(vid2) + alpha3*m.vert(vid0));
+            segs.push_back(pl.points.at(i));
+            segs.push_back(pl.points.at((i+1)%pl.points.size()));
         }
     }
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 std::vector<uint> Isocontour<M,V,E,P>::tessellate(Trimesh<M,V,E,P> & m) const
 {
-    typedef std::pair<uint,float> split_data;
-    std::set<split_data,std::greater<split_data>> edges_to_split; // from highest to lowest id
-
-    for(uint eid=0; eid<m.num_edges(); ++eid)
+    std::vector<uint> new_vids;
+    for(float iso_value : iso_values)
     {
-        float f0 = m.vert_data(m.edge_vert_id(eid,0)).uvw[0],f1 = m.vert_data(m.edge_vert_id(eid,1)).uvw[0];
-       
-        if (is_into_interval<float>(iso_value, f0, f1))
+        typedef std::pair<uint,float> split_data;
+        std::set<split_data,std::greater<split_data>> edges_to_split; // from highest to lowest id
+
+        for(uint eid=0; eid<m.num_edges(); ++eid)
         {
-            float alpha = std::fabs(iso_value - f0)/fabs(f1 - f0);
-            edges_to_split.insert(std::make_pair(eid,alpha));
+            float f0 = m.vert_data(m.edge_vert_id(eid,0)).uvw[0],f1 = m.vert_data(m.edge_vert_id(eid,1)).uvw[0];
+
+            if (is_into_interval<float>(iso_value, f0, f1))
+            {
+                float alpha = std::fabs(iso_value - f0)/fabs(f1 - f0);
+                edges_to_split.insert(std::make_pair(eid,alpha));
+            }
         }
-    }
 
-    std::vector<uint> new_vids;
-    for(auto e : edges_to_split)
-    {
-        uint vid = m.edge_split(e.first, e.second);
-        m.vert_data(vid).uvw[0] = iso_value;
-        new_vids.push_back(vid);
+        for(auto e : edges_to_split)
+        {
+            uint vid = m.edge_split(e.first, e.second);
+            m.vert_data(vid).uvw[0] = iso_value;
+            new_vids.push_back(vid);
+        }
     }
-
     return new_vids;
 }
+
 }
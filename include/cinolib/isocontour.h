@@ -51,15 +51,35 @@ class Isocontour
 {
     public:
 
+        // A connected piece of iso-contour. Points are ordered along the curve,
+        // which is oriented so that the region where the field is above the iso
+        // value lies on its left. Each point lies on a mesh edge (edges[i]), or
+        // on the internal diagonal of a non triangular poly (edges[i] = -1).
+        // Segment (points[i],points[i+1]) runs within poly polys[i]. For closed
+        // curves the last segment connects the last point back to the first one.
+        //
+        struct Polyline
+        {
+            float              iso_value;
+            bool               closed;
+            std::vector<vec3d> points;
+            std::vector<int>   edges;
+            std::vector<uint>  polys;
+        };
+
         explicit Isocontour();
         explicit Isocontour(AbstractPolygonMesh<M,V,E,P> & m, float iso_value);
+        explicit Isocontour(AbstractPolygonMesh<M,V,E,P> & m, const std::vector<float> & iso_values);
 
         std::vector<uint> tessellate(Trimesh<M,V,E,P> & m) const;
 
+        const std::vector<Polyline> & polylines() const { return curves; }
+
     protected:
 
-        float              iso_value;
-        std::vector<vec3d> segs;
+        std::vector<float>    iso_values;
+        std::vector<vec3d>    segs;
+        std::vector<Polyline> curves;
 };
 
 }
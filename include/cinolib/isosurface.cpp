@@ -46,11 +46,31 @@ CINO_INLINE
 Isosurface<M,V,E,F,P>::Isosurface(const Tetmesh<M,V,E,F,P> & m,
                                   const float               iso_value,
                                   const bool                 run_marching_tets)
-    : iso_value(iso_value)
+    : iso_values(1,iso_value)
 {
     if(run_marching_tets) marching_tets(m, iso_value, verts, tris, norms);
 }
 
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+Isosurface<M,V,E,F,P>::Isosurface(const Tetmesh<M,V,E,F,P> & m,
+                                  const std::vector<float> & iso_values)
+    : iso_values(iso_values)
+{
+    std::vector<std::vector<vec3d>> all_verts;
+    std::vector<std::vector<uint>>  all_tris;
+    std::vector<std::vector<vec3d>> all_norms;
+    marching_tets(m, iso_values, all_verts, all_tris, all_norms);
+
+    for(uint i=0; i<iso_values.size(); ++i)
+    {
+        uint base = verts.size();
+        for(uint vid : all_tris.at(i)) tris.push_back(base + vid);
+        verts.insert(verts.end(), all_verts.at(i).begin(), all_verts.at(i).end());
+        norms.insert(norms.end(), all_norms.at(i).begin(), all_norms.at(i).end());
+    }
+}
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 Trimesh<M,V,E,F> Isosurface<M,V,E,F,P>::export_as_trimesh() const
@@ -62,28 +82,30 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 std::vector<uint> Isosurface<M,V,E,F,P>::tessellate(Tetmesh<M,V,E,F,P> & m) const
 {
-    typedef std::pair<uint,float> split_data;
-    std::set<split_data,std::greater<split_data>> edges_to_split; // from highest to lowest id
-
-    for(uint eid=0; eid<m.num_edges(); ++eid)
+    std::vector<uint> new_vids;
+    for(float iso_value : iso_values)
     {
-        float f0 = m.vert_data(m.edge_vert_id(eid,0)).uvw[0],f1 = m.vert_data(m.edge_vert_id(eid,1)).uvw[0];
-        
-        if (is_into_interval<float>(iso_value, f0, f1))
+        typedef std::pair<uint,float> split_data;
+        std::set<split_data,std::greater<split_data>> edges_to_split; // from highest to lowest id
+
+        for(uint eid=0; eid<m.num_edges(); ++eid)
         {
-            float alpha = std::fabs(iso_value - f0)/fabs(f1 - f0);
-            edges_to_split.insert(std::make_pair(eid,alpha));
+            float f0 = m.vert_data(m.edge_vert_id(eid,0)).uvw[0],f1 = m.vert_data(m.edge_vert_id(eid,1)).uvw[0];
+
+            if (is_into_interval<float>(iso_value, f0, f1))
+            {
+                float alpha = std::fabs(iso_value - f0)/fabs(f1 - f0);
+                edges_to_split.insert(std::make_pair(eid,alpha));
+            }
         }
-    }
 
-    std::vector<uint> new_vids;
-    for(auto e : edges_to_split)
-    {
-        uint vid = m.edge_split(e.first, e.second);
-        m.vert_data(vid).uvw[0] = iso_value;
-        new_vids.push_back(vid);
+        for(auto e : edges_to_split)
+        {
+            uint vid = m.edge_split(e.first, e.second);
+            m.vert_data(vid).uvw[0] = iso_value;
+            new_vids.push_back(vid);
+        }
     }
-
     return new_vids;
 }
 }
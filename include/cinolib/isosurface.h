@@ -59,13 +59,17 @@ class Isosurface
                             const float                iso_value,
                             const bool                 run_marching_tets = true);
 
+        // many iso-surfaces extracted in one pass, and merged into a single surface
+        explicit Isosurface(const Tetmesh<M,V,E,F,P> & m,
+                            const std::vector<float> & iso_values);
+
         
         Trimesh<M,V,E,F> export_as_trimesh() const;
 
         std::vector<uint> tessellate(Tetmesh<M,V,E,F,P> & m) const;
 
        
-        float              iso_value;
+        std::vector<float> iso_values;
         std::vector<vec3d> verts;
         std::vector<uint>  tris;
         std::vector<vec3d> norms;
@@ -0,0 +1,268 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/kd_tree.h>
+#include <cinolib/min_max_inf.h>
+#include <algorithm>
+
+namespace cinolib
+{
+
+CINO_INLINE
+void KdTree::build(const std::vector<vec3d> & points)
+{
+    std::vector<std::pair<vec3d,uint>> items(points.size());
+    for(uint i=0; i<points.size(); ++i) items[i] = std::make_pair(points[i],i);
+
+    axis.assign(points.size(), 0);
+    build(items, 0, items.size());
+
+    pts.resize(items.size());
+    ids.resize(items.size());
+    for(uint i=0; i<items.size(); ++i)
+    {
+        pts[i] = items[i].first;
+        ids[i] = items[i].second;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void KdTree::build(std::vector<std::pair<vec3d,uint>> & items, const uint beg, const uint end)
+{
+    if(end-beg <= points_per_leaf) return;
+
+    // split along the axis of maximum extent
+    vec3d min( inf_double,  inf_double,  inf_double);
+    vec3d max(-inf_double, -inf_double, -inf_double);
+    for(uint i=beg; i<end; ++i)
+    {
+        min = min.min(items[i].first);
+        max = max.max(items[i].first);
+    }
+    vec3d delta = max - min;
+    char  a     = (delta.x()>=delta.y() && delta.x()>=delta.z()) ? 0 : ((delta.y()>=delta.z()) ? 1 : 2);
+
+    // partition around the median
+    uint mid = beg + (end-beg)/2;
+    std::nth_element(items.begin()+beg, items.begin()+mid, items.begin()+end,
+                     [a](const std::pair<vec3d,uint> & i, const std::pair<vec3d,uint> & j)
+    {
+        return i.first[a] < j.first[a];
+    });
+    axis[mid] = a;
+
+    build(items, beg, mid);
+    build(items, mid+1, end);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void KdTree::clear()
+{
+    pts.clear();
+    ids.clear();
+    axis.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+int KdTree::nearest(const vec3d & p) const
+{
+    return nearest(p, [](const uint){ return false; });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Skip>
+CINO_INLINE
+int KdTree::nearest(const vec3d & p, const Skip & skip) const
+{
+    int    best_id   = -1;
+    double best_dist = inf_double;
+    nearest(0, pts.size(), p, skip, best_id, best_dist);
+    return best_id;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Skip>
+CINO_INLINE
+void KdTree::nearest(const uint     beg,
+                     const uint     end,
+                     const vec3d  & p,
+                     const Skip   & skip,
+                           int    & best_id,
+                           double & best_dist) const // squared
+{
+    auto test = [&](const uint i)
+    {
+        if(skip(ids[i])) return;
+        double d = p.dist_squared(pts[i]);
+        if(d<best_dist || (d==best_dist && (int)ids[i]<best_id))
+        {
+            best_dist = d;
+            best_id   = ids[i];
+        }
+    };
+
+    if(end-beg <= points_per_leaf)
+    {
+        for(uint i=beg; i<end; ++i) test(i);
+        return;
+    }
+
+    uint   mid  = beg + (end-beg)/2;
+    char   a    = axis[mid];
+    double diff = p[a] - pts[mid][a];
+
+    // visit the half space containing p first, then the median,
+    // then the other half space only if it may contain a closer point
+    if(diff<0)
+    {
+        nearest(beg, mid, p, skip, best_id, best_dist);
+        test(mid);
+        if(diff*diff <= best_dist) nearest(mid+1, end, p, skip, best_id, best_dist);
+    }
+    else
+    {
+        nearest(mid+1, end, p, skip, best_id, best_dist);
+        test(mid);
+        if(diff*diff <= best_dist) nearest(beg, mid, p, skip, best_id, best_dist);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void KdTree::k_nearest(const vec3d & p, const uint k, std::vector<uint> & res) const
+{
+    // max heap of the best k candidates found so far (squared distance, id)
+    std::vector<std::pair<double,uint>> heap;
+    heap.reserve(k+1);
+    if(k>0) k_nearest(0, pts.size(), p, k, heap);
+
+    std::sort_heap(heap.begin(), heap.end());
+    res.clear();
+    for(auto item : heap) res.push_back(item.second);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void KdTree::k_nearest(const uint                                 beg,
+                       const uint                                 end,
+                       const vec3d                              & p,
+                       const uint                                 k,
+                             std::vector<std::pair<double,uint>> & heap) const
+{
+    auto test = [&](const uint i)
+    {
+        std::pair<double,uint> item(p.dist_squared(pts[i]), ids[i]);
+        if(heap.size()<k)
+        {
+            heap.push_back(item);
+            std::push_heap(heap.begin(), heap.end());
+        }
+        else if(item < heap.front())
+        {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = item;
+            std::push_heap(heap.begin(), heap.end());
+        }
+    };
+    auto worst = [&]() { return (heap.size()<k) ? inf_double : heap.front().first; };
+
+    if(end-beg <= points_per_leaf)
+    {
+        for(uint i=beg; i<end; ++i) test(i);
+        return;
+    }
+
+    uint   mid  = beg + (end-beg)/2;
+    char   a    = axis[mid];
+    double diff = p[a] - pts[mid][a];
+
+    if(diff<0)
+    {
+        k_nearest(beg, mid, p, k, heap);
+        test(mid);
+        if(diff*diff <= worst()) k_nearest(mid+1, end, p, k, heap);
+    }
+    else
+    {
+        k_nearest(mid+1, end, p, k, heap);
+        test(mid);
+        if(diff*diff <= worst()) k_nearest(beg, mid, p, k, heap);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void KdTree::radius_search(const vec3d & p, const double radius, std::vector<uint> & res) const
+{
+    res.clear();
+    radius_search(0, pts.size(), p, radius*radius, res);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void KdTree::radius_search(const uint                beg,
+                           const uint                end,
+                           const vec3d             & p,
+                           const double              sq_radius,
+                                 std::vector<uint> & res) const
+{
+    if(end-beg <= points_per_leaf)
+    {
+        for(uint i=beg; i<end; ++i) if(p.dist_squared(pts[i]) <= sq_radius) res.push_back(ids[i]);
+        return;
+    }
+
+    uint   mid  = beg + (end-beg)/2;
+    char   a    = axis[mid];
+    double diff = p[a] - pts[mid][a];
+
+    if(p.dist_squared(pts[mid]) <= sq_radius) res.push_back(ids[mid]);
+    if(diff< 0 || diff*diff <= sq_radius) radius_search(beg, mid, p, sq_radius, res);
+    if(diff>=0 || diff*diff <= sq_radius) radius_search(mid+1, end, p, sq_radius, res);
+}
+
+}
@@ -0,0 +1,126 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_KD_TREE_H
+#define CINO_KD_TREE_H
+
+#include <vector>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec3.h>
+
+namespace cinolib
+{
+
+/* Static, balanced kd-tree for nearest neighbor queries on a set of points.
+ * The tree is implicit: points are stored in a single array, which is
+ * recursively partitioned around the median of the largest axis, hence
+ * no node is explicitly allocated. Building costs O(n log n) and queries
+ * cost O(log n) on average.
+ *
+ * Usage:
+ *
+ *  i)  Build the tree from a list of points. Point ids are their position in the list
+ *  ii) Query nearest(p) to get the id of the point closest to p, k_nearest(p,k)
+ *      to get the ids of the k points closest to p, or radius_search(p,r)
+ *      to get the ids of all the points within distance r from p
+*/
+
+class KdTree
+{
+    public:
+
+        explicit KdTree(const uint points_per_leaf = 8) : points_per_leaf(points_per_leaf) {}
+
+        void build(const std::vector<vec3d> & points);
+        void clear();
+
+        bool empty() const { return pts.empty(); }
+        uint size()  const { return pts.size();  }
+
+        // QUERIES :::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // returns the id of the point closest to p (-1 if the tree is empty).
+        // Ties are broken in favor of the smallest id
+        int nearest(const vec3d & p) const;
+
+        // same as above, but points for which skip(id) returns true are ignored
+        // (e.g. to avoid picking hidden elements without rebuilding the tree)
+        template<class Skip>
+        int nearest(const vec3d & p, const Skip & skip) const;
+
+        // ids of the k points closest to p, sorted by increasing distance
+        void k_nearest(const vec3d & p, const uint k, std::vector<uint> & res) const;
+
+        // ids of all the points at distance <= radius from p (in no particular order)
+        void radius_search(const vec3d & p, const double radius, std::vector<uint> & res) const;
+
+    protected:
+
+        void build(std::vector<std::pair<vec3d,uint>> & items, const uint beg, const uint end);
+
+        template<class Skip>
+        void nearest(const uint    beg,
+                     const uint    end,
+                     const vec3d & p,
+                     const Skip  & skip,
+                           int   & best_id,
+                           double & best_dist) const;
+
+        void k_nearest(const uint                                 beg,
+                       const uint                                 end,
+                       const vec3d                              & p,
+                       const uint                                 k,
+                             std::vector<std::pair<double,uint>> & heap) const;
+
+        void radius_search(const uint                beg,
+                           const uint                end,
+                           const vec3d             & p,
+                           const double              sq_radius,
+                                 std::vector<uint> & res) const;
+
+        std::vector<vec3d> pts;  // points, in tree order
+        std::vector<uint>  ids;  // ids of the points, in tree order
+        std::vector<char>  axis; // split axis of the node whose median is at position i
+        uint points_per_leaf;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "kd_tree.cpp"
+#endif
+
+#endif // CINO_KD_TREE_H
@@ -47,9 +47,9 @@ typedef Eigen::Triplet<double> Entry;
 
 template<class M, class V, class E, class P>
 CINO_INLINE
-Eigen::SparseMatrix<float> laplacian(const AbstractMesh<M,V,E,P> & m,
-                                      const short mode,   // modes: UNIFORM | COTANGENT
-                                      const short n = 1); // diagonally replicate laplacian matrix n times:
+Eigen::SparseMatrix<double> laplacian(const AbstractMesh<M,V,E,P> & m,
+                                      const int mode,     // modes: UNIFORM | COTANGENT
+                                      const int n = 1);   // diagonally replicate laplacian matrix n times:
                                                         //
                                                         //  n=1      n=2        n=3
                                                         //  | L |   | L 0 |   | L 0 0 |
@@ -58,9 +58,9 @@ Eigen::SparseMatrix<float> laplacian(const AbstractMesh<M,V,E,P> & m,
 
 template<class M, class V, class E, class P>
 CINO_INLINE
-std::vector<Eigen::Triplet<float>> laplacian_matrix_entries(const AbstractMesh<M,V,E,P> & m,
-                                                             const short mode,
-                                                             const short n);
+std::vector<Eigen::Triplet<double>> laplacian_matrix_entries(const AbstractMesh<M,V,E,P> & m,
+                                                             const int mode,
+                                                             const int n);
 }
 
 #ifndef  CINO_STATIC_LIB
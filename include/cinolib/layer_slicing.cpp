@@ -0,0 +1,255 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/layer_slicing.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/geometry/polygon_utils.h>
+#include <cinolib/min_max_inf.h>
+#include <unordered_map>
+#include <algorithm>
+#include <thread>
+
+namespace cinolib
+{
+
+// Chains the segments of a layer into closed loops. Each segment goes
+// from one crossed edge to another, and loops that do not close are
+// discarded (they may only appear if the mesh is not watertight)
+//
+CINO_INLINE
+void layer_loops(const std::vector<uint>                   & seg_from,
+                 const std::vector<uint>                   & seg_to,
+                       std::vector<std::vector<uint>>      & loops)
+{
+    std::unordered_map<uint,uint> outgoing;
+    outgoing.reserve(seg_from.size());
+    for(uint sid=0; sid<seg_from.size(); ++sid) outgoing[seg_from.at(sid)] = sid;
+
+    std::vector<bool> visited(seg_from.size(), false);
+    for(uint start=0; start<seg_from.size(); ++start)
+    {
+        if(visited.at(start)) continue;
+
+        std::vector<uint> loop;
+        uint sid   = start;
+        bool valid = false;
+        while(!visited.at(sid))
+        {
+            visited.at(sid) = true;
+            loop.push_back(seg_from.at(sid));
+            if(seg_to.at(sid) == seg_from.at(start)) { valid = true; break; }
+            auto it = outgoing.find(seg_to.at(sid));
+            if(it == outgoing.end()) break;
+            sid = it->second;
+        }
+        if(valid) loops.push_back(loop);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// even-odd point in polygon test
+//
+CINO_INLINE
+bool layer_loop_contains(const std::vector<vec2d> & loop, const vec2d & p)
+{
+    bool inside = false;
+    for(uint i=0, j=loop.size()-1; i<loop.size(); j=i++)
+    {
+        const vec2d & a = loop.at(i);
+        const vec2d & b = loop.at(j);
+        if((a.y() > p.y()) != (b.y() > p.y()))
+        {
+            double x = a.x() + (p.y()-a.y())*(b.x()-a.x())/(b.y()-a.y());
+            if(p.x() < x) inside = !inside;
+        }
+    }
+    return inside;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void slice_into_layers(const Trimesh<M,V,E,P>                       & m,
+                       const std::vector<double>                    & z,
+                       std::vector<std::vector<std::vector<vec3d>>> & internal_polylines,  // inner holes
+                       std::vector<std::vector<std::vector<vec3d>>> & external_polylines)  // outer slice boundary
+{
+    assert(std::is_sorted(z.begin(), z.end()));
+
+    uint n_layers = z.size();
+    internal_polylines.assign(n_layers, std::vector<std::vector<vec3d>>());
+    external_polylines.assign(n_layers, std::vector<std::vector<vec3d>>());
+    if(n_layers==0) return;
+    m.adjacency_require(ADJ_EDGES); // layers are swept in parallel, and query edge ids
+
+    // sort triangles by the lower end of their z-extent
+    std::vector<double> t_min(m.num_polys()), t_max(m.num_polys());
+    PARALLEL_FOR(0, m.num_polys(), 1000, [&](const uint pid)
+    {
+        double z0 = m.poly_vert(pid,0).z();
+        double z1 = m.poly_vert(pid,1).z();
+        double z2 = m.poly_vert(pid,2).z();
+        t_min.at(pid) = std::min(z0, std::min(z1,z2));
+        t_max.at(pid) = std::max(z0, std::max(z1,z2));
+    });
+    std::vector<uint> order(m.num_polys());
+    for(uint pid=0; pid<m.num_polys(); ++pid) order.at(pid) = pid;
+    std::sort(order.begin(), order.end(), [&](uint i, uint j){ return t_min.at(i) < t_min.at(j); });
+
+    auto slice_layer = [&](const uint lid, const std::vector<uint> & active)
+    {
+        double zp = z.at(lid);
+
+        // each crossed triangle contributes one segment, connecting two crossed edges
+        std::vector<uint> seg_from, seg_to;
+        for(uint pid : active)
+        {
+            uint from = 0, to = 0;
+            bool crossed = false;
+            for(uint i=0; i<3; ++i)
+            {
+                uint v0 = m.poly_vert_id(pid,i);
+                uint v1 = m.poly_vert_id(pid,(i+1)%3);
+                bool above0 = (m.vert(v0).z() >= zp);
+                bool above1 = (m.vert(v1).z() >= zp);
+                if( above0 && !above1) { from = m.poly_edge_id(pid,v0,v1); crossed = true; }
+                if(!above0 &&  above1) { to   = m.poly_edge_id(pid,v0,v1); }
+            }
+            if(!crossed) continue;
+            seg_from.push_back(from);
+            seg_to.push_back(to);
+        }
+
+        std::vector<std::vector<uint>> loops;
+        layer_loops(seg_from, seg_to, loops);
+
+        // convert loops of edge ids into loops of points
+        std::vector<std::vector<vec2d>> loops2d;
+        for(const auto & loop : loops)
+        {
+            std::vector<vec2d> pts;
+            for(uint eid : loop)
+            {
+                vec3d  a     = m.edge_vert(eid,0);
+                vec3d  b     = m.edge_vert(eid,1);
+                double alpha = (zp - a.z())/(b.z() - a.z());
+                vec3d  p     = a + alpha*(b-a);
+                vec2d  p2d(p.x(), p.y());
+                if(pts.empty() || !(pts.back() == p2d)) pts.push_back(p2d); // the plane may pass through a vertex
+            }
+            while(pts.size()>1 && pts.back() == pts.front()) pts.pop_back();
+            if(pts.size()>2) loops2d.push_back(pts);
+        }
+
+        // classify loops by nesting depth, and orient them accordingly
+        std::vector<vec2d> bb_min(loops2d.size(), vec2d( inf_double,  inf_double));
+        std::vector<vec2d> bb_max(loops2d.size(), vec2d(-inf_double, -inf_double));
+        for(uint i=0; i<loops2d.size(); ++i)
+        for(const vec2d & p : loops2d.at(i))
+        {
+            bb_min.at(i) = bb_min.at(i).min(p);
+            bb_max.at(i) = bb_max.at(i).max(p);
+        }
+        for(uint i=0; i<loops2d.size(); ++i)
+        {
+            const vec2d & p = loops2d.at(i).front();
+            uint depth = 0;
+            for(uint j=0; j<loops2d.size(); ++j)
+            {
+                if(i==j) continue;
+                if(p.x() < bb_min.at(j).x() || p.x() > bb_max.at(j).x() ||
+                   p.y() < bb_min.at(j).y() || p.y() > bb_max.at(j).y()) continue;
+                if(layer_loop_contains(loops2d.at(j), p)) ++depth;
+            }
+
+            bool is_hole = (depth%2==1);
+            bool is_CCW  = polygon_is_CCW(loops2d.at(i));
+            if(is_hole == is_CCW) std::reverse(loops2d.at(i).begin(), loops2d.at(i).end());
+
+            std::vector<vec3d> loop;
+            for(const vec2d & p : loops2d.at(i)) loop.push_back(vec3d(p.x(), p.y(), zp));
+            if(is_hole) internal_polylines.at(lid).push_back(loop);
+            else        external_polylines.at(lid).push_back(loop);
+        }
+    };
+
+    // split layers in contiguous chunks, and sweep each chunk independently
+    uint n_threads = std::max(1u, std::thread::hardware_concurrency());
+    uint n_chunks  = std::min(n_layers, 4*n_threads);
+    PARALLEL_FOR(0, n_chunks, 2, [&](const uint c)
+    {
+        uint beg = (c    *n_layers)/n_chunks;
+        uint end = ((c+1)*n_layers)/n_chunks;
+
+        std::vector<uint> active;
+        uint next = 0; // next triangle (in z order) to enter the active set
+        for(uint lid=beg; lid<end; ++lid)
+        {
+            double zp = z.at(lid);
+            while(next<order.size() && t_min.at(order.at(next)) <= zp)
+            {
+                active.push_back(order.at(next++));
+            }
+            active.erase(std::remove_if(active.begin(), active.end(), [&](uint pid){ return t_max.at(pid) < zp; }), active.end());
+            slice_layer(lid, active);
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void slice_into_layers(const Trimesh<M,V,E,P>                       & m,
+                       const double                                   layer_thickness,
+                       std::vector<double>                          & z,
+                       std::vector<std::vector<std::vector<vec3d>>> & internal_polylines,  // inner holes
+                       std::vector<std::vector<std::vector<vec3d>>> & external_polylines)  // outer slice boundary
+{
+    assert(layer_thickness > 0);
+
+    z.clear();
+    uint n_layers = std::ceil(m.bbox().delta_z()/layer_thickness);
+    for(uint i=0; i<n_layers; ++i)
+    {
+        double h = m.bbox().min.z() + (i+0.5)*layer_thickness;
+        if(h < m.bbox().max.z()) z.push_back(h);
+    }
+    slice_into_layers(m, z, internal_polylines, external_polylines);
+}
+
+}
@@ -0,0 +1,84 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_LAYER_SLICING_H
+#define CINO_LAYER_SLICING_H
+
+#include <vector>
+#include <cinolib/cino_inline.h>
+#include <cinolib/meshes/trimesh.h>
+
+namespace cinolib
+{
+
+/* Intersects a closed (and consistently oriented) triangle mesh with the
+ * horizontal planes z[0] < z[1] < ... < z[n-1], producing for each layer
+ * a set of closed loops. Loops are classified by nesting depth: loops at
+ * even depth are external boundaries (CCW), loops at odd depth are holes
+ * (CW). Output follows the same layout used by read_CLI and write_CLI.
+ *
+ * Triangles are sorted by their z-extent and swept bottom to top, keeping
+ * only the active ones (i.e. those spanning the current plane). Layers are
+ * split in contiguous chunks, each one swept by a separate thread.
+ *
+ * A vertex lying exactly on a plane is treated as if it were slightly above
+ * it, so that every crossed triangle generates exactly one segment.
+*/
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void slice_into_layers(const Trimesh<M,V,E,P>                       & m,
+                       const std::vector<double>                    & z,
+                       std::vector<std::vector<std::vector<vec3d>>> & internal_polylines,  // inner holes
+                       std::vector<std::vector<std::vector<vec3d>>> & external_polylines); // outer slice boundary
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// uniform layers of the given thickness, sampled at their mid height
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+void slice_into_layers(const Trimesh<M,V,E,P>                       & m,
+                       const double                                   layer_thickness,
+                       std::vector<double>                          & z,
+                       std::vector<std::vector<std::vector<vec3d>>> & internal_polylines,  // inner holes
+                       std::vector<std::vector<std::vector<vec3d>>> & external_polylines); // outer slice boundary
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "layer_slicing.cpp"
+#endif
+
+#endif // CINO_LAYER_SLICING_H
@@ -34,17 +34,14 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/linear_solvers.h>
-#include <cinolib/stl_container_utilities.h>
 
 namespace cinolib
 {
 
-typedef Eigen::Triplet<float> Entry;
-
 CINO_INLINE
-void solve_square_system(const Eigen::SparseMatrix<float> & A,
-                         const Eigen::VectorXd             & b,
-                               Eigen::VectorXd             & x,
+void solve_square_system(const Eigen::SparseMatrix<double> & A,
+                         const Eigen::VectorXd              & b,
+                               Eigen::VectorXd              & x,
                          short   solver)
 {
     assert(A.rows() == A.cols());
@@ -53,7 +50,7 @@ void solve_square_system(const Eigen::SparseMatrix<float> & A,
     {
         case SIMPLICIAL_LLT:
         {
-            Eigen::SimplicialLLT< Eigen::SparseMatrix<float> > solver(A);
+            Eigen::SimplicialLLT< Eigen::SparseMatrix<double> > solver(A);
             assert(solver.info() == Eigen::Success);
             x = solver.solve(b).eval();
             break;
@@ -61,7 +58,7 @@ void solve_square_system(const Eigen::SparseMatrix<float> & A,
 
         case SIMPLICIAL_LDLT:
         {
-            Eigen::SimplicialLDLT< Eigen::SparseMatrix<float> > solver(A);
+            Eigen::SimplicialLDLT< Eigen::SparseMatrix<double> > solver(A);
             assert(solver.info() == Eigen::Success);
             x = solver.solve(b).eval();
             break;
@@ -69,7 +66,7 @@ void solve_square_system(const Eigen::SparseMatrix<float> & A,
 
         case BiCGSTAB:
         {
-            Eigen::BiCGSTAB< Eigen::SparseMatrix<float> , Eigen::IncompleteLUT<float> > solver;
+            Eigen::BiCGSTAB< Eigen::SparseMatrix<double> , Eigen::IncompleteLUT<double> > solver;
             //solver.setMaxIterations(100);
             solver.setTolerance(1e-5);
             solver.compute(A);
@@ -80,9 +77,9 @@ void solve_square_system(const Eigen::SparseMatrix<float> & A,
 
         case SparseLU:
         {
-            Eigen::SparseMatrix<float> Ac = A;
+            Eigen::SparseMatrix<double> Ac = A;
             Ac.makeCompressed();
-            Eigen::SparseLU<Eigen::SparseMatrix<float>, Eigen::COLAMDOrdering<int> > solver;
+            Eigen::SparseLU<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int> > solver;
             solver.analyzePattern(Ac);
             solver.factorize(Ac);
             x = solver.solve(b);
@@ -93,121 +90,464 @@ void solve_square_system(const Eigen::SparseMatrix<float> & A,
     }
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
-void solve_square_system_with_bc(const Eigen::SparseMatrix<float> & A,
-                                 const Eigen::VectorXd             & b,
-                                       Eigen::VectorXd             & x,
-                                 const std::map<uint,float>       & bc, // Dirichlet boundary conditions
-                                 short   solver)
+void solve_square_system(const Eigen::SparseMatrix<double> & A,
+                         const Eigen::MatrixXd              & B,
+                               Eigen::MatrixXd              & X,
+                         short   solver)
 {
-    std::vector<int> col_map(A.rows(), -1);
-    uint fresh_id = 0;
+    assert(A.rows() == A.cols());
+    assert(A.rows() == B.rows());
+
+    // factorize once, then back substitute for each column of B
+    switch (solver)
+    {
+        case SIMPLICIAL_LLT:
+        {
+            Eigen::SimplicialLLT< Eigen::SparseMatrix<double> > solver(A);
+            assert(solver.info() == Eigen::Success);
+            X = solver.solve(B).eval();
+            break;
+        }
+
+        case SIMPLICIAL_LDLT:
+        {
+            Eigen::SimplicialLDLT< Eigen::SparseMatrix<double> > solver(A);
+            assert(solver.info() == Eigen::Success);
+            X = solver.solve(B).eval();
+            break;
+        }
+
+        case BiCGSTAB:
+        {
+            Eigen::BiCGSTAB< Eigen::SparseMatrix<double> , Eigen::IncompleteLUT<double> > solver;
+            solver.setTolerance(1e-5);
+            solver.compute(A);
+            assert(solver.info() == Eigen::Success);
+            X = solver.solve(B).eval();
+            break;
+        }
+
+        case SparseLU:
+        {
+            Eigen::SparseMatrix<double> Ac = A;
+            Ac.makeCompressed();
+            Eigen::SparseLU<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int> > solver;
+            solver.analyzePattern(Ac);
+            solver.factorize(Ac);
+            X = solver.solve(B);
+            break;
+        }
+
+        default: assert(false && "Unknown Solver");
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+DirichletSolver::DirichletSolver(const Eigen::SparseMatrix<double> & A,
+                                 const std::vector<uint>           & bc_ids,
+                                 const short                         solver)
+{
+    init(A, bc_ids, solver);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void DirichletSolver::init(const Eigen::SparseMatrix<double> & A,
+                           const std::vector<uint>           & bc_ids,
+                           const short                         solver)
+{
+    assert(A.rows() == A.cols());
+    assert(solver == SIMPLICIAL_LLT || solver == SIMPLICIAL_LDLT || solver == SparseLU || solver == BiCGSTAB);
+
+    this->solver = solver;
+
+    // free/fixed split
+    col_map.assign(A.cols(), 0);
+    fixed_ids = bc_ids;
+    for(uint i=0; i<fixed_ids.size(); ++i)
+    {
+        assert(col_map.at(fixed_ids.at(i)) == 0 && "duplicated boundary condition");
+        col_map.at(fixed_ids.at(i)) = -int(i)-1;
+    }
+    free_ids.clear();
+    free_ids.reserve(A.cols() - fixed_ids.size());
     for(uint col=0; col<A.cols(); ++col)
     {
-        if (DOES_NOT_CONTAIN(bc, col))
-            col_map[col] = fresh_id++;
+        if(col_map[col] < 0) continue;
+        col_map[col] = free_ids.size();
+        free_ids.push_back(col);
     }
 
-    uint size = A.rows() - bc.size();
+    // reduced sparsity pattern. Since col_map preserves the ordering of free variables,
+    // the free/free block is filled column by column with sorted rows (i.e. in storage order)
+    Eigen::VectorXi ff_nnz = Eigen::VectorXi::Zero(free_ids.size());
+    Eigen::VectorXi fc_nnz = Eigen::VectorXi::Zero(fixed_ids.size());
+    for(uint col=0; col<A.outerSize(); ++col)
+    for(Eigen::SparseMatrix<double>::InnerIterator it(A,col); it; ++it)
+    {
+        if(col_map[it.row()] < 0) continue;
+        if(col_map[col] >= 0) ++ff_nnz[ col_map[col]];
+        else                  ++fc_nnz[-col_map[col]-1];
+    }
+    Aff.resize(free_ids.size(), free_ids.size());
+    Afc.resize(free_ids.size(), fixed_ids.size());
+    Aff.reserve(ff_nnz);
+    Afc.reserve(fc_nnz);
+    for(uint col=0; col<A.outerSize(); ++col)
+    for(Eigen::SparseMatrix<double>::InnerIterator it(A,col); it; ++it)
+    {
+        int row = col_map[it.row()];
+        if(row < 0) continue;
+        if(col_map[col] >= 0) Aff.insert(row, col_map[col])    = it.value();
+        else                  Afc.insert(row,-col_map[col]-1) = it.value();
+    }
+    Aff.makeCompressed();
+    Afc.makeCompressed();
 
-    std::vector<Entry> Aprime_entries;
-    Eigen::VectorXd    bprime(size);
+    // where each non zero of A goes, to update values without rebuilding the pattern
+    nz_map.clear();
+    nz_map.reserve(A.nonZeros());
+    int ff_count = 0;
+    for(uint col=0; col<A.outerSize(); ++col)
+    for(Eigen::SparseMatrix<double>::InnerIterator it(A,col); it; ++it)
+    {
+        int row = col_map[it.row()];
+        if(row < 0)                nz_map.push_back(-1);
+        else if(col_map[col] >= 0) nz_map.push_back(ff_count++);
+        else                       nz_map.push_back(-int(&Afc.coeffRef(row,-col_map[col]-1) - Afc.valuePtr())-2);
+    }
 
-    for(uint row=0; row<A.rows(); ++row)
+    // symbolic factorization (done only once)
+    switch(solver)
     {
-        if (col_map[row] >= 0)
-            bprime[ col_map[row] ] = b[row];
+        case SIMPLICIAL_LLT:  llt.analyzePattern(Aff);  break;
+        case SIMPLICIAL_LDLT: ldlt.analyzePattern(Aff); break;
+        case SparseLU:        lu.analyzePattern(Aff);   break;
+        case BiCGSTAB:        bicgstab.setTolerance(1e-5); break;
+        default: assert(false && "Unknown Solver");
     }
 
-    //
-    // iterate over the non-zero entries
-    // of sparse matrix A
-    //
-    for (uint i=0; i<A.outerSize(); ++i)
+    factorize();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void DirichletSolver::update_matrix(const Eigen::SparseMatrix<double> & A)
+{
+    assert(A.rows() == (int)num_vars() && A.cols() == (int)num_vars());
+    assert(A.nonZeros() == (int)nz_map.size() && "sparsity pattern changed");
+
+    double *ff_vals = Aff.valuePtr();
+    double *fc_vals = Afc.valuePtr();
+    uint k = 0;
+    for(uint col=0; col<A.outerSize(); ++col)
+    for(Eigen::SparseMatrix<double>::InnerIterator it(A,col); it; ++it, ++k)
+    {
+        int dst = nz_map[k];
+        if(dst >= 0)       ff_vals[dst]    = it.value();
+        else if(dst < -1)  fc_vals[-dst-2] = it.value();
+    }
+
+    factorize();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void DirichletSolver::factorize()
+{
+    if(free_ids.empty()) { ok = true; return; } // everything is fixed
+
+    switch(solver)
     {
-        for (Eigen::SparseMatrix<float>::InnerIterator it(A,i); it; ++it)
+        case SIMPLICIAL_LLT:  llt.factorize(Aff);  ok = (llt.info()      == Eigen::Success); break;
+        case SIMPLICIAL_LDLT: ldlt.factorize(Aff); ok = (ldlt.info()     == Eigen::Success); break;
+        case SparseLU:        lu.factorize(Aff);   ok = (lu.info()       == Eigen::Success); break;
+        case BiCGSTAB:        bicgstab.compute(Aff); ok = (bicgstab.info() == Eigen::Success); break;
+        default: assert(false && "Unknown Solver");
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void DirichletSolver::solve(const Eigen::MatrixXd & B,
+                            const Eigen::MatrixXd & bc_vals,
+                                  Eigen::MatrixXd & X) const
+{
+    assert(B.rows() == (int)num_vars());
+    assert(bc_vals.rows() == (int)num_fixed_vars());
+    assert(bc_vals.cols() == B.cols() || num_fixed_vars() == 0);
+
+    // move the fixed columns to the right hand side
+    Eigen::MatrixXd Bf(free_ids.size(), B.cols());
+    for(uint i=0; i<free_ids.size(); ++i) Bf.row(i) = B.row(free_ids[i]);
+    if(!fixed_ids.empty()) Bf -= Afc * bc_vals;
+
+    Eigen::MatrixXd Xf;
+    if(!free_ids.empty())
+    {
+        switch(solver)
         {
-            uint    row = it.row(),col = it.col();
-            double val = it.value();
+            case SIMPLICIAL_LLT:  Xf = llt.solve(Bf);      break;
+            case SIMPLICIAL_LDLT: Xf = ldlt.solve(Bf);     break;
+            case SparseLU:        Xf = lu.solve(Bf);       break;
+            case BiCGSTAB:        Xf = bicgstab.solve(Bf); break;
+            default: assert(false && "Unknown Solver");
+        }
+    }
+
+    X.resize(num_vars(), B.cols());
+    for(uint i=0; i<free_ids.size();  ++i) X.row(free_ids[i])  = Xf.row(i);
+    for(uint i=0; i<fixed_ids.size(); ++i) X.row(fixed_ids[i]) = bc_vals.row(i);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void DirichletSolver::solve(const Eigen::VectorXd & b,
+                            const Eigen::VectorXd & bc_vals,
+                                  Eigen::VectorXd & x) const
+{
+    Eigen::MatrixXd X;
+    solve(Eigen::MatrixXd(b), Eigen::MatrixXd(bc_vals), X);
+    x = X.col(0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void solve_square_system_with_bc(const Eigen::SparseMatrix<double> & A,
+                                 const Eigen::VectorXd              & b,
+                                       Eigen::VectorXd              & x,
+                                 const std::map<uint,double>        & bc, // Dirichlet boundary conditions
+                                 short   solver)
+{
+    std::vector<uint> bc_ids;
+    Eigen::VectorXd   bc_vals(bc.size());
+    bc_ids.reserve(bc.size());
+    for(auto obj : bc)
+    {
+        bc_vals[bc_ids.size()] = obj.second;
+        bc_ids.push_back(obj.first);
+    }
+
+    DirichletSolver ds(A, bc_ids, solver);
+    assert(ds.success());
+    ds.solve(b, bc_vals, x);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-            if (col_map[row] < 0) continue;
+CINO_INLINE
+void solve_square_system_with_bc(const Eigen::SparseMatrix<double>        & A,
+                                 const Eigen::MatrixXd                     & B,
+                                       Eigen::MatrixXd                     & X,
+                                 const std::map<uint,std::vector<double>> & bc, // Dirichlet boundary conditions
+                                 short   solver)
+{
+    std::vector<uint> bc_ids;
+    Eigen::MatrixXd   bc_vals(bc.size(), B.cols());
+    bc_ids.reserve(bc.size());
+    for(auto obj : bc)
+    {
+        assert(obj.second.size() == (uint)B.cols());
+        for(uint i=0; i<B.cols(); ++i) bc_vals(bc_ids.size(),i) = obj.second.at(i);
+        bc_ids.push_back(obj.first);
+    }
+
+    DirichletSolver ds(A, bc_ids, solver);
+    assert(ds.success());
+    ds.solve(B, bc_vals, X);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// solves min ||Ax-b|| directly on the rectangular matrix A (SparseQR and LSCG only)
+CINO_INLINE
+void solve_rectangular_least_squares(const Eigen::SparseMatrix<double> & A,
+                                     const Eigen::VectorXd              & b,
+                                           Eigen::VectorXd              & x,
+                                     short   solver)
+{
+    assert(A.rows() == b.rows());
+
+    switch (solver)
+    {
+        case SparseQR:
+        {
+            Eigen::SparseMatrix<double> Ac = A;
+            Ac.makeCompressed();
+            Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int> > solver;
+            solver.compute(Ac);
+            assert(solver.info() == Eigen::Success);
+            x = solver.solve(b);
+            break;
+        }
 
-            if (col_map[col] < 0)
-                bprime[ col_map[row] ] -= bc.at(col) * val;    
-            else    
-                Aprime_entries.push_back(Entry(col_map[row], col_map[col], val));
+        case LSCG:
+        {
+            Eigen::LeastSquaresConjugateGradient< Eigen::SparseMatrix<double> > solver;
+            solver.setTolerance(1e-8);
+            solver.compute(A);
+            assert(solver.info() == Eigen::Success);
+            x = solver.solve(b).eval();
+            break;
         }
+
+        default: assert(false && "Unknown Solver");
     }
+}
 
-    Eigen::SparseMatrix<float> Aprime(size, size);
-    Aprime.setFromTriplets(Aprime_entries.begin(), Aprime_entries.end());
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    Eigen::VectorXd tmp_x(size);
+// eliminates the constrained columns of A, then solves min ||Ax-b|| for the free variables
+CINO_INLINE
+void solve_rectangular_least_squares_with_bc(const Eigen::SparseMatrix<double> & A,
+                                             const Eigen::VectorXd              & b,
+                                                   Eigen::VectorXd              & x,
+                                             const std::map<uint,double>        & bc,
+                                             short   solver)
+{
+    std::vector<int> col_map(A.cols(), 0);
+    for(auto obj : bc) col_map.at(obj.first) = -1;
+    uint n_free = 0;
+    Eigen::VectorXi nnz_per_col(A.cols() - bc.size());
+    for(uint col=0; col<A.cols(); ++col)
+    {
+        if(col_map[col] < 0) continue;
+        nnz_per_col[n_free] = 0;
+        for(Eigen::SparseMatrix<double>::InnerIterator it(A,col); it; ++it) ++nnz_per_col[n_free];
+        col_map[col] = n_free++;
+    }
 
-    solve_square_system(Aprime, bprime, tmp_x, solver);
+    // A is column major: selecting its columns is a linear scan
+    Eigen::SparseMatrix<double> Af(A.rows(), n_free);
+    Af.reserve(nnz_per_col);
+    Eigen::VectorXd bf = b;
+    for(uint col=0; col<A.cols(); ++col)
+    {
+        if(col_map[col] < 0)
+        {
+            double val = bc.at(col);
+            for(Eigen::SparseMatrix<double>::InnerIterator it(A,col); it; ++it) bf[it.row()] -= it.value() * val;
+        }
+        else
+        {
+            for(Eigen::SparseMatrix<double>::InnerIterator it(A,col); it; ++it) Af.insert(it.row(), col_map[col]) = it.value();
+        }
+    }
+    Af.makeCompressed();
+
+    Eigen::VectorXd xf;
+    solve_rectangular_least_squares(Af, bf, xf, solver);
 
     x.resize(A.cols());
     for(uint col=0; col<A.cols(); ++col)
     {
-        if (col_map[col] >= 0)
-            x[col] = tmp_x[ col_map[col] ];
-        else
-            x[col] = bc.at(col);
+        x[col] = (col_map[col] >= 0) ? xf[col_map[col]] : bc.at(col);
     }
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
-void solve_least_squares(const Eigen::SparseMatrix<float> & A,
-                         const Eigen::VectorXd             & b,
-                               Eigen::VectorXd             & x,
+void solve_least_squares(const Eigen::SparseMatrix<double> & A,
+                         const Eigen::VectorXd              & b,
+                               Eigen::VectorXd              & x,
                          short   solver)
 {
-    Eigen::SparseMatrix<float> At  = A.transpose();
-    Eigen::SparseMatrix<float> AtA = At * A;
+    if(solver == SparseQR || solver == LSCG)
+    {
+        solve_rectangular_least_squares(A, b, x, solver);
+        return;
+    }
+
+    Eigen::SparseMatrix<double> At  = A.transpose();
+    Eigen::SparseMatrix<double> AtA = At * A;
     Eigen::VectorXd             Atb = At * b;
 
     solve_square_system(AtA, Atb, x, solver);
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
-void solve_least_squares_with_bc(const Eigen::SparseMatrix<float> & A,
-                                 const Eigen::VectorXd             & b,
-                                       Eigen::VectorXd             & x,
-                                 const std::map<uint,float>       & bc, // Dirichlet boundary conditions
+void solve_least_squares_with_bc(const Eigen::SparseMatrix<double> & A,
+                                 const Eigen::VectorXd              & b,
+                                       Eigen::VectorXd              & x,
+                                 const std::map<uint,double>        & bc, // Dirichlet boundary conditions
                                  short   solver)
 {
-    Eigen::SparseMatrix<float>  At  = A.transpose();
-    Eigen::SparseMatrix<float>  AtA = At * A;
-    Eigen::VectorXd             Atb = At * b;
+    if(solver == SparseQR || solver == LSCG)
+    {
+        solve_rectangular_least_squares_with_bc(A, b, x, bc, solver);
+        return;
+    }
+
+    Eigen::SparseMatrix<double>  At  = A.transpose();
+    Eigen::SparseMatrix<double>  AtA = At * A;
+    Eigen::VectorXd              Atb = At * b;
 
     solve_square_system_with_bc(AtA, Atb, x, bc, solver);
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
-void solve_weighted_least_squares(const Eigen::SparseMatrix<float> & A,
-                                  const Eigen::VectorXd             & w,
-                                  const Eigen::VectorXd             & b,
-                                        Eigen::VectorXd             & x,
+void solve_weighted_least_squares(const Eigen::SparseMatrix<double> & A,
+                                  const Eigen::VectorXd              & w,
+                                  const Eigen::VectorXd              & b,
+                                        Eigen::VectorXd              & x,
                                   short   solver)
 {
-    Eigen::SparseMatrix<float> At   = A.transpose();
-    Eigen::SparseMatrix<float> AtWA = At * w.asDiagonal() * A;
+    if(solver == SparseQR || solver == LSCG)
+    {
+        // min ||W^(1/2)(Ax-b)||
+        Eigen::VectorXd             sqrt_w = w.cwiseSqrt();
+        Eigen::SparseMatrix<double> WA     = sqrt_w.asDiagonal() * A;
+        solve_rectangular_least_squares(WA, sqrt_w.cwiseProduct(b), x, solver);
+        return;
+    }
+
+    Eigen::SparseMatrix<double> At   = A.transpose();
+    Eigen::SparseMatrix<double> AtWA = At * w.asDiagonal() * A;
     Eigen::VectorXd             AtWb = At * w.asDiagonal() * b;
 
     solve_square_system(AtWA, AtWb, x, solver);
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
-void solve_weighted_least_squares_with_bc(const Eigen::SparseMatrix<float> & A,
-                                          const Eigen::VectorXd             & w,
-                                          const Eigen::VectorXd             & b,
-                                                Eigen::VectorXd             & x,
-                                          const std::map<uint,float>       & bc, // Dirichlet boundary conditions
+void solve_weighted_least_squares_with_bc(const Eigen::SparseMatrix<double> & A,
+                                          const Eigen::VectorXd              & w,
+                                          const Eigen::VectorXd              & b,
+                                                Eigen::VectorXd              & x,
+                                          const std::map<uint,double>        & bc, // Dirichlet boundary conditions
                                           short   solver)
 {
-    Eigen::SparseMatrix<float> At   = A.transpose();
-    Eigen::SparseMatrix<float> AtWA = At * w.asDiagonal() * A;
+    if(solver == SparseQR || solver == LSCG)
+    {
+        // min ||W^(1/2)(Ax-b)||
+        Eigen::VectorXd             sqrt_w = w.cwiseSqrt();
+        Eigen::SparseMatrix<double> WA     = sqrt_w.asDiagonal() * A;
+        solve_rectangular_least_squares_with_bc(WA, sqrt_w.cwiseProduct(b), x, bc, solver);
+        return;
+    }
+
+    Eigen::SparseMatrix<double> At   = A.transpose();
+    Eigen::SparseMatrix<double> AtWA = At * w.asDiagonal() * A;
     Eigen::VectorXd             AtWb = At * w.asDiagonal() * b;
     solve_square_system_with_bc(AtWA, AtWb, x, bc, solver);
 }
+
 }
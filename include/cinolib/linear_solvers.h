@@ -38,6 +38,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
 #include <Eigen/Sparse>
@@ -56,6 +57,12 @@ namespace cinolib
  * --------------------------------------------------------------
  * BiCGSTAB     none
  * (iterative)
+ * --------------------------------------------------------------
+ * SparseQR     none                        -           +++
+ * (least squares only, no normal equations, moderate sizes)
+ * --------------------------------------------------------------
+ * LSCG         none
+ * (least squares only, iterative, AtA is never formed)
  */
 
 enum
@@ -64,55 +71,163 @@ enum
     SIMPLICIAL_LDLT,
     SparseLU,
     BiCGSTAB,
+    SparseQR,
+    LSCG,
 };
 
-static const std::string txt[4] =
+static const std::string txt[6] =
 {
     "SIMPLICIAL_LLT"  ,
     "SIMPLICIAL_LDLT" ,
     "SparseLU",
     "BiCGSTAB",
+    "SparseQR",
+    "LSCG",
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Solves the square system A*x=b subject to Dirichlet boundary conditions,
+ * eliminating the constrained variables from the system. The split between
+ * free and fixed variables, the reduced sparsity pattern and the symbolic
+ * factorization are all computed once at construction. After that:
+ *
+ *  - solve() can be called any number of times with different right hand
+ *    sides and different boundary values, without touching the factorization
+ *  - update_matrix() can be called when the entries of A change but its
+ *    sparsity pattern does not: values are scattered into the reduced matrix
+ *    and only the numeric factorization is recomputed
+ *
+ * Boundary values are passed as flat arrays, listed in the same order of the
+ * ids given at construction (one row per constrained variable, one column
+ * per right hand side).
+*/
+
+class DirichletSolver
+{
+    public:
+
+        explicit DirichletSolver() {}
+
+        explicit DirichletSolver(const Eigen::SparseMatrix<double> & A,
+                                 const std::vector<uint>           & bc_ids,
+                                 const short                         solver = SIMPLICIAL_LLT);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void init(const Eigen::SparseMatrix<double> & A,
+                  const std::vector<uint>           & bc_ids,
+                  const short                         solver = SIMPLICIAL_LLT);
+
+        void update_matrix(const Eigen::SparseMatrix<double> & A); // same sparsity pattern used in init()
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void solve(const Eigen::VectorXd & b,
+                   const Eigen::VectorXd & bc_vals,
+                         Eigen::VectorXd & x) const;
+
+        void solve(const Eigen::MatrixXd & B,
+                   const Eigen::MatrixXd & bc_vals,
+                         Eigen::MatrixXd & X) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint num_vars()       const { return col_map.size();   }
+        uint num_free_vars()  const { return free_ids.size();  }
+        uint num_fixed_vars() const { return fixed_ids.size(); }
+        bool success()        const { return ok;               }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    protected:
+
+        void factorize();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        short                       solver = SIMPLICIAL_LLT;
+        bool                        ok     = false;
+        std::vector<int>            col_map;   // var id => free id (>=0) or -(fixed id)-1
+        std::vector<uint>           free_ids;  // free id => var id
+        std::vector<uint>           fixed_ids; // fixed id => var id
+        std::vector<int>            nz_map;    // A nz => Aff value (>=0), Afc value -(k)-2, or dropped (-1)
+        Eigen::SparseMatrix<double> Aff;       // free rows, free cols (the matrix to be factorized)
+        Eigen::SparseMatrix<double> Afc;       // free rows, fixed cols (moved to the rhs)
+
+        Eigen::SimplicialLLT <Eigen::SparseMatrix<double>>                              llt;
+        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>>                              ldlt;
+        Eigen::SparseLU      <Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int>> lu;
+        Eigen::BiCGSTAB      <Eigen::SparseMatrix<double>, Eigen::IncompleteLUT<double>> bicgstab;
 };
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
-void solve_square_system(const Eigen::SparseMatrix<float> & A,
-                         const Eigen::VectorXd             & b,
-                               Eigen::VectorXd             & x,
+void solve_square_system(const Eigen::SparseMatrix<double> & A,
+                         const Eigen::VectorXd              & b,
+                               Eigen::VectorXd              & x,
                          short   solver = SIMPLICIAL_LLT);
 
 CINO_INLINE
-void solve_square_system_with_bc(const Eigen::SparseMatrix<float> & A,
-                                 const Eigen::VectorXd             & b,
-                                       Eigen::VectorXd             & x,
-                                 const std::map<uint,float>       & bc, // Dirichlet boundary conditions
+void solve_square_system_with_bc(const Eigen::SparseMatrix<double> & A,
+                                 const Eigen::VectorXd              & b,
+                                       Eigen::VectorXd              & x,
+                                 const std::map<uint,double>        & bc, // Dirichlet boundary conditions
                                  short   solver = SIMPLICIAL_LLT);
 
+/* Multiple right hand sides version: each column of B is a different
+ * right hand side, and the corresponding solution is stored in the same
+ * column of X. The matrix is factorized only once. Dirichlet boundary
+ * conditions constrain the same entries in all columns, hence each entry
+ * in bc must contain B.cols() values (one per column)
+*/
+
+CINO_INLINE
+void solve_square_system(const Eigen::SparseMatrix<double> & A,
+                         const Eigen::MatrixXd              & B,
+                               Eigen::MatrixXd              & X,
+                         short   solver = SIMPLICIAL_LLT);
+
+CINO_INLINE
+void solve_square_system_with_bc(const Eigen::SparseMatrix<double>        & A,
+                                 const Eigen::MatrixXd                     & B,
+                                       Eigen::MatrixXd                     & X,
+                                 const std::map<uint,std::vector<double>> & bc, // Dirichlet boundary conditions
+                                 short   solver = SIMPLICIAL_LLT);
+
+/* Least squares solvers. With SparseQR and LSCG the rectangular system is
+ * solved directly, and the normal equations AtA are never assembled (better
+ * conditioning, less fill). All other solvers go through the normal equations.
+ * Dirichlet boundary conditions are eliminated from the columns of A.
+*/
+
 CINO_INLINE
-void solve_least_squares(const Eigen::SparseMatrix<float> & A,
-                         const Eigen::VectorXd             & b,
-                               Eigen::VectorXd             & x,
+void solve_least_squares(const Eigen::SparseMatrix<double> & A,
+                         const Eigen::VectorXd              & b,
+                               Eigen::VectorXd              & x,
                          short   solver = SIMPLICIAL_LLT);
 
 CINO_INLINE
-void solve_least_squares_with_bc(const Eigen::SparseMatrix<float> & A,
-                                 const Eigen::VectorXd             & b,
-                                       Eigen::VectorXd             & x,
-                                 const std::map<uint,float>       & bc, // Dirichlet boundary conditions
+void solve_least_squares_with_bc(const Eigen::SparseMatrix<double> & A,
+                                 const Eigen::VectorXd              & b,
+                                       Eigen::VectorXd              & x,
+                                 const std::map<uint,double>        & bc, // Dirichlet boundary conditions
                                  short   solver = SIMPLICIAL_LLT);
 
 CINO_INLINE
-void solve_weighted_least_squares(const Eigen::SparseMatrix<float> & A,
-                                  const Eigen::VectorXd             & w,
-                                  const Eigen::VectorXd             & b,
-                                        Eigen::VectorXd             & x,
+void solve_weighted_least_squares(const Eigen::SparseMatrix<double> & A,
+                                  const Eigen::VectorXd              & w,
+                                  const Eigen::VectorXd              & b,
+                                        Eigen::VectorXd              & x,
                                   short   solver = SIMPLICIAL_LLT);
 
 CINO_INLINE
-void solve_weighted_least_squares_with_bc(const Eigen::SparseMatrix<float> & A,
-                                          const Eigen::VectorXd             & w,
-                                          const Eigen::VectorXd             & b,
-                                                Eigen::VectorXd             & x,
-                                          const std::map<uint,float>       & bc, // Dirichlet boundary conditions
+void solve_weighted_least_squares_with_bc(const Eigen::SparseMatrix<double> & A,
+                                          const Eigen::VectorXd              & w,
+                                          const Eigen::VectorXd              & b,
+                                                Eigen::VectorXd              & x,
+                                          const std::map<uint,double>        & bc, // Dirichlet boundary conditions
                                           short   solver = SIMPLICIAL_LLT);
 
 }
@@ -34,9 +34,9 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/lscm.h>
-#include <cinolib/laplacian.h>
-#include <cinolib/linear_solvers.h>
-#include <cinolib/vector_area_matrix.h>
+#include <cinolib/symbols.h>
+#include <Eigen/Sparse>
+#include <complex>
 
 namespace cinolib
 {
@@ -46,30 +46,75 @@ CINO_INLINE
 ScalarField LSCM(const Trimesh<M,V,E,P>     & m,
                  const std::map<uint,vec2d> & bc)
 {
-    std::map<uint,float> bc_uv;
-    if(!bc.empty())
+    typedef std::complex<double>        cplx;
+    typedef Eigen::Triplet<cplx>        CEntry;
+    typedef Eigen::SparseMatrix<cplx>   CSparseMatrix;
+    typedef Eigen::Matrix<cplx,-1,1>    CVector;
+
+    uint nv = m.num_verts();
+
+    std::map<uint,vec2d> bc_uv = bc;
+    if(bc_uv.empty()) // fix two distant points on the boundary
+    {
+        auto b_verts = m.get_ordered_boundary_vertices();
+        bc_uv[b_verts.front()]                  = vec2d(0,0);
+        bc_uv[b_verts.at(b_verts.size()*0.5)]   = vec2d(1,1);
+    }
+
+    // The (2nv x 2nv) real system (-L 0 ; 0 -L) + 2A couples u and v only through the
+    // skew symmetric blocks of the vector area matrix A. Writing z = u + iv, the same
+    // system becomes an (nv x nv) Hermitian system -L - i*2A_uv, which is factorized
+    // once, has a quarter of the non zeros, and constrains u and v of a vertex jointly
+    std::vector<int> col_map(nv, 0);
+    for(auto obj : bc_uv) col_map.at(obj.first) = -1;
+    uint size = 0;
+    for(uint vid=0; vid<nv; ++vid) col_map[vid] = (col_map[vid]==0) ? size++ : -1;
+
+    CVector z_bc(nv);
+    for(auto obj : bc_uv) z_bc[obj.first] = cplx(obj.second.x(), obj.second.y());
+
+    std::vector<CEntry> entries;
+    CVector rhs = CVector::Zero(size);
+    auto add_entry = [&](const uint row, const uint col, const cplx & val)
+    {
+        if(col_map[row] < 0) return;
+        if(col_map[col] < 0) rhs[col_map[row]] -= val * z_bc[col];
+        else                 entries.push_back(CEntry(col_map[row], col_map[col], val));
+    };
+
+    std::vector<std::pair<uint,double>> wgts;
+    for(uint vid=0; vid<nv; ++vid)
     {
-        for(auto obj : bc)
+        m.vert_weights(vid, COTANGENT, wgts);
+        double sum = 0.0;
+        for(auto item : wgts)
         {
-            bc_uv[obj.first]               = obj.second.x();
-            bc_uv[obj.first+m.num_verts()] = obj.second.y();
+            add_entry(vid, item.first, cplx(-item.second,0));
+            sum += item.second;
         }
+        if(sum == 0.0) sum = 1.0; // disconnected vertex
+        add_entry(vid, vid, cplx(sum,0));
     }
-    else // fix two distant points on the boundary
+    for(auto e : m.get_boundary_edges())
     {
-        auto b_verts = m.get_ordered_boundary_vertices();
-        uint v0 = b_verts.front(),v1 = b_verts.at(b_verts.size()*0.5),nv = m.num_verts();
-        bc_uv[v0   ] = 0;
-        bc_uv[v0+nv] = 0;
-        bc_uv[v1   ] = 1;
-        bc_uv[v1+nv] = 1;
+        add_entry(e.first,  e.second, cplx(0,-0.5));
+        add_entry(e.second, e.first,  cplx(0, 0.5));
     }
 
-    Eigen::SparseMatrix<float> L=laplacian(m, COTANGENT, 2),A=vector_area_matrix(m);
-    Eigen::VectorXd            rhs = Eigen::VectorXd::Zero(2*m.num_verts());
+    CSparseMatrix H(size, size);
+    H.setFromTriplets(entries.begin(), entries.end());
 
-    ScalarField f_uv;
-    solve_square_system_with_bc(-L+2*A, rhs, f_uv, bc_uv, SIMPLICIAL_LDLT);
+    Eigen::SimplicialLDLT<CSparseMatrix> solver(H);
+    assert(solver.info() == Eigen::Success);
+    CVector z = solver.solve(rhs);
+
+    ScalarField f_uv(2*nv);
+    for(uint vid=0; vid<nv; ++vid)
+    {
+        cplx uv = (col_map[vid] >= 0) ? z[col_map[vid]] : z_bc[vid];
+        f_uv[vid]    = uv.real();
+        f_uv[vid+nv] = uv.imag();
+    }
     return f_uv;
 }
 }
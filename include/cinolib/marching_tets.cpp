@@ -43,7 +43,10 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/marching_tets.h>
+#include <cinolib/parallel_for.h>
 #include <array>
+#include <algorithm>
+#include <limits>
 
 namespace cinolib
 {
@@ -68,25 +71,188 @@ enum // Look-up Table
     C_0000 = 0x0
 };
 
+// Configuration of tet pid w.r.t. isovalue. Returns C_0000 if the tet does not
+// generate any triangle (also when the iso-surface passes EXACTLY through one of
+// its vertices/edges, or through a face that is generated by the adjacent tet)
+//
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
-void make_triangle(const Tetmesh<M,V,E,F,P> & m,
-                   const float               isovalue,
-                   const uint                 vids[],
-                   const float               func[],
-                   const std::array<uint,3> & e,
-                   std::map<ipair,uint>     & e2v_map,
-                   std::vector<vec3f>       & verts,
-                   std::vector<uint>        & tris,
-                   std::vector<vec3f>       & norms);
+unsigned char marching_tets_config(const Tetmesh<M,V,E,F,P> & m,
+                                   const uint                 pid,
+                                   const float                isovalue,
+                                   bool                     & swapped)
+{
+    float func[] =
+    {
+        static_cast<float>(m.vert_data(m.poly_vert_id(pid,0)).uvw[0]),
+        static_cast<float>(m.vert_data(m.poly_vert_id(pid,1)).uvw[0]),
+        static_cast<float>(m.vert_data(m.poly_vert_id(pid,2)).uvw[0]),
+        static_cast<float>(m.vert_data(m.poly_vert_id(pid,3)).uvw[0])
+    };
+
+    unsigned char c = C_0000;
+    if (isovalue >= func[0]) c |= C_1000;
+    if (isovalue >= func[1]) c |= C_0100;
+    if (isovalue >= func[2]) c |= C_0010;
+    if (isovalue >= func[3]) c |= C_0001;
+
+    /* If the isosurface does not intersect the tet,
+     * one should get C_1111 using ">=", and C_0000
+     * inverting to "<=".
+     *
+     * This does not happen if the isosurface passes
+     * exactly through one face. In this case one will
+     * get C_1111 using ">=", and something like
+     * C_0111 using "<=".
+     *
+     * Normally this does not create any trouble, as the
+     * face-adjacent tet will trigger the generation of
+     * that triangle. But if the tet is exposed on the
+     * surface, then that triangle will be missing in the
+     * final iso-surface.
+     *
+     * To avoid these missing triangles, whenever I get
+     * a C_1111 I invert the sign, and assign to the tet
+     * the configuration produced using "<="
+    */
+    swapped = false;
+    if (c == C_1111)
+    {
+        swapped = true;
+        c = C_0000;
+        if (isovalue <= func[0]) c |= C_1000;
+        if (isovalue <= func[1]) c |= C_0100;
+        if (isovalue <= func[2]) c |= C_0010;
+        if (isovalue <= func[3]) c |= C_0001;
+    }
+
+    bool v_on_iso[] =
+    {
+        func[0] == isovalue,
+        func[1] == isovalue,
+        func[2] == isovalue,
+        func[3] == isovalue
+    };
+
+    // true if face i is generated by the adjacent tet, that is, if the adjacent tet
+    // has higher id and does not lie entirely on the iso-surface (i.e. it is not C_1111)
+    auto yields_face = [&](const uint i) -> bool
+    {
+        int adj = m.poly_adj_through_face(pid, m.poly_face_id(pid,i)); // -1 if there is no adjacent tet!
+        if (adj <= (int)pid) return false;
+        for(uint j=0; j<4; ++j)
+        {
+            if (static_cast<float>(m.vert_data(m.poly_vert_id(adj,j)).uvw[0]) != isovalue) return true;
+        }
+        return false;
+    };
+
+    // Avoid triangle duplication and collapsed triangle generation when the iso-surface
+    // passes EXACTLY through a vertex/edge/face shared between many tetrahedra.
+    //
+    switch (c)
+    {
+        // iso-surface passes on a face : make sure only one tet (MUST BE the one with higher id) triggers triangle generation...
+        // Notice that if the adjacent tet is collapsed (C_1111), then it makes sense to use the current one regardless the tid order
+        case C_1110 : if (v_on_iso[0] && v_on_iso[1] && v_on_iso[2] && yields_face(0)) c = C_0000; break;
+        case C_1101 : if (v_on_iso[0] && v_on_iso[1] && v_on_iso[3] && yields_face(1)) c = C_0000; break;
+        case C_1011 : if (v_on_iso[0] && v_on_iso[2] && v_on_iso[3] && yields_face(2)) c = C_0000; break;
+        case C_0111 : if (v_on_iso[1] && v_on_iso[2] && v_on_iso[3] && yields_face(3)) c = C_0000; break;
+
+        // iso-surface passes on a edge : do nothing
+        case C_0101 : if (v_on_iso[1] && v_on_iso[3]) c = C_0000; break;
+        case C_1010 : if (v_on_iso[0] && v_on_iso[2]) c = C_0000; break;
+        case C_0011 : if (v_on_iso[2] && v_on_iso[3]) c = C_0000; break;
+        case C_1100 : if (v_on_iso[0] && v_on_iso[1]) c = C_0000; break;
+        case C_1001 : if (v_on_iso[0] && v_on_iso[3]) c = C_0000; break;
+        case C_0110 : if (v_on_iso[1] && v_on_iso[2]) c = C_0000; break;
+
+        // iso-surface passes on a vertex : do nothing
+        case C_1000 : if (v_on_iso[0]) c = C_0000; break;
+        case C_0100 : if (v_on_iso[1]) c = C_0000; break;
+        case C_0010 : if (v_on_iso[2]) c = C_0000; break;
+        case C_0001 : if (v_on_iso[3]) c = C_0000; break;
+
+        default : break;
+    }
+    return c;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Appends to tris the triangles generated by tet pid. Each triangle corner is
+// encoded with the id of the mesh edge it lies on
+//
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void marching_tets_triangles(const Tetmesh<M,V,E,F,P> & m,
+                             const uint                 pid,
+                             const float                isovalue,
+                             std::vector<uint>        & tris)
+{
+    bool swapped;
+    unsigned char c = marching_tets_config(m, pid, isovalue, swapped);
+    if (c == C_0000) return;
+
+    auto tri = [&](const uint e0, const uint e1, const uint e2)
+    {
+        for(uint e : {e0,e1,e2})
+        {
+            tris.push_back(m.poly_edge_id(pid, m.poly_vert_id(pid,TET_EDGES[e][0]),
+                                               m.poly_vert_id(pid,TET_EDGES[e][1])));
+        }
+    };
+
+    switch (c)
+    {
+        case C_1000 : { tri(2,0,4); break; }
+        case C_0111 : { swapped ? tri(2,0,4) : tri(0,2,4); break; }
+        case C_1011 : { swapped ? tri(1,2,3) : tri(2,1,3); break; }
+        case C_0100 : { tri(1,2,3); break; }
+        case C_1101 : { swapped ? tri(0,1,5) : tri(1,0,5); break; }
+        case C_0010 : { tri(0,1,5); break; }
+        case C_0001 : { tri(5,3,4); break; }
+        case C_1110 : { swapped ? tri(5,3,4) : tri(3,5,4); break; }
+        case C_0101 : { tri(5,2,4); tri(2,5,1); break; }
+        case C_1010 : { tri(2,5,4); tri(5,2,1); break; }
+        case C_0011 : { tri(3,4,1); tri(1,4,0); break; }
+        case C_1100 : { tri(4,3,1); tri(4,1,0); break; }
+        case C_1001 : { tri(3,2,0); tri(5,3,0); break; }
+        case C_0110 : { tri(2,3,0); tri(3,5,0); break; }
+        default : break;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void marching_tets(const Tetmesh<M,V,E,F,P> & m,
-                   const float               isovalue,
-                   std::vector<vec3f>       & verts,
+                   const float                isovalue,
+                   std::vector<vec3d>       & verts,
                    std::vector<uint>        & tris,
-                   std::vector<vec3f>       & norms)
+                   std::vector<vec3d>       & norms)
+{
+    std::vector<std::vector<vec3d>> all_verts;
+    std::vector<std::vector<uint>>  all_tris;
+    std::vector<std::vector<vec3d>> all_norms;
+    marching_tets(m, std::vector<float>(1,isovalue), all_verts, all_tris, all_norms);
+
+    uint base = verts.size();
+    for(uint vid : all_tris.front()) tris.push_back(base + vid);
+    verts.insert(verts.end(), all_verts.front().begin(), all_verts.front().end());
+    norms.insert(norms.end(), all_norms.front().begin(), all_norms.front().end());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void marching_tets(const Tetmesh<M,V,E,F,P>        & m,
+                   const std::vector<float>         & isovalues,
+                   std::vector<std::vector<vec3d>> & verts,
+                   std::vector<std::vector<uint>>  & tris,
+                   std::vector<std::vector<vec3d>> & norms)
 {
     /* FIXME: for all configurations where two verts >= isoval
      * and the other two are < isoval, this method will try to
@@ -99,212 +265,112 @@ void marching_tets(const Tetmesh<M,V,E,F,P> & m,
      * vertex (<,>,=). Once clarified how the vertext states are coded(encoded) and appropriately upcoded each configuration will be 100% correct
     */
 
-    std::vector<unsigned char> c(m.num_polys(),0x0);
-    std::vector<bool> swapped(m.num_polys(), false);
+    m.adjacency_require(ADJ_ALL); // crossing points are keyed by edge id, also in parallel
+    uint n_iso = isovalues.size();
+    verts.assign(n_iso, std::vector<vec3d>());
+    tris.assign (n_iso, std::vector<uint>());
+    norms.assign(n_iso, std::vector<vec3d>());
 
-    for(uint pid=0; pid<m.num_polys(); ++pid)
+    std::vector<uint> order(n_iso);
+    for(uint i=0; i<n_iso; ++i) order.at(i) = i;
+    std::sort(order.begin(), order.end(), [&](uint i, uint j){ return isovalues.at(i) < isovalues.at(j); });
+    std::vector<float> sorted_iso(n_iso);
+    for(uint i=0; i<n_iso; ++i) sorted_iso.at(i) = isovalues.at(order.at(i));
+
+    // interval index: a tet may generate triangles only for the iso values in [min,max]
+    std::vector<uint> tet_beg(m.num_polys()), tet_end(m.num_polys());
+    PARALLEL_FOR(0, m.num_polys(), 1000, [&](const uint pid)
     {
-        float func[] =
+        float min =  std::numeric_limits<float>::max();
+        float max = -std::numeric_limits<float>::max();
+        for(uint i=0; i<4; ++i)
         {
-            m.vert_data(m.poly_vert_id(pid,0)).uvw[0],
-            m.vert_data(m.poly_vert_id(pid,1)).uvw[0],
-            m.vert_data(m.poly_vert_id(pid,2)).uvw[0],
-            m.vert_data(m.poly_vert_id(pid,3)).uvw[0]
-        };
-
-        if (isovalue >= func[0]) c.at(pid) |= C_1000;
-        if (isovalue >= func[1]) c.at(pid) |= C_0100;
-        if (isovalue >= func[2]) c.at(pid) |= C_0010;
-        if (isovalue >= func[3]) c.at(pid) |= C_0001;
-
-        /* If the isosurface does not intersect the tet,
-         * one should get C_1111 using ">=", and C_0000
-         * inverting to "<=".
-         *
-         * This does not happen if the isosurface passes
-         * exactly through one face. In this case one will
-         * get C_1111 using ">=", and something like
-         * C_0111 using "<=".
-         *
-         * Normally this does not create any trouble, as the
-         * face-adjacent tet will trigger the generation of
-         * that triangle. But if the tet is exposed on the
-         * surface, then that triangle will be missing in the
-         * final iso-surface.
-         *
-         * To avoid these missing triangles, whenever I get
-         * a C_1111 I invert the sign, and assign to the tet
-         * the configuration produced using "<="
-        */
-        if (c.at(pid) == C_1111)
-        {
-            swapped.at(pid) = true;
-            c.at(pid) = 0x0;
-            if (isovalue <= func[0]) c.at(pid) |= C_1000;
-            if (isovalue <= func[1]) c.at(pid) |= C_0100;
-            if (isovalue <= func[2]) c.at(pid) |= C_0010;
-            if (isovalue <= func[3]) c.at(pid) |= C_0001;
+            float f = static_cast<float>(m.vert_data(m.poly_vert_id(pid,i)).uvw[0]);
+            min = std::min(min,f);
+            max = std::max(max,f);
         }
-    }
-
-    std::map<ipair,uint> e2v_map;
+        tet_beg.at(pid) = std::lower_bound(sorted_iso.begin(), sorted_iso.end(), min) - sorted_iso.begin();
+        tet_end.at(pid) = std::upper_bound(sorted_iso.begin(), sorted_iso.end(), max) - sorted_iso.begin();
+    });
 
+    // bucket tets per iso value (CSR layout), preserving the tet order
+    std::vector<uint> bucket_off(n_iso+1, 0);
     for(uint pid=0; pid<m.num_polys(); ++pid)
-    {
-        uint vids[] =
-        {
-            m.poly_vert_id(pid,0),
-            m.poly_vert_id(pid,1),
-            m.poly_vert_id(pid,2),
-            m.poly_vert_id(pid,3)
-        };
+    for(uint k=tet_beg.at(pid); k<tet_end.at(pid); ++k) ++bucket_off.at(k+1);
+    for(uint k=0; k<n_iso; ++k) bucket_off.at(k+1) += bucket_off.at(k);
+    std::vector<uint> bucket(bucket_off.back());
+    std::vector<uint> fill(bucket_off.begin(), bucket_off.end()-1);
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    for(uint k=tet_beg.at(pid); k<tet_end.at(pid); ++k) bucket.at(fill.at(k)++) = pid;
 
-        float func[] =
-        {
-            m.vert_data(vids[0]).uvw[0],
-            m.vert_data(vids[1]).uvw[0],
-            m.vert_data(vids[2]).uvw[0],
-            m.vert_data(vids[3]).uvw[0]
-        };
+    // crossing vertices are indexed by the id of the edge they lie on. The
+    // array is shared among iso values, and only touched entries are reset
+    std::vector<int> e2v(m.num_edges(), -1);
 
-        bool v_on_iso[] =
-        {
-            func[0] == isovalue,
-            func[1] == isovalue,
-            func[2] == isovalue,
-            func[3] == isovalue
-        };
-
-        int adj_tet[] // not uint because it may be -1 if there is no adjacent tet!
-        {
-            m.poly_adj_through_face(pid, m.poly_face_id(pid,0)),
-            m.poly_adj_through_face(pid, m.poly_face_id(pid,1)),
-            m.poly_adj_through_face(pid, m.poly_face_id(pid,2)),
-            m.poly_adj_through_face(pid, m.poly_face_id(pid,3)),
-        };
-
-        // Avoid triangle duplication and collapsed triangle generation when the iso-surface
-        // passes EXACTLY through a vertex/edge/face shared between many tetrahedra.
-        //
-        switch (c.at(pid))
-        {
-            // iso-surface passes on a face : make sure only one tet (MUST BE the one with higher id) triggers triangle generation...
-            // Notice that if the adjacent tet is collapsed (C_1111), then it makes sense to use the current one regardless the tid order
-            case C_1110 : if (v_on_iso[0] && v_on_iso[1] && v_on_iso[2] && (int)pid < adj_tet[0] && c.at(adj_tet[0]) != C_1111) c.at(pid) = C_0000; break;
-            case C_1101 : if (v_on_iso[0] && v_on_iso[1] && v_on_iso[3] && (int)pid < adj_tet[1] && c.at(adj_tet[1]) != C_1111) c.at(pid) = C_0000; break;
-            case C_1011 : if (v_on_iso[0] && v_on_iso[2] && v_on_iso[3] && (int)pid < adj_tet[2] && c.at(adj_tet[2]) != C_1111) c.at(pid) = C_0000; break;
-            case C_0111 : if (v_on_iso[1] && v_on_iso[2] && v_on_iso[3] && (int)pid < adj_tet[3] && c.at(adj_tet[3]) != C_1111) c.at(pid) = C_0000; break;
-
-            // iso-surface passes on a edge : do nothing
-            case C_0101 : if (v_on_iso[1] && v_on_iso[3]) c.at(pid) = C_0000; break;
-            case C_1010 : if (v_on_iso[0] && v_on_iso[2]) c.at(pid) = C_0000; break;
-            case C_0011 : if (v_on_iso[2] && v_on_iso[3]) c.at(pid) = C_0000; break;
-            case C_1100 : if (v_on_iso[0] && v_on_iso[1]) c.at(pid) = C_0000; break;
-            case C_1001 : if (v_on_iso[0] && v_on_iso[3]) c.at(pid) = C_0000; break;
-            case C_0110 : if (v_on_iso[1] && v_on_iso[2]) c.at(pid) = C_0000; break;
-
-            // iso-surface passes on a vertex : do nothing
-            case C_1000 : if (v_on_iso[0]) c.at(pid) = C_0000; break;
-            case C_0100 : if (v_on_iso[1]) c.at(pid) = C_0000; break;
-            case C_0010 : if (v_on_iso[2]) c.at(pid) = C_0000; break;
-            case C_0001 : if (v_on_iso[3]) c.at(pid) = C_0000; break;
-
-            default : break;
-        }
+    const uint chunk_size = 4096;
+    for(uint k=0; k<n_iso; ++k)
+    {
+        float iso = sorted_iso.at(k);
+        uint  beg = bucket_off.at(k);
+        uint  end = bucket_off.at(k+1);
 
-        // triangle generation
-        switch (c.at(pid))
+        // generate triangles (as triplets of edge ids) in parallel. Chunks have a
+        // fixed size and are merged in order, so the output does not depend on the
+        // number of threads
+        uint n_chunks = (end-beg+chunk_size-1)/chunk_size;
+        std::vector<std::vector<uint>> chunk_tris(n_chunks);
+        PARALLEL_FOR(0, n_chunks, 2, [&](const uint c)
         {
-            case C_1000 : { make_triangle(m, isovalue, vids, func, {2,0,4}, e2v_map, verts, tris, norms); break; }
-            case C_0111 : { swapped.at(pid)?
-                            make_triangle(m, isovalue, vids, func, {2,0,4}, e2v_map, verts, tris, norms) :
-                            make_triangle(m, isovalue, vids, func, {0,2,4}, e2v_map, verts, tris, norms); break; }
-            case C_1011 : { swapped.at(pid)?
-                            make_triangle(m, isovalue, vids, func, {1,2,3}, e2v_map, verts, tris, norms) :
-                            make_triangle(m, isovalue, vids, func, {2,1,3}, e2v_map, verts, tris, norms); break; }
-            case C_0100 : { make_triangle(m, isovalue, vids, func, {1,2,3}, e2v_map, verts, tris, norms); break; }
-            case C_1101 : { swapped.at(pid)?
-                            make_triangle(m, isovalue, vids, func, {0,1,5}, e2v_map, verts, tris, norms) :
-                            make_triangle(m, isovalue, vids, func, {1,0,5}, e2v_map, verts, tris, norms); break; }
-            case C_0010 : { make_triangle(m, isovalue, vids, func, {0,1,5}, e2v_map, verts, tris, norms); break; }
-            case C_0001 : { make_triangle(m, isovalue, vids, func, {5,3,4}, e2v_map, verts, tris, norms); break; }
-            case C_1110 : { swapped.at(pid)?
-                            make_triangle(m, isovalue, vids, func, {5,3,4}, e2v_map, verts, tris, norms) :
-                            make_triangle(m, isovalue, vids, func, {3,5,4}, e2v_map, verts, tris, norms); break; }
-            case C_0101 : { make_triangle(m, isovalue, vids, func, {5,2,4}, e2v_map, verts, tris, norms);
-                            make_triangle(m, isovalue, vids, func, {2,5,1}, e2v_map, verts, tris, norms); break; }
-            case C_1010 : { make_triangle(m, isovalue, vids, func, {2,5,4}, e2v_map, verts, tris, norms);
-                            make_triangle(m, isovalue, vids, func, {5,2,1}, e2v_map, verts, tris, norms); break; }
-            case C_0011 : { make_triangle(m, isovalue, vids, func, {3,4,1}, e2v_map, verts, tris, norms);
-                            make_triangle(m, isovalue, vids, func, {1,4,0}, e2v_map, verts, tris, norms); break; }
-            case C_1100 : { make_triangle(m, isovalue, vids, func, {4,3,1}, e2v_map, verts, tris, norms);
-                            make_triangle(m, isovalue, vids, func, {4,1,0}, e2v_map, verts, tris, norms); break; }
-            case C_1001 : { make_triangle(m, isovalue, vids, func, {3,2,0}, e2v_map, verts, tris, norms);
-                            make_triangle(m, isovalue, vids, func, {5,3,0}, e2v_map, verts, tris, norms); break; }
-            case C_0110 : { make_triangle(m, isovalue, vids, func, {2,3,0}, e2v_map, verts, tris, norms);
-                            make_triangle(m, isovalue, vids, func, {3,5,0}, e2v_map, verts, tris, norms); break; }
-            default : break;
-        }
-    }
-}
-
-template<class M, class V, class E, class F, class P>
-CINO_INLINE
-void make_triangle(const Tetmesh<M,V,E,F,P> & m,
-                   const float               isovalue,
-                   const uint                 vids[],
-                   const float               func[],
-                   const std::array<uint,3> & e,
-                   std::map<ipair,uint>     & e2v_map,
-                   std::vector<vec3f>       & verts,
-                   std::vector<uint>        & tris,
-                   std::vector<vec3f>       & norms)
-{
-    assert(isovalue >= *std::min_element(func, func+4));
-    assert(isovalue <= *std::max_element(func, func+4));
+            uint c_end = std::min(end, beg+(c+1)*chunk_size);
+            for(uint i=beg+c*chunk_size; i<c_end; ++i)
+            {
+                marching_tets_triangles(m, bucket.at(i), iso, chunk_tris.at(c));
+            }
+        });
 
-    vec3f tri_verts[3];
-    uint  fresh_vid = verts.size();
+        std::vector<uint> & t = tris.at(order.at(k));
+        for(const auto & ct : chunk_tris) t.insert(t.end(), ct.begin(), ct.end());
 
-    for(short i=0; i<3; ++i)
-    {
-        uint v_a = vids[TET_EDGES[e[i]][0]],v_b = vids[TET_EDGES[e[i]][1]];
-        
-        // avoid duplicated vertices. If an edge has already
-        // been visited retrieve its id and coordinates
-        //
-        ipair pair  = unique_pair(v_a, v_b);
-        auto  query = e2v_map.find(pair);
-
-        if (query != e2v_map.end())
+        // assign vertex ids in order of first appearance
+        std::vector<uint> v2e;
+        for(uint & eid : t)
         {
-            uint vid = query->second;
-            tri_verts[i] = vec3d(verts.at(vid));
-            tris.push_back(vid);
+            if (e2v.at(eid)<0)
+            {
+                e2v.at(eid) = v2e.size();
+                v2e.push_back(eid);
+            }
+            eid = e2v.at(eid);
         }
-        else
+        for(uint eid : v2e) e2v.at(eid) = -1;
+
+        std::vector<vec3d> & v = verts.at(order.at(k));
+        v.resize(v2e.size());
+        PARALLEL_FOR(0, v2e.size(), 1000, [&](const uint vid)
         {
-            float f_a = func[TET_EDGES[e[i]][0]],f_b = func[TET_EDGES[e[i]][1]];
-            
+            uint  v_a = m.edge_vert_id(v2e.at(vid),0);
+            uint  v_b = m.edge_vert_id(v2e.at(vid),1);
+            float f_a = m.vert_data(v_a).uvw[0];
+            float f_b = m.vert_data(v_b).uvw[0];
             if (f_a < f_b)
             {
                 std::swap(v_a, v_b);
                 std::swap(f_a, f_b);
             }
+            float alpha = (iso - f_a) / (f_b - f_a);
+            v.at(vid) = (1.0 - alpha) * m.vert(v_a) + alpha * m.vert(v_b);
+        });
 
-            float alpha = (isovalue - f_a) / (f_b - f_a);
-
-            tri_verts[i] = (1.0 - alpha) * m.vert(v_a) + alpha * m.vert(v_b);
-
-            verts.push_back(tri_verts[i]);
-
-            tris.push_back(fresh_vid);
-            e2v_map[pair] = fresh_vid++;
-        }
+        std::vector<vec3d> & n = norms.at(order.at(k));
+        n.resize(t.size()/3);
+        PARALLEL_FOR(0, n.size(), 1000, [&](const uint tid)
+        {
+            vec3d u = v.at(t.at(3*tid+1)) - v.at(t.at(3*tid+0)); u.normalize();
+            vec3d w = v.at(t.at(3*tid+2)) - v.at(t.at(3*tid+0)); w.normalize();
+            n.at(tid) = u.cross(w);
+            n.at(tid).normalize();
+        });
     }
-
-    vec3f u  = (tri_verts[1] - tri_verts[0]).normalize(),w  = (tri_verts[2] - tri_verts[0]).normalize();
-    vec3f n = u.cross(w).normalize();
-    norms.push_back(n);
 }
+
 }
@@ -37,22 +37,41 @@
 #define CINO_MARCHING_TETS_H
 
 #include <vector>
-#include <map>
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
-#include <cinolib/ipair.h>
 #include <cinolib/meshes/tetmesh.h>
 
 namespace cinolib
 {
 
+/* Extracts the iso-surface of the scalar field stored in the uvw[0]
+ * vertex attribute. Crossing vertices are shared among adjacent tets
+ * by indexing them with the id of the mesh edge they lie on. Output
+ * is appended to verts, tris and norms (one normal per triangle)
+*/
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void marching_tets(const Tetmesh<M,V,E,F,P> & m,
-                   const float               isovalue,
-                   std::vector<vec3f>       & verts,
+                   const float                isovalue,
+                   std::vector<vec3d>       & verts,
                    std::vector<uint>        & tris,
-                   std::vector<vec3f>       & norms);
+                   std::vector<vec3d>       & norms);
+
+/* Extracts many iso-surfaces in one pass. A per-tet interval index
+ * restricts each iso value to the tets whose range [min,max] contains
+ * it, and tets are processed in parallel. The output is deterministic
+ * (it does not depend on the number of threads), and the surface of
+ * isovalues[i] is stored in verts[i], tris[i] and norms[i]
+*/
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void marching_tets(const Tetmesh<M,V,E,F,P>        & m,
+                   const std::vector<float>         & isovalues,
+                   std::vector<std::vector<vec3d>> & verts,
+                   std::vector<std::vector<uint>>  & tris,
+                   std::vector<std::vector<vec3d>> & norms);
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -35,8 +35,7 @@
 *********************************************************************************/
 #include <cinolib/mean_curv_flow.h>
 #include <cinolib/laplacian.h>
-#include <cinolib/linear_solvers.h>
-#include <cinolib/vertex_mass.h>
+#include <cinolib/parallel_for.h>
 #include <cinolib/symbols.h>
 
 namespace cinolib
@@ -47,45 +46,125 @@ CINO_INLINE
 void MCF(AbstractPolygonMesh<M,V,E,P> & m,
          const uint                     n_iters,
          const float                    time_scalar,
-         const bool                     conformalized)
+         const bool                     conformalized,
+         const bool                     iterative)
 {
+    // mass and weight updates run in parallel, and query v2p, edges and p2p
+    m.adjacency_require(ADJ_ALL);
+
     // use the squared avg edge length as time step, as suggested in:
     // Geodesics in Heat: A New Approach to Computing Distance Based on Heat Flow
     // K.Crane, C.Weischedel, M.Wardetzky
     // SIGGRAPH 2013
     double time = m.edge_avg_length();
     time *= time*time_scalar;
-   
-    Eigen::SparseMatrix<float> L=laplacian(m, COTANGENT),MM=mass_matrix(m);
-    
+
+    uint nv = m.num_verts();
+
+    // A = MM - t*L has the same (symmetric) sparsity of L for the whole flow:
+    // keep it, and only rewrite its values from L and from the vertex masses
+    Eigen::SparseMatrix<double> A = laplacian(m, COTANGENT);
+    A.makeCompressed();
+    Eigen::VectorXd L_vals = Eigen::Map<Eigen::VectorXd>(A.valuePtr(), A.nonZeros());
+    Eigen::VectorXd masses(nv);
+
+    // position of entry (row,col) in the value array of A
+    auto pos = [&](const uint row, const uint col) -> int
+    {
+        for(int k=A.outerIndexPtr()[col]; k<A.outerIndexPtr()[col+1]; ++k)
+        {
+            if((uint)A.innerIndexPtr()[k] == row) return k;
+        }
+        assert(false);
+        return -1;
+    };
+
+    // for each vertex, where its diagonal entry and the weights returned by
+    // vert_weights go (connectivity does not change, hence neither does the order)
+    std::vector<int>  diag(nv);
+    std::vector<uint> row_beg(nv+1,0);
+    std::vector<int>  row_pos;
+    std::vector<std::pair<uint,double>> wgts;
+    for(uint vid=0; vid<nv; ++vid)
+    {
+        diag[vid] = pos(vid,vid);
+        m.vert_weights(vid, COTANGENT, wgts);
+        for(auto item : wgts) row_pos.push_back(pos(vid,item.first));
+        row_beg[vid+1] = row_pos.size();
+    }
+
+    auto update_masses = [&]()
+    {
+        PARALLEL_FOR(0, nv, 1000, [&](uint vid)
+        {
+            masses[vid] = m.vert_mass(vid);
+        });
+    };
+
+    auto update_laplacian = [&]() // same entries of laplacian(m,COTANGENT), each thread writes one row
+    {
+        PARALLEL_FOR(0, nv, 1000, [&](uint vid)
+        {
+            std::vector<std::pair<uint,double>> wgts;
+            m.vert_weights(vid, COTANGENT, wgts);
+            assert(wgts.size() == row_beg[vid+1]-row_beg[vid]);
+            double sum = 0.0;
+            for(uint i=0; i<wgts.size(); ++i)
+            {
+                L_vals[row_pos[row_beg[vid]+i]] = wgts[i].second;
+                sum -= wgts[i].second;
+            }
+            if(sum == 0.0) sum = 1.0;
+            L_vals[diag[vid]] = sum;
+        });
+    };
+
+    update_masses();
+
+    Eigen::SimplicialLLT<Eigen::SparseMatrix<double>> llt;
+    Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower|Eigen::Upper> cg;
+    if(iterative)
+    {
+        cg.setTolerance(1e-6);
+        cg.setMaxIterations(1000); // bounds the cost when the flow degenerates
+    }
+    else llt.analyzePattern(A); // symbolic factorization, once
+
+    Eigen::MatrixXd xyz(nv,3);
     for(uint i=1; i<=n_iters; ++i)
     {
         // optimize position and scale to get better numerical precision
         m.normalize_bbox();
-        m.center_bbox();        
+        m.center_bbox();
 
         // backward euler time integration of heat flow equation
-        Eigen::SimplicialLLT<Eigen::SparseMatrix<float>> LLT(MM - time_scalar * L);
+        double *A_vals = A.valuePtr();
+        for(int k=0; k<A.nonZeros(); ++k) A_vals[k]  = -time_scalar * L_vals[k];
+        for(uint vid=0; vid<nv; ++vid)    A_vals[diag[vid]] += masses[vid];
 
-        uint nv = m.num_verts();
-        Eigen::VectorXd x(nv),y(nv),z(nv);
-        
         for(uint vid=0; vid<nv; ++vid)
         {
-            vec3f pos = m.vert(vid);
-            x[vid] = pos.x();
-            y[vid] = pos.y();
-            z[vid] = pos.z();
+            xyz(vid,0) = m.vert(vid).x();
+            xyz(vid,1) = m.vert(vid).y();
+            xyz(vid,2) = m.vert(vid).z();
         }
+        Eigen::MatrixXd rhs = masses.asDiagonal() * xyz;
 
-        x = LLT.solve(MM * x);
-        y = LLT.solve(MM * y);
-        z = LLT.solve(MM * z);
+        if(iterative)
+        {
+            cg.compute(A);
+            xyz = cg.solveWithGuess(rhs, xyz);
+        }
+        else
+        {
+            llt.factorize(A);
+            xyz = llt.solve(rhs);
+        }
 
-        float residual = 0.0;
+        double residual = 0.0;
         for(uint vid=0; vid<m.num_verts(); ++vid)
         {
-            vec3f new_pos(x[vid], y[vid], z[vid]);
+            vec3d new_pos(xyz(vid,0), xyz(vid,1), xyz(vid,2));
             residual += (m.vert(vid) - new_pos).length();
             m.vert(vid) = new_pos;
         }
@@ -94,8 +173,8 @@ void MCF(AbstractPolygonMesh<M,V,E,P> & m,
 
         if (i<n_iters) // update matrices for the next iteration
         {
-            MM = mass_matrix(m);
-            if (!conformalized) L = laplacian(m, COTANGENT);
+            update_masses();
+            if (!conformalized) update_laplacian();
         }
     }
 
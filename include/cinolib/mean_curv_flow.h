@@ -49,6 +49,16 @@ namespace cinolib
  * Can Mean-Curvature Flow be Modified to be Non-singular?
  * Michael Kazhdan, Jake Solomon and Mirela Ben-Chen
  * Computer Graphics Forum, 31(5), 2012.
+ *
+ * The sparsity of the system matrix MM - t*L never changes along the flow,
+ * therefore its symbolic factorization is computed only once, and each
+ * iteration only updates matrix values (in parallel) and refactorizes
+ * numerically. The three coordinates are solved as multiple right hand sides.
+ * If iterative is true, a conjugate gradient solver warm started from the
+ * current vertex positions is used instead of the direct solver. No
+ * factorization is computed at all, which pays off for small time steps
+ * (i.e. good initial guesses) and large meshes. Prefer the direct solver for
+ * the classical flow, which becomes badly conditioned as the mesh degenerates.
 */
 
 template<class M, class V, class E, class P>
@@ -56,7 +66,8 @@ CINO_INLINE
 void MCF(AbstractPolygonMesh<M,V,E,P> & m,
          const uint                     n_iters,
          const float                    time_scalar = 0.01, // I suggest very small steps for the conformalized version
-         const bool                     conformalized = true);
+         const bool                     conformalized = true,
+         const bool                     iterative = false);
 
 }
 
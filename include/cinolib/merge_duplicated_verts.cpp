@@ -0,0 +1,261 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/merge_duplicated_verts.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/union_find.h>
+#include <cassert>
+#include <cstring>
+#include <cmath>
+#include <cstdint>
+
+namespace cinolib
+{
+
+CINO_INLINE
+void merge_duplicated_verts(const std::vector<vec3d> & verts,
+                                  std::vector<vec3d> & new_verts,
+                                  std::vector<uint>  & old2new,
+                            const double               eps)
+{
+    assert(eps>=0);
+    new_verts.clear();
+    old2new.resize(verts.size());
+    uint nv = verts.size();
+    if(nv==0) return;
+
+    // integer keys for each vertex: the cell of a uniform grid with spacing 2*eps,
+    // or the raw bits of the coordinates if only exact duplicates must be merged
+    double cell_size = 2*eps;
+    std::vector<int64_t> keys(3*nv);
+    PARALLEL_FOR(0, nv, 10000, [&](const uint vid)
+    {
+        for(int i=0; i<3; ++i)
+        {
+            if(eps>0) keys[3*vid+i] = (int64_t)std::floor(verts[vid][i]/cell_size);
+            else
+            {
+                double c = verts[vid][i] + 0.0; // turns -0.0 into +0.0
+                std::memcpy(&keys[3*vid+i], &c, sizeof(double));
+            }
+        }
+    });
+
+    // keys are bit patterns of doubles (or small integers), hence they must
+    // be mixed thoroughly before taking the lowest bits as bucket id. In eps
+    // mode grid cells are hashed in blocks of 4x4x4, so that adjacent cells
+    // are likely to fall in nearby buckets (i.e. same cache lines)
+    uint64_t n_buckets = 64;
+    while(n_buckets<nv) n_buckets <<= 1;
+    auto mix = [](uint64_t h) -> uint64_t
+    {
+        h ^= h >> 33; h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    };
+    auto hash = [&](const int64_t x, const int64_t y, const int64_t z) -> uint
+    {
+        if(eps>0)
+        {
+            uint64_t block = mix((uint64_t)(x>>2) ^ mix((uint64_t)(y>>2) ^ mix((uint64_t)(z>>2))));
+            return (uint)(((block << 6) | ((x&3)<<4) | ((y&3)<<2) | (z&3)) & (n_buckets-1));
+        }
+        return (uint)(mix((uint64_t)x ^ mix((uint64_t)y ^ mix((uint64_t)z))) & (n_buckets-1));
+    };
+
+    std::vector<uint> bucket(nv);
+    PARALLEL_FOR(0, nv, 10000, [&](const uint vid)
+    {
+        bucket[vid] = hash(keys[3*vid], keys[3*vid+1], keys[3*vid+2]);
+    });
+
+    // counting sort of the verts by bucket id (flat CSR table).
+    // Verts in each bucket are sorted by increasing id
+    std::vector<uint> bucket_beg(n_buckets+1,0);
+    for(uint vid=0; vid<nv; ++vid) ++bucket_beg[bucket[vid]];
+    for(uint64_t b=1; b<n_buckets; ++b) bucket_beg[b] += bucket_beg[b-1];
+    bucket_beg[n_buckets] = nv;
+    std::vector<uint> sorted_vids(nv);
+    for(uint vid=nv; vid-->0;) sorted_vids[--bucket_beg[bucket[vid]]] = vid;
+    bucket.clear();
+    bucket.shrink_to_fit();
+
+    // from now on keys are stored in bucket order, so that
+    // scanning a bucket only touches contiguous memory
+    std::vector<int64_t> sorted_keys(3*nv);
+    PARALLEL_FOR(0, nv, 10000, [&](const uint i)
+    {
+        for(int j=0; j<3; ++j) sorted_keys[3*i+j] = keys[3*sorted_vids[i]+j];
+    });
+    keys.swap(sorted_keys);
+    sorted_keys.clear();
+    sorted_keys.shrink_to_fit();
+
+    auto same_key = [&](const uint i, const int64_t *k) -> bool
+    {
+        return keys[3*i]==k[0] && keys[3*i+1]==k[1] && keys[3*i+2]==k[2];
+    };
+
+    // group verts with the same key. For the i-th vert in bucket order,
+    // group[i] is the position of the first vert in its group (i.e. the one
+    // with smallest id)
+    std::vector<uint> group(nv);
+    PARALLEL_FOR(0, n_buckets, 10000, [&](const uint b)
+    {
+        for(uint i=bucket_beg[b]; i<bucket_beg[b+1]; ++i)
+        {
+            uint j = bucket_beg[b];
+            while(!same_key(j, &keys[3*i])) ++j;
+            group[i] = j;
+        }
+    });
+
+    // rep[vid] is the smallest id among the verts that will be merged with vid.
+    // In exact mode groups are the final result. Otherwise groups are grid
+    // cells, and verts closer than eps may also live in adjacent cells
+    std::vector<uint> rep(nv);
+    if(eps==0)
+    {
+        PARALLEL_FOR(0, nv, 10000, [&](const uint i)
+        {
+            rep[sorted_vids[i]] = sorted_vids[group[i]];
+        });
+    }
+    else
+    {
+        std::vector<uint> cells;
+        for(uint i=0; i<nv; ++i) if(group[i]==i) cells.push_back(i);
+
+        // close pairs of verts are found visiting each cell and half of its neighbors
+        // (the other half will find the same pairs from the other side). Since cells
+        // are 2*eps wide, only neighbors across faces that have some vert closer than
+        // eps need to be visited. Close pairs are merged on the fly with a concurrent
+        // union-find, whose roots are always the smallest id in their set
+        std::vector<std::atomic<uint>> parent(nv);
+        PARALLEL_FOR(0, nv, 10000, [&](const uint vid)
+        {
+            parent[vid].store(vid);
+        });
+        double eps_sq = eps*eps;
+        auto merge_close_pairs = [&](const uint c)
+        {
+            auto test = [&](const uint i, const uint j)
+            {
+                uint v0 = sorted_vids[i];
+                uint v1 = sorted_vids[j];
+                if(verts[v0].dist_squared(verts[v1])<eps_sq) union_find_merge(parent, v0, v1);
+            };
+            const int64_t *k = &keys[3*c];
+            uint b = hash(k[0], k[1], k[2]);
+            bool near[3][3] = {{false,true,false},{false,true,false},{false,true,false}}; // near[axis][1+dir]
+            for(uint i=c; i<bucket_beg[b+1]; ++i)
+            {
+                if(group[i]!=c) continue;
+                const vec3d & p = verts[sorted_vids[i]];
+                for(int j=0; j<3; ++j)
+                {
+                    if(p[j] - k[j]*cell_size     < eps) near[j][0] = true;
+                    if((k[j]+1)*cell_size - p[j] < eps) near[j][2] = true;
+                }
+                for(uint j=i+1; j<bucket_beg[b+1]; ++j) if(group[j]==c) test(i,j);
+            }
+            for(int64_t dx= 0; dx<=1; ++dx)
+            for(int64_t dy=-1; dy<=1; ++dy)
+            for(int64_t dz=-1; dz<=1; ++dz)
+            {
+                if(dx==0 && (dy<0 || (dy==0 && dz<=0))) continue;
+                if(!near[0][1+dx] || !near[1][1+dy] || !near[2][1+dz]) continue;
+                int64_t nk[3] = { k[0]+dx, k[1]+dy, k[2]+dz };
+                uint nb = hash(nk[0], nk[1], nk[2]);
+                for(uint j=bucket_beg[nb]; j<bucket_beg[nb+1]; ++j)
+                {
+                    if(!same_key(j,nk)) continue; // hash collision
+                    for(uint i=c; i<bucket_beg[b+1]; ++i) if(group[i]==c) test(i,j);
+                }
+            }
+        };
+        PARALLEL_FOR(0, cells.size(), 1000, [&](const uint i)
+        {
+            merge_close_pairs(cells[i]);
+        });
+        PARALLEL_FOR(0, nv, 10000, [&](const uint vid)
+        {
+            rep[vid] = union_find_root(parent, vid);
+        });
+    }
+
+    // assign fresh ids following the order of first occurrence
+    for(uint vid=0; vid<nv; ++vid)
+    {
+        if(rep[vid]==vid)
+        {
+            old2new[vid] = new_verts.size();
+            new_verts.push_back(verts[vid]);
+        }
+        else old2new[vid] = old2new[rep[vid]];
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void merge_duplicated_verts(std::vector<vec3d> & verts,
+                            std::vector<uint>  & vids,
+                            const double         eps)
+{
+    std::vector<vec3d> new_verts;
+    std::vector<uint>  old2new;
+    merge_duplicated_verts(verts, new_verts, old2new, eps);
+    for(uint & vid : vids) vid = old2new.at(vid);
+    verts.swap(new_verts);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void merge_duplicated_verts(std::vector<vec3d>             & verts,
+                            std::vector<std::vector<uint>> & polys,
+                            const double                     eps)
+{
+    std::vector<vec3d> new_verts;
+    std::vector<uint>  old2new;
+    merge_duplicated_verts(verts, new_verts, old2new, eps);
+    for(auto & p : polys)
+    for(uint & vid : p) vid = old2new.at(vid);
+    verts.swap(new_verts);
+}
+
+}
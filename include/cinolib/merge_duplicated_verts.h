@@ -0,0 +1,93 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_MERGE_DUPLICATED_VERTS_H
+#define CINO_MERGE_DUPLICATED_VERTS_H
+
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec3.h>
+#include <vector>
+
+namespace cinolib
+{
+
+/* Welds the vertices of a polygon soup (e.g. the output of an STL reader).
+ * Vertices are bucketed in a spatial hash, and the bucket lookups are done
+ * in parallel (see PARALLEL_FOR).
+ *
+ *     eps == 0 : only vertices with exactly the same coordinates are merged
+ *     eps  > 0 : vertices closer than eps are merged. Merging is transitive,
+ *                hence chains of close vertices collapse into a single one
+ *
+ * The output is deterministic: each group of merged vertices is represented
+ * by its first occurrence in the input list, and output vertices retain the
+ * relative order of their representatives.
+ *
+ * old2new[vid] is the id that input vertex vid has in new_verts.
+ *
+ * NOTE: when eps>0 small polygons may collapse (i.e. contain the same vertex
+ * more than once). Filtering them out is up to the caller.
+*/
+
+CINO_INLINE
+void merge_duplicated_verts(const std::vector<vec3d> & verts,
+                                  std::vector<vec3d> & new_verts,
+                                  std::vector<uint>  & old2new,
+                            const double               eps = 0.0);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// in place version that also updates a serialized list of vertex ids (e.g. triangles)
+//
+CINO_INLINE
+void merge_duplicated_verts(std::vector<vec3d> & verts,
+                            std::vector<uint>  & vids,
+                            const double         eps = 0.0);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// in place version that also updates a list of polygons
+//
+CINO_INLINE
+void merge_duplicated_verts(std::vector<vec3d>             & verts,
+                            std::vector<std::vector<uint>> & polys,
+                            const double                     eps = 0.0);
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "merge_duplicated_verts.cpp"
+#endif
+
+#endif // CINO_MERGE_DUPLICATED_VERTS_H
@@ -0,0 +1,623 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/mesh_partitioning.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/stl_container_utilities.h>
+#include <cinolib/min_max_inf.h>
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <cassert>
+#include <iterator>
+
+namespace cinolib
+{
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<int> mesh_partition(      AbstractMesh<M,V,E,P> & m,
+                                const uint                    n_parts,
+                                const PartitionGraph          graph,
+                                const double                  imbalance,
+                                const bool                    labels,
+                                const uint                    seed)
+{
+    std::vector<int> parts;
+    if(graph==PARTITION_DUAL)
+    {
+        std::vector<std::vector<uint>> adj(m.num_polys());
+        for(uint pid=0; pid<m.num_polys(); ++pid) adj.at(pid) = m.adj_p2p(pid);
+        parts = graph_partition(adj, n_parts, imbalance, {}, seed);
+        if(labels) for(uint pid=0; pid<m.num_polys(); ++pid) m.poly_data(pid).label = parts.at(pid);
+    }
+    else
+    {
+        parts = graph_partition(m.vector_adj_v2v(), n_parts, imbalance, {}, seed);
+        if(labels) for(uint vid=0; vid<m.num_verts(); ++vid) m.vert_data(vid).label = parts.at(vid);
+    }
+    return parts;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<int> poly_parts_from_vert_parts(const AbstractMesh<M,V,E,P> & m,
+                                            const std::vector<int>      & v_parts)
+{
+    assert(v_parts.size()==m.num_verts());
+    std::vector<int> p_parts(m.num_polys());
+    PARALLEL_FOR(0, m.num_polys(), 1000, [&](uint pid)
+    {
+        std::vector<int> ids;
+        for(uint vid : m.adj_p2v(pid)) ids.push_back(v_parts.at(vid));
+        std::sort(ids.begin(), ids.end());
+        int  best  = ids.front();
+        uint count = 0;
+        for(uint i=0; i<ids.size(); )
+        {
+            uint j = i;
+            while(j<ids.size() && ids.at(j)==ids.at(i)) ++j;
+            if(j-i>count) { count = j-i; best = ids.at(i); }
+            i = j;
+        }
+        p_parts.at(pid) = best;
+    });
+    return p_parts;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void export_partition(const Mesh                       & m,
+                      const std::vector<int>           & p_parts,
+                      const uint                         n_halo,
+                            std::vector<Mesh>          & parts,
+                            std::vector<PartitionMaps> & maps)
+{
+    assert(p_parts.size()==m.num_polys());
+    uint n_parts = 0;
+    for(int p : p_parts) n_parts = std::max(n_parts, uint(p+1));
+
+    // lazily built adjacencies are not thread safe (see AbstractMesh::set_soup)
+    m.adjacency_require(ADJ_V2P);
+
+    // polys of each part, and owner of each vertex (the smallest incident part)
+    std::vector<std::vector<uint>> part_polys(n_parts);
+    for(uint pid=0; pid<m.num_polys(); ++pid) part_polys.at(p_parts.at(pid)).push_back(pid);
+    std::vector<int> v_owner(m.num_verts(), -1);
+    PARALLEL_FOR(0, m.num_verts(), 1000, [&](uint vid)
+    {
+        for(uint pid : m.adj_v2p(vid))
+        {
+            if(v_owner.at(vid)==-1 || p_parts.at(pid)<v_owner.at(vid)) v_owner.at(vid) = p_parts.at(pid);
+        }
+    });
+
+    parts.clear();
+    parts.resize(n_parts);
+    maps.clear();
+    maps.resize(n_parts);
+
+    PARALLEL_FOR(0, n_parts, 1, [&](uint part)
+    {
+        PartitionMaps & map = maps.at(part);
+
+        // polys: the part itself, and then the halo, one layer at a time.
+        // Ids are kept sorted to test membership by binary search
+        std::vector<uint> all_polys = part_polys.at(part);
+        std::vector<uint> layer     = all_polys;
+        std::vector<uint> layer_verts;
+        map.p_l2g   = all_polys;
+        map.p_layer = std::vector<uint>(all_polys.size(), 0);
+        for(uint l=1; l<=n_halo && !layer.empty(); ++l)
+        {
+            layer_verts.clear();
+            for(uint pid : layer) for(uint vid : m.adj_p2v(pid)) layer_verts.push_back(vid);
+            REMOVE_DUPLICATES_FROM_VEC(layer_verts); // (also sorts)
+
+            std::vector<uint> next;
+            for(uint vid : layer_verts)
+            for(uint pid : m.adj_v2p(vid))
+            {
+                if(!std::binary_search(all_polys.begin(), all_polys.end(), pid)) next.push_back(pid);
+            }
+            REMOVE_DUPLICATES_FROM_VEC(next);
+            for(uint pid : next)
+            {
+                map.p_l2g.push_back(pid);
+                map.p_layer.push_back(l);
+            }
+            std::vector<uint> tmp;
+            std::merge(all_polys.begin(), all_polys.end(), next.begin(), next.end(), std::back_inserter(tmp));
+            all_polys.swap(tmp);
+            layer.swap(next);
+        }
+        map.n_own_polys = part_polys.at(part).size();
+
+        // verts: owned first, then the others (both in global order)
+        std::vector<uint> all_verts;
+        for(uint pid : map.p_l2g) for(uint vid : m.adj_p2v(pid)) all_verts.push_back(vid);
+        REMOVE_DUPLICATES_FROM_VEC(all_verts);
+        std::vector<uint> g2l(all_verts.size());
+        map.v_l2g.reserve(all_verts.size());
+        for(uint i=0; i<all_verts.size(); ++i)
+        {
+            if(v_owner.at(all_verts.at(i))!=int(part)) continue;
+            g2l.at(i) = map.v_l2g.size();
+            map.v_l2g.push_back(all_verts.at(i));
+        }
+        map.n_own_verts = map.v_l2g.size();
+        for(uint i=0; i<all_verts.size(); ++i)
+        {
+            if(v_owner.at(all_verts.at(i))==int(part)) continue;
+            g2l.at(i) = map.v_l2g.size();
+            map.v_l2g.push_back(all_verts.at(i));
+        }
+
+        // submesh
+        std::vector<vec3d> verts;
+        verts.reserve(map.v_l2g.size());
+        for(uint vid : map.v_l2g) verts.push_back(m.vert(vid));
+        std::vector<std::vector<uint>> polys;
+        polys.reserve(map.p_l2g.size());
+        for(uint pid : map.p_l2g)
+        {
+            std::vector<uint> p;
+            for(uint vid : m.adj_p2v(pid))
+            {
+                auto it = std::lower_bound(all_verts.begin(), all_verts.end(), vid);
+                p.push_back(g2l.at(it - all_verts.begin()));
+            }
+            polys.push_back(p);
+        }
+
+        Mesh & subm = parts.at(part);
+        subm.mesh_data().update_normals = false; // normals are copied from m
+        subm.init(verts, polys);
+        subm.mesh_data().update_normals = m.mesh_data().update_normals;
+        assert(subm.num_polys()==map.p_l2g.size());
+        for(uint vid=0; vid<subm.num_verts(); ++vid) subm.vert_data(vid) = m.vert_data(map.v_l2g.at(vid));
+        for(uint pid=0; pid<subm.num_polys(); ++pid) subm.poly_data(pid) = m.poly_data(map.p_l2g.at(pid));
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void gather_partition_verts(      Mesh                       & m,
+                            const std::vector<Mesh>          & parts,
+                            const std::vector<PartitionMaps> & maps)
+{
+    assert(parts.size()==maps.size());
+    PARALLEL_FOR(0, parts.size(), 1, [&](uint part)
+    {
+        const PartitionMaps & map = maps.at(part);
+        for(uint vid=0; vid<map.n_own_verts; ++vid)
+        {
+            m.vert(map.v_l2g.at(vid)) = parts.at(part).vert(vid);
+        }
+    });
+    m.update_bbox();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<int> graph_partition(const std::vector<std::vector<uint>> & adj,
+                                 const uint                             n_parts,
+                                 const double                           imbalance,
+                                 const std::vector<double>            & weights,
+                                 const uint                             seed)
+{
+    assert(weights.empty() || weights.size()==adj.size());
+    uint n = adj.size();
+    if(n_parts<=1 || n<=n_parts)
+    {
+        std::vector<int> parts(n,0);
+        if(n_parts>1) std::iota(parts.begin(), parts.end(), 0);
+        return parts;
+    }
+
+    std::mt19937 rng(seed);
+
+    // finest level
+    std::vector<WeightedGraph> levels(1);
+    WeightedGraph & g = levels.front();
+    g.xadj.reserve(n+1);
+    g.xadj.push_back(0);
+    for(uint i=0; i<n; ++i)
+    {
+        for(uint j : adj.at(i))
+        {
+            if(j==i) continue;
+            g.adj.push_back(j);
+            g.ew.push_back(1.0);
+        }
+        g.xadj.push_back(g.adj.size());
+    }
+    g.nw = (weights.empty()) ? std::vector<double>(n,1.0) : weights;
+    double tot_weight = std::accumulate(g.nw.begin(), g.nw.end(), 0.0);
+
+    // coarsening. Heavy nodes are not matched, otherwise the coarsest graph
+    // may not admit a balanced partition
+    uint   coarsen_to = std::max(20*n_parts, uint(100));
+    double max_weight = 1.5 * tot_weight / coarsen_to;
+    std::vector<std::vector<uint>> fine2coarse;
+    while(levels.back().nw.size() > coarsen_to)
+    {
+        std::vector<uint> map;
+        WeightedGraph gc = graph_coarsen(levels.back(), max_weight, map, rng);
+        if(gc.nw.size() > 0.95*levels.back().nw.size()) break; // no longer shrinking
+        fine2coarse.push_back(map);
+        levels.push_back(gc);
+    }
+
+    // initial partitioning: best of a few randomized attempts
+    double max_part_weight = (1.0 + imbalance) * tot_weight / n_parts;
+    const WeightedGraph & gc = levels.back();
+    std::vector<int> parts;
+    double best_cut = inf_double, best_excess = inf_double;
+    for(uint i=0; i<8; ++i)
+    {
+        std::vector<int> tmp;
+        graph_grow_parts(gc, n_parts, tmp, rng);
+        graph_refine_parts(gc, n_parts, max_part_weight, tmp, rng);
+
+        std::vector<double> w(n_parts,0);
+        for(uint v=0; v<tmp.size(); ++v) w.at(tmp.at(v)) += gc.nw.at(v);
+        double excess = std::max(0.0, *std::max_element(w.begin(), w.end()) - max_part_weight);
+        double cut    = graph_edge_cut(gc, tmp);
+        if(excess<best_excess || (excess==best_excess && cut<best_cut))
+        {
+            best_excess = excess;
+            best_cut    = cut;
+            parts       = tmp;
+        }
+    }
+
+    // uncoarsening
+    for(int l=fine2coarse.size()-1; l>=0; --l)
+    {
+        const std::vector<uint> & map = fine2coarse.at(l);
+        std::vector<int> fine_parts(map.size());
+        for(uint v=0; v<map.size(); ++v) fine_parts.at(v) = parts.at(map.at(v));
+        parts.swap(fine_parts);
+        graph_refine_parts(levels.at(l), n_parts, max_part_weight, parts, rng);
+    }
+    return parts;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double graph_edge_cut(const std::vector<std::vector<uint>> & adj,
+                      const std::vector<int>               & parts)
+{
+    double cut = 0;
+    for(uint i=0; i<adj.size(); ++i)
+    for(uint j : adj.at(i))
+    {
+        if(i<j && parts.at(i)!=parts.at(j)) cut += 1.0;
+    }
+    return cut;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double graph_partition_imbalance(const std::vector<int>    & parts,
+                                 const uint                  n_parts,
+                                 const std::vector<double> & weights)
+{
+    std::vector<double> w(n_parts,0);
+    double tot = 0;
+    for(uint i=0; i<parts.size(); ++i)
+    {
+        double wi = (weights.empty()) ? 1.0 : weights.at(i);
+        w.at(parts.at(i)) += wi;
+        tot += wi;
+    }
+    return *std::max_element(w.begin(), w.end()) / (tot/n_parts);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+WeightedGraph graph_coarsen(const WeightedGraph     & g,
+                            const double              max_node_weight,
+                                  std::vector<uint> & fine2coarse,
+                                  std::mt19937      & rng)
+{
+    uint n = g.nw.size();
+    const uint unmatched = uint(-1);
+
+    // heavy edge matching, visiting nodes in random order
+    std::vector<uint> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+    std::vector<uint> match(n, unmatched);
+    for(uint u : order)
+    {
+        if(match.at(u)!=unmatched) continue;
+        uint   best   = u;
+        double best_w = -1;
+        for(uint k=g.xadj.at(u); k<g.xadj.at(u+1); ++k)
+        {
+            uint v = g.adj.at(k);
+            if(match.at(v)==unmatched && g.ew.at(k)>best_w && g.nw.at(u)+g.nw.at(v)<=max_node_weight)
+            {
+                best   = v;
+                best_w = g.ew.at(k);
+            }
+        }
+        match.at(u)    = best;
+        match.at(best) = u;
+    }
+
+    // coarse nodes are numbered following the smallest of their fine nodes
+    fine2coarse.assign(n, unmatched);
+    uint nc = 0;
+    for(uint u=0; u<n; ++u)
+    {
+        if(fine2coarse.at(u)!=unmatched) continue;
+        fine2coarse.at(u) = fine2coarse.at(match.at(u)) = nc++;
+    }
+
+    // coarse edges (parallel edges are merged, and their weights summed)
+    WeightedGraph gc;
+    gc.nw.resize(nc);
+    gc.xadj.reserve(nc+1);
+    gc.xadj.push_back(0);
+    gc.adj.reserve(g.adj.size()/2);
+    gc.ew.reserve(g.adj.size()/2);
+    std::vector<int> pos(nc,-1);
+    for(uint u=0; u<n; ++u)
+    {
+        if(match.at(u)<u) continue; // already processed with its mate
+        uint c   = fine2coarse.at(u);
+        uint beg = gc.adj.size();
+        gc.nw.at(c) = g.nw.at(u) + ((match.at(u)!=u) ? g.nw.at(match.at(u)) : 0.0);
+        for(uint w : { u, match.at(u) })
+        {
+            for(uint k=g.xadj.at(w); k<g.xadj.at(w+1); ++k)
+            {
+                uint cv = fine2coarse.at(g.adj.at(k));
+                if(cv==c) continue;
+                if(pos.at(cv)==-1)
+                {
+                    pos.at(cv) = gc.adj.size();
+                    gc.adj.push_back(cv);
+                    gc.ew.push_back(g.ew.at(k));
+                }
+                else gc.ew.at(pos.at(cv)) += g.ew.at(k);
+            }
+            if(match.at(u)==u) break;
+        }
+        for(uint k=beg; k<gc.adj.size(); ++k) pos.at(gc.adj.at(k)) = -1;
+        gc.xadj.push_back(gc.adj.size());
+    }
+    return gc;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void graph_grow_parts(const WeightedGraph    & g,
+                      const uint               n_parts,
+                            std::vector<int> & parts,
+                            std::mt19937     & rng)
+{
+    uint   n      = g.nw.size();
+    double target = std::accumulate(g.nw.begin(), g.nw.end(), 0.0) / n_parts;
+    parts.assign(n,-1);
+
+    // hop distance from a set of sources (unassigned nodes only)
+    std::vector<uint> dist(n);
+    auto farthest_unassigned = [&](const std::vector<uint> & sources) -> int
+    {
+        std::fill(dist.begin(), dist.end(), uint(-1));
+        std::queue<uint> q;
+        for(uint s : sources) { dist.at(s) = 0; q.push(s); }
+        while(!q.empty())
+        {
+            uint u = q.front(); q.pop();
+            for(uint k=g.xadj.at(u); k<g.xadj.at(u+1); ++k)
+            {
+                uint v = g.adj.at(k);
+                if(dist.at(v)==uint(-1)) { dist.at(v) = dist.at(u)+1; q.push(v); }
+            }
+        }
+        int best = -1;
+        for(uint v=0; v<n; ++v)
+        {
+            if(parts.at(v)!=-1) continue;
+            if(best==-1 || dist.at(v)>dist.at(best)) best = v; // unreachable nodes come first
+        }
+        return best;
+    };
+
+    // the first seed is (approximately) peripheral
+    std::uniform_int_distribution<uint> rnd(0,n-1);
+    int seed = farthest_unassigned({rnd(rng)});
+
+    std::vector<double> conn(n,0); // connectivity to the part being grown
+    for(uint part=0; part+1<n_parts && seed!=-1; ++part)
+    {
+        // grow the part from the seed, adding first the nodes most connected to it
+        std::priority_queue<std::pair<double,uint>> heap;
+        std::vector<uint> touched;
+        heap.push(std::make_pair(0.0,seed));
+        double w = 0;
+        while(w<target)
+        {
+            if(heap.empty())
+            {
+                // disconnected graph: jump to another component
+                int v = -1;
+                for(uint i=0; i<n; ++i) if(parts.at(i)==-1) { v = i; break; }
+                if(v==-1) break;
+                heap.push(std::make_pair(0.0,v));
+            }
+            uint u = heap.top().second;
+            double c = heap.top().first;
+            heap.pop();
+            if(parts.at(u)!=-1 || c<conn.at(u)) continue; // stale entry
+            if(w>0 && w+g.nw.at(u)-target > target-w) break; // closer to target without u
+            parts.at(u) = part;
+            w += g.nw.at(u);
+            for(uint k=g.xadj.at(u); k<g.xadj.at(u+1); ++k)
+            {
+                uint v = g.adj.at(k);
+                if(parts.at(v)!=-1) continue;
+                conn.at(v) += g.ew.at(k);
+                touched.push_back(v);
+                heap.push(std::make_pair(conn.at(v),v));
+            }
+        }
+        for(uint v : touched) conn.at(v) = 0;
+
+        // next seed: the unassigned node farthest from all the parts grown so far
+        std::vector<uint> assigned;
+        for(uint v=0; v<n; ++v) if(parts.at(v)!=-1) assigned.push_back(v);
+        seed = farthest_unassigned(assigned);
+    }
+    for(int & p : parts) if(p==-1) p = n_parts-1;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void graph_refine_parts(const WeightedGraph    & g,
+                        const uint               n_parts,
+                        const double             max_part_weight,
+                              std::vector<int> & parts,
+                              std::mt19937     & rng,
+                        const uint               max_passes)
+{
+    uint n = g.nw.size();
+    std::vector<double> pw(n_parts,0);
+    std::vector<uint>   count(n_parts,0);
+    for(uint v=0; v<n; ++v)
+    {
+        pw.at(parts.at(v)) += g.nw.at(v);
+        ++count.at(parts.at(v));
+    }
+
+    std::vector<uint>   order;
+    std::vector<double> conn(n_parts,0);
+    std::vector<uint>   nbr_parts;
+    for(uint pass=0; pass<max_passes; ++pass)
+    {
+        // only boundary nodes can move. Visiting them in random order avoids
+        // drifting all parts in the same direction
+        order.clear();
+        for(uint v=0; v<n; ++v)
+        {
+            for(uint k=g.xadj.at(v); k<g.xadj.at(v+1); ++k)
+            {
+                if(parts.at(g.adj.at(k))!=parts.at(v)) { order.push_back(v); break; }
+            }
+        }
+        std::shuffle(order.begin(), order.end(), rng);
+
+        uint n_moves = 0;
+        for(uint v : order)
+        {
+            int a = parts.at(v);
+            if(count.at(a)==1) continue; // do not empty a part
+
+            // connectivity of v with its own and adjacent parts
+            nbr_parts.clear();
+            for(uint k=g.xadj.at(v); k<g.xadj.at(v+1); ++k)
+            {
+                int q = parts.at(g.adj.at(k));
+                if(conn.at(q)==0) nbr_parts.push_back(q);
+                conn.at(q) += g.ew.at(k);
+            }
+
+            double w        = g.nw.at(v);
+            bool   overflow = pw.at(a) > max_part_weight;
+            int    best     = -1;
+            double best_gain = 0;
+            for(uint q : nbr_parts)
+            {
+                if(int(q)==a || pw.at(q)+w>max_part_weight) continue;
+                double gain = conn.at(q) - conn.at(a);
+                bool   ok   = gain>0 || (gain==0 && pw.at(q)+w<pw.at(a)) || overflow;
+                if(!ok) continue;
+                if(best==-1 || gain>best_gain || (gain==best_gain && pw.at(q)<pw.at(best)))
+                {
+                    best      = q;
+                    best_gain = gain;
+                }
+            }
+            for(uint q : nbr_parts) conn.at(q) = 0;
+            conn.at(a) = 0;
+
+            if(best!=-1)
+            {
+                parts.at(v) = best;
+                pw.at(a)    -= w;
+                pw.at(best) += w;
+                --count.at(a);
+                ++count.at(best);
+                ++n_moves;
+            }
+        }
+        if(n_moves==0) break;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double graph_edge_cut(const WeightedGraph    & g,
+                      const std::vector<int> & parts)
+{
+    double cut = 0;
+    for(uint u=0; u<g.nw.size(); ++u)
+    for(uint k=g.xadj.at(u); k<g.xadj.at(u+1); ++k)
+    {
+        uint v = g.adj.at(k);
+        if(u<v && parts.at(u)!=parts.at(v)) cut += g.ew.at(k);
+    }
+    return cut;
+}
+
+}
@@ -0,0 +1,221 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_MESH_PARTITIONING_H
+#define CINO_MESH_PARTITIONING_H
+
+#include <vector>
+#include <string>
+#include <random>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/meshes/abstract_mesh.h>
+
+/* Balanced partitioning of meshes, for domain decomposition and parallel
+ * processing. The partitioner is multilevel, in the spirit of METIS:
+ *
+ *  - coarsening: the graph is repeatedly contracted by collapsing a heavy
+ *    edge matching, until it has only a few nodes per part
+ *  - initial partitioning: parts are grown greedily on the coarsest graph,
+ *    and the best of a few randomized attempts is kept
+ *  - uncoarsening: labels are projected back level by level, and refined
+ *    at each level by greedily moving boundary nodes to the neighbor part
+ *    that reduces the edge cut the most, without exceeding the balance
+ *    constraint (or restoring it, if a part is overweight)
+ *
+ * Meshes can be partitioned through their dual graph (polys connected
+ * through edges or faces), which is what domain decomposition usually needs,
+ * or through their primal graph (verts connected through edges).
+ *
+ * Parts can then be extracted as standalone submeshes (in parallel), with
+ * any number of halo layers around them. Each submesh comes with its local
+ * to global id maps, and lists owned elements first, so that each thread can
+ * process its part and write back only the elements it owns.
+*/
+
+namespace cinolib
+{
+
+typedef enum
+{
+    PARTITION_DUAL   , // labels polys (graph of polys adjacent through edges/faces)
+    PARTITION_PRIMAL , // labels verts (graph of verts adjacent through edges)
+}
+PartitionGraph;
+
+static const std::string partition_graph_txt[2] =
+{
+    "PARTITION_DUAL"  ,
+    "PARTITION_PRIMAL",
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// local to global maps of a part extracted with export_partition. Owned elements
+// come first, in global order: polys [0,n_own_polys) are the ones labeled with the
+// part id, the others form the halo. Verts [0,n_own_verts) are owned by the part
+// (a vertex shared by many parts is owned by the one with smallest id)
+//
+typedef struct
+{
+    std::vector<uint> v_l2g;           // local to global vert ids
+    std::vector<uint> p_l2g;           // local to global poly ids
+    std::vector<uint> p_layer;         // 0 for owned polys, i for polys in the i-th halo layer
+    uint              n_own_verts = 0;
+    uint              n_own_polys = 0;
+}
+PartitionMaps;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// weighted graph in compressed sparse row format, used by the multilevel partitioner.
+// Neighbors of node i are adj[xadj[i]] ... adj[xadj[i+1]-1], with weights ew[...]
+//
+typedef struct
+{
+    std::vector<uint>   xadj;
+    std::vector<uint>   adj;
+    std::vector<double> ew; // edge weights
+    std::vector<double> nw; // node weights
+}
+WeightedGraph;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// splits the polys (PARTITION_DUAL) or the verts (PARTITION_PRIMAL) of m in n_parts
+// parts, and returns the part id of each element. Parts weight at most (1+imbalance)
+// times the average. If labels is true, part ids are also copied in the element labels
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<int> mesh_partition(      AbstractMesh<M,V,E,P> & m,
+                                const uint                    n_parts,
+                                const PartitionGraph          graph     = PARTITION_DUAL,
+                                const double                  imbalance = 0.03,
+                                const bool                    labels    = true,
+                                const uint                    seed      = 0);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// assigns each poly to the part where most of its verts are (ties are broken in
+// favor of the smallest id). Used to extract parts from a primal partition
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<int> poly_parts_from_vert_parts(const AbstractMesh<M,V,E,P> & m,
+                                            const std::vector<int>      & v_parts);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// extracts all the parts defined by p_parts (one part id per poly, in [0,n_parts)),
+// each grown with n_halo layers of polys sharing a vertex with the previous layer
+// (one layer is enough to have the full one ring of each owned vertex). Mesh is any
+// concrete mesh type that can be initialized from a list of verts and polys (i.e.,
+// surface meshes, tetmeshes and hexmeshes). Vert and poly attributes are copied
+//
+template<class Mesh>
+CINO_INLINE
+void export_partition(const Mesh                       & m,
+                      const std::vector<int>           & p_parts,
+                      const uint                         n_halo,
+                            std::vector<Mesh>          & parts,
+                            std::vector<PartitionMaps> & maps);
+
+// writes the positions of the verts owned by each part back into m
+//
+template<class Mesh>
+CINO_INLINE
+void gather_partition_verts(      Mesh                       & m,
+                            const std::vector<Mesh>          & parts,
+                            const std::vector<PartitionMaps> & maps);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// multilevel partitioning of a generic graph (adjacency lists are assumed to be
+// symmetric). Node weights are all one if not specified
+//
+CINO_INLINE
+std::vector<int> graph_partition(const std::vector<std::vector<uint>> & adj,
+                                 const uint                             n_parts,
+                                 const double                           imbalance = 0.03,
+                                 const std::vector<double>            & weights   = {},
+                                 const uint                             seed      = 0);
+
+CINO_INLINE
+double graph_edge_cut(const std::vector<std::vector<uint>> & adj,
+                      const std::vector<int>               & parts);
+
+// max part weight divided by the average part weight (1 means perfect balance)
+//
+CINO_INLINE
+double graph_partition_imbalance(const std::vector<int>    & parts,
+                                 const uint                  n_parts,
+                                 const std::vector<double> & weights = {});
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// building blocks of the multilevel scheme
+//
+CINO_INLINE
+WeightedGraph graph_coarsen(const WeightedGraph     & g,
+                            const double              max_node_weight,
+                                  std::vector<uint> & fine2coarse,
+                                  std::mt19937      & rng);
+
+CINO_INLINE
+void graph_grow_parts(const WeightedGraph    & g,
+                      const uint               n_parts,
+                            std::vector<int> & parts,
+                            std::mt19937     & rng);
+
+CINO_INLINE
+void graph_refine_parts(const WeightedGraph    & g,
+                        const uint               n_parts,
+                        const double             max_part_weight,
+                              std::vector<int> & parts,
+                              std::mt19937     & rng,
+                        const uint               max_passes = 10);
+
+CINO_INLINE
+double graph_edge_cut(const WeightedGraph    & g,
+                      const std::vector<int> & parts);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "mesh_partitioning.cpp"
+#endif
+
+#endif // CINO_MESH_PARTITIONING_H
@@ -85,6 +85,10 @@ void AbstractMesh<M,V,E,P>::clear()
     v_data.clear();
     e_data.clear();
     p_data.clear();
+    v_props.clear();
+    e_props.clear();
+    p_props.clear();
+    adj_todo = 0;
     //
     v2v.clear();
     v2e.clear();
@@ -92,6 +96,67 @@ void AbstractMesh<M,V,E,P>::clear()
     e2p.clear();
     p2e.clear();
     p2p.clear();
+    //
+    v_dirty.clear();
+    reset_spatial_indices();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::permute(const MeshIdMaps & id_maps)
+{
+    // note: the content of polys is either a list of verts or a list of faces,
+    // hence it is remapped by the derived classes. Here only its order changes
+    adjacency_require(ADJ_ALL);
+
+    const std::vector<int> & v_map = id_maps.v_map;
+    const std::vector<int> & e_map = id_maps.e_map;
+    const std::vector<int> & p_map = id_maps.p_map;
+
+    if(!v_map.empty())
+    {
+        assert(v_map.size()==num_verts());
+        PERMUTE_VEC(verts,  v_map);
+        PERMUTE_VEC(v_data, v_map);
+        v_props.permute(v_map);
+        PERMUTE_VEC(v2v,    v_map);
+        PERMUTE_VEC(v2e,    v_map);
+        PERMUTE_VEC(v2p,    v_map);
+        for(auto & l : v2v) REMAP_VEC(l, v_map);
+        REMAP_VEC(edges,   v_map);
+        REMAP_VEC(v_dirty, v_map);
+    }
+    if(!e_map.empty())
+    {
+        assert(e_map.size()==num_edges());
+        std::vector<uint> tmp(edges.size());
+        for(uint eid=0; eid<num_edges(); ++eid)
+        {
+            tmp.at(2*e_map.at(eid)  ) = edges.at(2*eid  );
+            tmp.at(2*e_map.at(eid)+1) = edges.at(2*eid+1);
+        }
+        edges.swap(tmp);
+        PERMUTE_VEC(e_data, e_map);
+        e_props.permute(e_map);
+        PERMUTE_VEC(e2p,    e_map);
+        for(auto & l : v2e) REMAP_VEC(l, e_map);
+        for(auto & l : p2e) REMAP_VEC(l, e_map);
+    }
+    if(!p_map.empty())
+    {
+        assert(p_map.size()==num_polys());
+        PERMUTE_VEC(polys,  p_map);
+        PERMUTE_VEC(p_data, p_map);
+        p_props.permute(p_map);
+        PERMUTE_VEC(p2e,    p_map);
+        PERMUTE_VEC(p2p,    p_map);
+        for(auto & l : v2p) REMAP_VEC(l, p_map);
+        for(auto & l : e2p) REMAP_VEC(l, p_map);
+        for(auto & l : p2p) REMAP_VEC(l, p_map);
+    }
+    reset_spatial_indices();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -115,6 +180,7 @@ void AbstractMesh<M,V,E,P>::translate(const vec3d & delta)
     for(uint vid=0; vid<num_verts(); ++vid) vert(vid) += delta;
     bb.min += delta;
     bb.max += delta;
+    reset_spatial_indices();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -134,6 +200,7 @@ void AbstractMesh<M,V,E,P>::rotate(const vec3d & axis, const double angle)
         transform(vert(vid), R);
         vert(vid) += c;
     }
+    reset_spatial_indices();
     //
     if(m_data.update_bbox)    update_bbox();
     if(m_data.update_normals) update_normals();
@@ -149,6 +216,7 @@ void AbstractMesh<M,V,E,P>::scale(const double scale_factor)
     translate(-c);
     for(uint vid=0; vid<num_verts(); ++vid) vert(vid) *= scale_factor;
     translate(c);
+    reset_spatial_indices();
     if(m_data.update_bbox) update_bbox();
 }
 
@@ -160,6 +228,7 @@ void AbstractMesh<M,V,E,P>::normalize_bbox()
 {
     double s = 1.0/bbox().diag();
     for(uint vid=0; vid<num_verts(); ++vid) vert(vid) *= s;
+    reset_spatial_indices();
     if(m_data.update_bbox) update_bbox();
 }
 
@@ -170,6 +239,7 @@ CINO_INLINE
 void AbstractMesh<M,V,E,P>::update_bbox()
 {
     bb.update(this->verts);
+    reset_spatial_indices();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -649,6 +719,7 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractMesh<M,V,E,P>::edge_vert_id(const uint eid, const uint offset) const
 {
+    adjacency_require(ADJ_EDGES);
     uint   eid_ptr = eid * 2;
     return edges.at(eid_ptr + offset);
 }
@@ -1224,10 +1295,10 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractMesh<M,V,E,P>::pick_vert(const vec3d & p) const
 {
-    std::vector<std::pair<double,uint>> closest;
-    for(uint vid=0; vid<this->num_verts(); ++vid) closest.push_back(std::make_pair(this->vert(vid).dist(p),vid));
-    std::sort(closest.begin(), closest.end());
-    return closest.front().second;
+    if(kd_verts.size()!=this->num_verts()) kd_verts.build(this->verts);
+    int vid = kd_verts.nearest(p);
+    assert(vid>=0);
+    return vid;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1236,10 +1307,15 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractMesh<M,V,E,P>::pick_edge(const vec3d & p) const
 {
-    std::vector<std::pair<double,uint>> closest;
-    for(uint eid=0; eid<this->num_edges(); ++eid) closest.push_back(std::make_pair(this->edge_sample_at(eid, 0.5).dist(p),eid));
-    std::sort(closest.begin(), closest.end());
-    return closest.front().second;
+    if(kd_edges.size()!=this->num_edges())
+    {
+        std::vector<vec3d> midpoints(this->num_edges());
+        for(uint eid=0; eid<this->num_edges(); ++eid) midpoints[eid] = this->edge_sample_at(eid, 0.5);
+        kd_edges.build(midpoints);
+    }
+    int eid = kd_edges.nearest(p);
+    assert(eid>=0);
+    return eid;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1248,11 +1324,27 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractMesh<M,V,E,P>::pick_poly(const vec3d & p) const
 {
-    std::vector<std::pair<double,uint>> closest;
-    for(uint pid=0; pid<this->num_polys(); ++pid)
-        if(!this->poly_data(pid).flags[HIDDEN]) closest.push_back(std::make_pair(this->poly_centroid(pid).dist(p),pid));
-    std::sort(closest.begin(), closest.end());
-    return closest.front().second;
+    if(kd_polys.size()!=this->num_polys())
+    {
+        std::vector<vec3d> centroids(this->num_polys());
+        for(uint pid=0; pid<this->num_polys(); ++pid) centroids[pid] = this->poly_centroid(pid);
+        kd_polys.build(centroids);
+    }
+    // hidden polys are skipped at query time, so that hiding/showing polys does not require a rebuild
+    int pid = kd_polys.nearest(p, [this](const uint pid) { return this->poly_data(pid).flags[HIDDEN]; });
+    assert(pid>=0);
+    return pid;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::reset_spatial_indices()
+{
+    kd_verts.clear();
+    kd_edges.clear();
+    kd_polys.clear();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -45,6 +45,8 @@
 #include <cinolib/color.h>
 #include <cinolib/symbols.h>
 #include <cinolib/ipair.h>
+#include <cinolib/kd_tree.h>
+#include <cinolib/meshes/mesh_properties.h>
 
 typedef enum
 {
@@ -61,6 +63,30 @@ MeshType;
 namespace cinolib
 {
 
+// old to new element ids, filled by the batched editing operators (e.g. Trimesh::edges_split).
+// Deleted elements map to -1, merged vertices map to the vertex they were merged into
+typedef struct
+{
+    std::vector<int> v_map;
+    std::vector<int> e_map;
+    std::vector<int> f_map; // (only for volume meshes!)
+    std::vector<int> p_map;
+}
+MeshIdMaps;
+
+// adjacency relations that "soup" meshes compute on demand (see AbstractMesh::set_soup)
+typedef enum
+{
+    ADJ_V2P   = 0x1, // vert to poly
+    ADJ_EDGES = 0x2, // edges, and all relations involving them (v2v, v2e, e2p, p2e)
+    ADJ_P2P   = 0x4, // poly to poly (built along with faces for volume meshes)
+    ADJ_FACES = 0x8, // faces, and all relations involving them (only for volume meshes!)
+    ADJ_ALL   = 0xF,
+}
+AdjacencyRelation;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, // mesh attributes
          class V, // vert attributes
          class E, // edge attributes
@@ -80,6 +106,10 @@ class AbstractMesh
         std::vector<E> e_data;
         std::vector<P> p_data;
 
+        PropertySet v_props; // runtime attribute layers (see mesh_properties.h)
+        PropertySet e_props;
+        PropertySet p_props;
+
         std::vector<std::vector<uint>> v2v; // vert to vert adjacency
         std::vector<std::vector<uint>> v2e; // vert to edge adjacency
         std::vector<std::vector<uint>> v2p; // vert to poly adjacency
@@ -87,6 +117,16 @@ class AbstractMesh
         std::vector<std::vector<uint>> p2e; // poly to edge adjacency
         std::vector<std::vector<uint>> p2p; // poly to poly adjacency
 
+        std::vector<uint> v_dirty; // verts moved since the last call to update_dirty() (may contain duplicates)
+
+        bool        soup     = false; // if true, init() stores only positions and elements (see set_soup)
+        mutable int adj_todo = 0;     // relations not computed yet (bitmask of AdjacencyRelation)
+
+        // spatial indices for picking, built at the first query and discarded by reset_spatial_indices()
+        mutable KdTree kd_verts; // vert positions
+        mutable KdTree kd_edges; // edge midpoints
+        mutable KdTree kd_polys; // poly centroids
+
     public:
 
         typedef M M_type;
@@ -111,6 +151,34 @@ class AbstractMesh
         virtual void load(const char * filename) = 0;
         virtual void save(const char * filename) const = 0;
 
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // relabels mesh elements, moving each element to the position given in id_maps (old to new ids).
+        // Maps must be permutations (empty maps leave the corresponding elements untouched). Positions,
+        // attributes and all adjacencies are rewritten in a single pass, without recomputing anything.
+        // Drawable meshes must call updateGL() afterwards. See reorder.h for permutations that improve locality
+        virtual void permute(const MeshIdMaps & id_maps);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // Connectivity-free ("soup") mode. If enabled before loading (or initializing) a mesh,
+        // only positions and element lists are stored, which is enough for IO, rendering and
+        // per element quantities. Adjacencies are computed the first time they are accessed,
+        // one relation at a time (e.g. adj_v2p() does not compute edges), and topology editing
+        // operators compute all the missing relations before doing anything else. Relations
+        // that depend on others pull them in: p2p needs edges on polygon meshes, while on
+        // volume meshes faces need edges, and p2p comes with faces. Lazy builds
+        // are not thread safe: call adjacency_require() before accessing a soup in parallel
+        // (library functions that query adjacency from parallel loops already do so)
+        void set_soup(const bool b) { soup = b;         }
+        bool is_soup()        const { return soup;      }
+        bool adjacency_todo() const { return adj_todo;  } // true if some relation is still missing
+        void adjacency_require(const int relations) const
+        {
+            // adjacencies are a cache of the element lists, hence they can be filled from const methods
+            if(adj_todo & relations) const_cast<AbstractMesh*>(this)->adjacency_build(adj_todo & relations);
+        }
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
                 void update_bbox();
@@ -133,12 +201,12 @@ class AbstractMesh
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         virtual uint verts_per_poly(const uint pid) const = 0;
-        virtual uint edges_per_poly(const uint pid) const { return this->p2e.at(pid).size(); }
+        virtual uint edges_per_poly(const uint pid) const { adjacency_require(ADJ_EDGES); return this->p2e.at(pid).size(); }
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         uint num_verts() const { return verts.size();     }
-        uint num_edges() const { return edges.size() / 2; }
+        uint num_edges() const { adjacency_require(ADJ_EDGES); return edges.size() / 2; }
         uint num_polys() const { return polys.size();     }
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -146,10 +214,11 @@ class AbstractMesh
         const AABB                           & bbox()          const { return bb;    }
         const std::vector<vec3d>             & vector_verts()  const { return verts; }
               std::vector<vec3d>             & vector_verts()        { return verts; }
-        const std::vector<uint>              & vector_edges()  const { return edges; }
-              std::vector<uint>              & vector_edges()        { return edges; }
-        const std::vector<std::vector<uint>> & vector_polys()  const { return polys; }
-              std::vector<std::vector<uint>> & vector_polys()        { return polys; }
+        const std::vector<uint>              & vector_edges()  const { adjacency_require(ADJ_EDGES); return edges; }
+              std::vector<uint>              & vector_edges()        { adjacency_require(ADJ_EDGES); return edges; }
+        const std::vector<std::vector<uint>> & vector_polys()  const { adjacency_require(ADJ_FACES); return polys; } // (faces for volume meshes)
+              std::vector<std::vector<uint>> & vector_polys()        { adjacency_require(ADJ_FACES); return polys; }
+        const std::vector<std::vector<uint>> & vector_adj_v2v() const { adjacency_require(ADJ_EDGES); return v2v; }
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -174,20 +243,20 @@ class AbstractMesh
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-                const std::vector<uint> & adj_v2v(const uint vid) const { return v2v.at(vid); }
-                      std::vector<uint> & adj_v2v(const uint vid)       { return v2v.at(vid); }
-                const std::vector<uint> & adj_v2e(const uint vid) const { return v2e.at(vid); }
-                      std::vector<uint> & adj_v2e(const uint vid)       { return v2e.at(vid); }
-                const std::vector<uint> & adj_v2p(const uint vid) const { return v2p.at(vid); }
-                      std::vector<uint> & adj_v2p(const uint vid)       { return v2p.at(vid); }
+                const std::vector<uint> & adj_v2v(const uint vid) const { adjacency_require(ADJ_EDGES); return v2v.at(vid); }
+                      std::vector<uint> & adj_v2v(const uint vid)       { adjacency_require(ADJ_EDGES); return v2v.at(vid); }
+                const std::vector<uint> & adj_v2e(const uint vid) const { adjacency_require(ADJ_EDGES); return v2e.at(vid); }
+                      std::vector<uint> & adj_v2e(const uint vid)       { adjacency_require(ADJ_EDGES); return v2e.at(vid); }
+                const std::vector<uint> & adj_v2p(const uint vid) const { adjacency_require(ADJ_V2P);   return v2p.at(vid); }
+                      std::vector<uint> & adj_v2p(const uint vid)       { adjacency_require(ADJ_V2P);   return v2p.at(vid); }
                       std::vector<uint>   adj_e2v(const uint eid) const;
                       std::vector<uint>   adj_e2e(const uint eid) const;
-                const std::vector<uint> & adj_e2p(const uint eid) const { return e2p.at(eid); }
-                      std::vector<uint> & adj_e2p(const uint eid)       { return e2p.at(eid); }
-                const std::vector<uint> & adj_p2e(const uint pid) const { return p2e.at(pid); }
-                      std::vector<uint> & adj_p2e(const uint pid)       { return p2e.at(pid); }
-                const std::vector<uint> & adj_p2p(const uint pid) const { return p2p.at(pid); }
-                      std::vector<uint> & adj_p2p(const uint pid)       { return p2p.at(pid); }
+                const std::vector<uint> & adj_e2p(const uint eid) const { adjacency_require(ADJ_EDGES); return e2p.at(eid); }
+                      std::vector<uint> & adj_e2p(const uint eid)       { adjacency_require(ADJ_EDGES); return e2p.at(eid); }
+                const std::vector<uint> & adj_p2e(const uint pid) const { adjacency_require(ADJ_EDGES); return p2e.at(pid); }
+                      std::vector<uint> & adj_p2e(const uint pid)       { adjacency_require(ADJ_EDGES); return p2e.at(pid); }
+                const std::vector<uint> & adj_p2p(const uint pid) const { adjacency_require(ADJ_P2P);   return p2p.at(pid); }
+                      std::vector<uint> & adj_p2p(const uint pid)       { adjacency_require(ADJ_P2P);   return p2p.at(pid); }
         virtual const std::vector<uint> & adj_p2v(const uint pid) const = 0;
         virtual       std::vector<uint> & adj_p2v(const uint pid)       = 0;
 
@@ -197,22 +266,34 @@ class AbstractMesh
               M & mesh_data()                     { return m_data;         }
         const V & vert_data(const uint vid) const { return v_data.at(vid); }
               V & vert_data(const uint vid)       { return v_data.at(vid); }
-        const E & edge_data(const uint eid) const { return e_data.at(eid); }
-              E & edge_data(const uint eid)       { return e_data.at(eid); }
+        const E & edge_data(const uint eid) const { adjacency_require(ADJ_EDGES); return e_data.at(eid); }
+              E & edge_data(const uint eid)       { adjacency_require(ADJ_EDGES); return e_data.at(eid); }
         const P & poly_data(const uint pid) const { return p_data.at(pid); }
               P & poly_data(const uint pid)       { return p_data.at(pid); }
 
+        const PropertySet & vert_properties() const { return v_props; }
+              PropertySet & vert_properties()       { return v_props; }
+        const PropertySet & edge_properties() const { adjacency_require(ADJ_EDGES); return e_props; }
+              PropertySet & edge_properties()       { adjacency_require(ADJ_EDGES); return e_props; }
+        const PropertySet & poly_properties() const { return p_props; }
+              PropertySet & poly_properties()       { return p_props; }
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        // useful for GUIs with mouse picking
-        uint pick_vert(const vec3d & p) const;
-        uint pick_edge(const vec3d & p) const;
-        uint pick_poly(const vec3d & p) const;
+        // useful for GUIs with mouse picking. Queries are accelerated with kd-trees, which are
+        // built at the first query and discarded whenever topology changes, update_bbox() is
+        // called, or the mesh is moved with translate(), rotate(), scale() or normalize_bbox().
+        // Positions written directly through vert(vid) are not tracked: after such writes call
+        // reset_spatial_indices() (or update_bbox()), or mark the moved verts with vert_set_dirty()
+                uint pick_vert(const vec3d & p) const;
+                uint pick_edge(const vec3d & p) const;
+                uint pick_poly(const vec3d & p) const;
+        virtual void reset_spatial_indices();
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
           const vec3d          & vert                       (const uint vid) const { return verts.at(vid); }
-                vec3d          & vert                       (const uint vid)       { return verts.at(vid); }
+                vec3d          & vert                       (const uint vid)       { return verts.at(vid); } // see reset_spatial_indices()
                 void             vert_weights_uniform       (const uint vid, std::vector<std::pair<uint,double>> & wgts) const;
                 std::set<uint>   vert_n_ring                (const uint vid, const uint n) const;
                 bool             verts_are_adjacent         (const uint vid0, const uint vid1) const;
@@ -232,6 +313,7 @@ class AbstractMesh
         virtual void             vert_weights               (const uint vid, const int type, std::vector<std::pair<uint,double>> & wgts) const;
                 void             vert_set_flag              (const int flag, const bool b);
                 void             vert_set_flag              (const int flag, const bool b, const std::vector<uint> & vids);
+                void             vert_set_dirty             (const uint vid) { v_dirty.push_back(vid); reset_spatial_indices(); } // see update_dirty()
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -292,6 +374,13 @@ class AbstractMesh
         virtual void               poly_set_color             (const Color & c);
         virtual void               poly_set_alpha             (const float alpha);
         virtual void               poly_export_element        (const uint pid, std::vector<vec3d> & verts, std::vector<std::vector<uint>> & faces) const = 0;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    protected:
+
+        // computes (at least) the given relations, and removes them from adj_todo (see set_soup)
+        virtual void adjacency_build(const int relations) = 0;
 };
 
 }
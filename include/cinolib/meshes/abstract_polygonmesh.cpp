@@ -42,6 +42,7 @@
 #include <cinolib/vector_serialization.h>
 #include <cinolib/how_many_seconds.h>
 #include <cinolib/deg_rad.h>
+#include <cinolib/parallel_for.h>
 #include <unordered_set>
 #include <queue>
 
@@ -149,11 +150,69 @@ void AbstractPolygonMesh<M,V,E,P>::clear()
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::reset_spatial_indices()
+{
+    AbstractMesh<M,V,E,P>::reset_spatial_indices();
+    bvh_polys.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::permute(const MeshIdMaps & id_maps)
+{
+    AbstractMesh<M,V,E,P>::permute(id_maps);
+
+    if(!id_maps.p_map.empty()) PERMUTE_VEC(poly_triangles, id_maps.p_map);
+    if(!id_maps.v_map.empty())
+    {
+        for(auto & p : this->polys)     REMAP_VEC(p, id_maps.v_map);
+        for(auto & t : poly_triangles)  REMAP_VEC(t, id_maps.v_map);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+int AbstractPolygonMesh<M,V,E,P>::pick_poly(const vec3d & ray_orig, const vec3d & ray_dir) const
+{
+    if(bvh_polys.empty())
+    {
+        std::vector<vec3d> tri_verts;
+        std::vector<uint>  tri_ids;
+        for(uint pid=0; pid<this->num_polys(); ++pid)
+        {
+            for(uint vid : this->poly_tessellation(pid)) tri_verts.push_back(this->vert(vid));
+            for(uint i=0; i<this->poly_tessellation(pid).size()/3; ++i) tri_ids.push_back(pid);
+        }
+        bvh_polys.build(tri_verts, tri_ids);
+    }
+    double t;
+    uint   pid;
+    if(bvh_polys.intersects_ray(ray_orig, ray_dir, t, pid, [this](const uint pid) { return this->poly_data(pid).flags[HIDDEN]; }))
+    {
+        return pid;
+    }
+    return -1;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::init(const std::vector<vec3d>             & verts,
                                         const std::vector<std::vector<uint>> & polys)
 {
+    if(this->soup)
+    {
+        init_soup(verts, polys);
+        return;
+    }
+
     std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
 
     // pre-allocate memory
@@ -170,6 +229,9 @@ void AbstractPolygonMesh<M,V,E,P>::init(const std::vector<vec3d>             & v
     this->p2p.reserve(np);
     this->v_data.reserve(nv);
     this->e_data.reserve(ne);
+    this->v_props.reserve(nv);
+    this->e_props.reserve(ne);
+    this->p_props.reserve(np);
     this->p_data.reserve(np);
 
     // initialize mesh connectivity (and normals)
@@ -196,6 +258,148 @@ void AbstractPolygonMesh<M,V,E,P>::init(const std::vector<vec3d>             & v
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::init_soup(const std::vector<vec3d>             & verts,
+                                             const std::vector<std::vector<uint>> & polys)
+{
+    std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+
+    uint nv = verts.size(), np = polys.size();
+    this->verts = verts;
+    this->polys = polys;
+    this->v_data.resize(nv);
+    this->p_data.resize(np);
+    this->v_props.resize(nv);
+    this->p_props.resize(np);
+    this->poly_triangles.resize(np);
+
+    // NOTE: differently from poly_add, duplicated polygons are not detected
+    PARALLEL_FOR(0, np, 1000, [this](uint pid)
+    {
+        if(this->mesh_data().update_normals) update_p_normal(pid);
+        update_p_tessellation(pid);
+    });
+
+    // vertex normals are accumulated directly from the polygons, so that no v2p is needed
+    if(this->mesh_data().update_normals)
+    {
+        for(uint pid=0; pid<np; ++pid)
+        for(uint vid : this->polys.at(pid))
+        {
+            this->v_data.at(vid).normal += this->p_data.at(pid).normal;
+        }
+        for(auto & v : this->v_data) if(v.normal.length()>0) v.normal.normalize();
+    }
+
+    this->copy_xyz_to_uvw(UVW_param);
+    if(this->mesh_data().update_bbox) this->update_bbox();
+
+    this->adj_todo = ADJ_V2P | ADJ_EDGES | ADJ_P2P;
+
+    std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+
+    std::cout << "load soup\t"     <<
+                 this->num_verts() << "V / " <<
+                 this->num_polys() << "P  [" <<
+                 how_many_seconds(t0,t1) << "s]" << std::endl;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::adjacency_build(const int relations)
+{
+    int todo = relations & this->adj_todo;
+    if(todo & ADJ_P2P) todo |= (ADJ_EDGES & this->adj_todo); // p2p is derived from e2p
+    if(!todo) return;
+
+    uint nv = this->num_verts();
+    uint np = this->num_polys();
+
+    if(todo & ADJ_V2P)
+    {
+        std::vector<uint> valence(nv,0);
+        for(const auto & p : this->polys) for(uint vid : p) ++valence.at(vid);
+        this->v2p.assign(nv, std::vector<uint>());
+        for(uint vid=0; vid<nv; ++vid) this->v2p.at(vid).reserve(valence.at(vid));
+        for(uint pid=0; pid<np; ++pid)
+        for(uint vid : this->polys.at(pid))
+        {
+            this->v2p.at(vid).push_back(pid);
+        }
+    }
+
+    if(todo & ADJ_EDGES)
+    {
+        // edges are numbered in order of first appearance, exactly as poly_add would do,
+        // so that a soup that builds its edges has the same ids of a regularly loaded mesh
+        this->edges.clear();
+        this->v2v.assign(nv, std::vector<uint>());
+        this->v2e.assign(nv, std::vector<uint>());
+        this->e2p.clear();
+        this->p2e.assign(np, std::vector<uint>());
+        for(uint pid=0; pid<np; ++pid)
+        {
+            const std::vector<uint> & p = this->polys.at(pid);
+            this->p2e.at(pid).reserve(p.size());
+            for(uint i=0; i<p.size(); ++i)
+            {
+                uint vid0 = p.at(i);
+                uint vid1 = p.at((i+1)%p.size());
+                int  eid  = -1;
+                for(uint j=0; j<this->v2v.at(vid0).size(); ++j)
+                {
+                    if(this->v2v.at(vid0).at(j)==vid1) { eid = this->v2e.at(vid0).at(j); break; }
+                }
+                if(eid==-1)
+                {
+                    eid = this->e2p.size();
+                    this->edges.push_back(vid0);
+                    this->edges.push_back(vid1);
+                    this->e2p.push_back(std::vector<uint>());
+                    this->v2v.at(vid0).push_back(vid1);
+                    this->v2v.at(vid1).push_back(vid0);
+                    this->v2e.at(vid0).push_back(eid);
+                    this->v2e.at(vid1).push_back(eid);
+                }
+                this->e2p.at(eid).push_back(pid);
+                this->p2e.at(pid).push_back(eid);
+            }
+        }
+        uint ne = this->e2p.size();
+        this->e_data.assign(ne, E());
+        this->e_props.resize(0);
+        this->e_props.resize(ne);
+        this->adj_todo &= ~ADJ_EDGES;
+
+        for(uint eid=0; eid<ne; ++eid)
+        {
+            this->e_data.at(eid).flags[MARKED] = (this->edge_is_boundary(eid) || !this->edge_is_manifold(eid));
+        }
+    }
+
+    if(todo & ADJ_P2P)
+    {
+        // same neighbor order of poly_add: each poly lists the neighbors that precede it
+        // (in order of shared edge) and then the ones that follow it (in id order)
+        this->p2p.assign(np, std::vector<uint>());
+        for(uint pid=0; pid<np; ++pid)
+        for(uint eid : this->p2e.at(pid))
+        for(uint nbr : this->e2p.at(eid))
+        {
+            if(nbr>=pid || CONTAINS_VEC(this->p2p.at(pid), nbr)) continue;
+            this->p2p.at(nbr).push_back(pid);
+            this->p2p.at(pid).push_back(nbr);
+        }
+    }
+
+    this->adj_todo &= ~todo;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::init(      std::vector<vec3d>             & pos,       // vertex xyz positions
@@ -353,10 +557,10 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::update_p_normals()
 {
-    for(uint pid=0; pid<this->num_polys(); ++pid)
+    PARALLEL_FOR(0, this->num_polys(), 1000, [this](uint pid)
     {
         update_p_normal(pid);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -365,10 +569,10 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::update_p_tessellations()
 {
-    for(uint pid=0; pid<this->num_polys(); ++pid)
+    PARALLEL_FOR(0, this->num_polys(), 1000, [this](uint pid)
     {
         update_p_tessellation(pid);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -377,10 +581,11 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::update_v_normals()
 {
-    for(uint vid=0; vid<this->num_verts(); ++vid)
+    this->adjacency_require(ADJ_V2P);
+    PARALLEL_FOR(0, this->num_verts(), 1000, [this](uint vid)
     {
         update_v_normal(vid);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -395,6 +600,40 @@ void AbstractPolygonMesh<M,V,E,P>::update_normals()
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::update_dirty()
+{
+    // polygons incident to a moved vertex need new tessellation and normal.
+    // Then, vertex normals must be updated for all the vertices of such polygons
+    std::vector<uint> pids;
+    for(uint vid : this->v_dirty)
+    {
+        if(vid>=this->num_verts()) continue; // vert removed after being marked
+        for(uint pid : this->adj_v2p(vid)) pids.push_back(pid);
+    }
+    REMOVE_DUPLICATES_FROM_VEC(pids);
+
+    PARALLEL_FOR(0, pids.size(), 1000, [&](uint i)
+    {
+        update_p_tessellation(pids[i]);
+        update_p_normal(pids[i]);
+    });
+
+    std::vector<uint> vids;
+    for(uint pid : pids) for(uint vid : this->adj_p2v(pid)) vids.push_back(vid);
+    REMOVE_DUPLICATES_FROM_VEC(vids);
+
+    PARALLEL_FOR(0, vids.size(), 1000, [&](uint i)
+    {
+        update_v_normal(vids[i]);
+    });
+
+    this->v_dirty.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 int AbstractPolygonMesh<M,V,E,P>::Euler_characteristic() const
@@ -856,12 +1095,15 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractPolygonMesh<M,V,E,P>::vert_add(const vec3d & pos)
 {
+    this->adjacency_require(ADJ_ALL);
+    this->reset_spatial_indices();
     uint vid = this->num_verts();
     //
     this->verts.push_back(pos);
     //
     V data;
     this->v_data.push_back(data);
+    this->v_props.push_back();
     //
     this->v2v.push_back(std::vector<uint>());
     this->v2e.push_back(std::vector<uint>());
@@ -906,12 +1148,14 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::vert_switch_id(const uint vid0, const uint vid1)
 {
+    this->adjacency_require(ADJ_ALL);
     // [28 Aug 2017] Tested on 10K random id switches : PASSED
 
     if (vid0 == vid1) return;
 
     std::swap(this->verts.at(vid0),  this->verts.at(vid1));
     std::swap(this->v_data.at(vid0), this->v_data.at(vid1));
+    this->v_props.swap(vid0, vid1);
     std::swap(this->v2v.at(vid0),    this->v2v.at(vid1));
     std::swap(this->v2e.at(vid0),    this->v2e.at(vid1));
     std::swap(this->v2p.at(vid0),    this->v2p.at(vid1));
@@ -977,12 +1221,15 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::vert_remove_unreferenced(const uint vid)
 {
+    this->adjacency_require(ADJ_ALL);
+    this->reset_spatial_indices();
     this->v2v.at(vid).clear();
     this->v2e.at(vid).clear();
     this->v2p.at(vid).clear();
     vert_switch_id(vid, this->num_verts()-1);
     this->verts.pop_back();
     this->v_data.pop_back();
+    this->v_props.pop_back();
     this->v2v.pop_back();
     this->v2e.pop_back();
     this->v2p.pop_back();
@@ -1073,6 +1320,8 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractPolygonMesh<M,V,E,P>::edge_add(const uint vid0, const uint vid1)
 {
+    this->adjacency_require(ADJ_ALL);
+    this->reset_spatial_indices();
     assert(this->edge_id(vid0, vid1)==-1); // make sure it doesn't exist already
     assert(vid0 < this->num_verts());
     assert(vid1 < this->num_verts());
@@ -1089,6 +1338,7 @@ uint AbstractPolygonMesh<M,V,E,P>::edge_add(const uint vid0, const uint vid1)
     //
     E data;
     this->e_data.push_back(data);
+    this->e_props.push_back();
     //
     this->v2v.at(vid1).push_back(vid0);
     this->v2v.at(vid0).push_back(vid1);
@@ -1105,6 +1355,7 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::edge_switch_id(const uint eid0, const uint eid1)
 {
+    this->adjacency_require(ADJ_ALL);
     // [28 Aug 2017] Tested on 10K random id switches : PASSED
 
     if (eid0 == eid1) return;
@@ -1113,6 +1364,7 @@ void AbstractPolygonMesh<M,V,E,P>::edge_switch_id(const uint eid0, const uint ei
 
     std::swap(this->e2p.at(eid0),    this->e2p.at(eid1));
     std::swap(this->e_data.at(eid0), this->e_data.at(eid1));
+    this->e_props.swap(eid0, eid1);
 
     std::unordered_set<uint> verts_to_update;
     verts_to_update.insert(this->edge_vert_id(eid0,0));
@@ -1158,10 +1410,13 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::edge_remove_unreferenced(const uint eid)
 {
+    this->adjacency_require(ADJ_ALL);
+    this->reset_spatial_indices();
     this->e2p.at(eid).clear();
     edge_switch_id(eid, this->num_edges()-1);
     this->edges.resize(this->edges.size()-2);
     this->e_data.pop_back();
+    this->e_props.pop_back();
     this->e2p.pop_back();
 }
 
@@ -1372,12 +1627,14 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::poly_switch_id(const uint pid0, const uint pid1)
 {
+    this->adjacency_require(ADJ_ALL);
     // [28 Aug 2017] Tested on 10K random id switches : PASSED
 
     if (pid0 == pid1) return;
 
     std::swap(this->polys.at(pid0),          this->polys.at(pid1));
     std::swap(this->p_data.at(pid0),         this->p_data.at(pid1));
+    this->p_props.swap(pid0, pid1);
     std::swap(this->p2e.at(pid0),            this->p2e.at(pid1));
     std::swap(this->p2p.at(pid0),            this->p2p.at(pid1));
     std::swap(this->poly_triangles.at(pid0), this->poly_triangles.at(pid1));
@@ -1428,6 +1685,8 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractPolygonMesh<M,V,E,P>::poly_add(const std::vector<uint> & vlist)
 {
+    this->adjacency_require(ADJ_ALL);
+    this->reset_spatial_indices();
     if(poly_id(vlist)!=-1)
     {
         std::cout << ANSI_fg_color_red << "WARNING: adding duplicated poly!" << ANSI_fg_color_default << std::endl;
@@ -1442,6 +1701,7 @@ uint AbstractPolygonMesh<M,V,E,P>::poly_add(const std::vector<uint> & vlist)
 
     P data;
     this->p_data.push_back(data);
+    this->p_props.push_back();
 
     this->p2e.push_back(std::vector<uint>());
     this->p2p.push_back(std::vector<uint>());
@@ -1509,6 +1769,7 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::poly_remove(const uint pid)
 {
+    this->adjacency_require(ADJ_ALL);
     // [28 Aug 2017] Tested on progressive random removal until almost no polys are left: PASSED
 
     std::set<uint,std::greater<uint>> dangling_verts; // higher ids first
@@ -1561,12 +1822,15 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::poly_remove_unreferenced(const uint pid)
 {
+    this->adjacency_require(ADJ_ALL);
+    this->reset_spatial_indices();
     this->polys.at(pid).clear();
     this->p2e.at(pid).clear();
     this->p2p.at(pid).clear();
     poly_switch_id(pid, this->num_polys()-1);
     this->polys.pop_back();
     this->p_data.pop_back();
+    this->p_props.pop_back();
     this->p2e.pop_back();
     this->p2p.pop_back();
     this->poly_triangles.pop_back();
@@ -1574,6 +1838,251 @@ void AbstractPolygonMesh<M,V,E,P>::poly_remove_unreferenced(const uint pid)
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::polys_rebuild(      std::vector<std::vector<uint>>     & new_polys,
+                                                 const std::vector<int>                   & p_src,
+                                                 const std::vector<uint>                  & v_merge,
+                                                 const std::vector<std::pair<ipair,uint>> & e_src,
+                                                 const std::vector<uint>                  & v_moved,
+                                                       MeshIdMaps                         & id_maps)
+{
+    this->adjacency_require(ADJ_ALL);
+    uint nv = this->num_verts();
+    uint ne = this->num_edges();
+    uint np = this->num_polys();
+    assert(new_polys.size()==p_src.size());
+    assert(new_polys.size()>=np);
+    assert(v_merge.empty() || v_merge.size()==nv);
+
+    // compact vertices (keep only the referenced ones)
+    std::vector<int> & v_map = id_maps.v_map;
+    v_map.assign(nv,-1);
+    for(const auto & p : new_polys) for(uint vid : p) v_map.at(vid) = 0;
+    uint nv_new = 0;
+    for(uint vid=0; vid<nv; ++vid) if(v_map.at(vid)==0) v_map.at(vid) = nv_new++;
+    auto is_merged = [&](const uint vid) { return !v_merge.empty() && v_merge.at(vid)!=vid; };
+    for(uint vid=0; vid<nv; ++vid) if(is_merged(vid)) v_map.at(vid) = v_map.at(v_merge.at(vid));
+
+    // compact polygons. Polygons that did not change keep their tessellation, all the others
+    // (and the polygons around moved vertices) are refreshed at the end. Lists are moved, not
+    // copied, so that no memory is allocated for the polygons that survive
+    std::vector<int> & p_map = id_maps.p_map;
+    p_map.assign(np,-1);
+    std::vector<bool> v_dirty_flag(nv_new, false);
+    std::vector<bool> p_dirty_flag;
+    std::vector<P>    p_data_new;
+    std::vector<int>  p_from_new; // source of the properties of each polygon (see PropertySet)
+    p_data_new.reserve(new_polys.size());
+    p_from_new.reserve(new_polys.size());
+    p_dirty_flag.reserve(new_polys.size());
+    for(uint vid : v_moved) if(v_map.at(vid)>=0) v_dirty_flag.at(v_map.at(vid)) = true;
+    this->poly_triangles.resize(new_polys.size());
+    uint np_new = 0;
+    for(uint i=0; i<new_polys.size(); ++i)
+    {
+        bool changed = (i>=np || p_src.at(i)!=(int)i || new_polys.at(i)!=this->polys.at(i));
+        if(changed && i<np) for(uint vid : this->polys.at(i)) if(v_map.at(vid)>=0) v_dirty_flag.at(v_map.at(vid)) = true;
+        if(new_polys.at(i).empty()) continue;
+
+        uint pid = np_new++;
+        int  src = p_src.at(i);
+        if(src>=0 && p_map.at(src)==-1) p_map.at(src) = pid;
+        p_data_new.push_back((src>=0) ? this->p_data.at(src) : P());
+        p_from_new.push_back(src);
+        p_dirty_flag.push_back(changed);
+
+        for(uint & vid : new_polys.at(i)) vid = v_map.at(vid);
+        if(pid!=i) new_polys.at(pid).swap(new_polys.at(i));
+
+        std::vector<uint> & tris = this->poly_triangles.at(pid);
+        if(!changed)
+        {
+            if(pid!=i) tris.swap(this->poly_triangles.at(i));
+            for(uint & vid : tris) vid = v_map.at(vid);
+        }
+        else
+        {
+            tris.clear();
+            for(uint vid : new_polys.at(pid)) v_dirty_flag.at(vid) = true;
+        }
+    }
+    new_polys.resize(np_new);
+    this->poly_triangles.resize(np_new);
+
+    // edges are first generated for all the current edges that survive (so that they keep
+    // their relative order and attributes), then for the new ones. Edges that do not bound
+    // any new polygon are discarded at the end. The vertex-to-edge lists of the current mesh
+    // are recycled as a lookup table, and eventually become the new v2e
+    std::vector<uint> edges_tmp;
+    std::vector<int>  e_from;
+    edges_tmp.reserve(2*ne);
+    e_from.reserve(ne);
+    std::vector<std::vector<uint>> & v2e_tmp = this->v2e;
+    v2e_tmp.resize(nv_new);
+    for(auto & l : v2e_tmp) l.clear();
+    auto find_edge = [&](const uint v0, const uint v1) -> int
+    {
+        for(uint eid : v2e_tmp.at(v0))
+        {
+            if(edges_tmp.at(2*eid)+edges_tmp.at(2*eid+1)-v0 == v1) return eid;
+        }
+        return -1;
+    };
+    auto add_edge = [&](const uint v0, const uint v1, const int src) -> uint
+    {
+        uint eid = e_from.size();
+        edges_tmp.push_back(v0);
+        edges_tmp.push_back(v1);
+        e_from.push_back(src);
+        v2e_tmp.at(v0).push_back(eid);
+        v2e_tmp.at(v1).push_back(eid);
+        return eid;
+    };
+    std::vector<int> & e_map = id_maps.e_map;
+    e_map.assign(ne,-1);
+    for(uint eid=0; eid<ne; ++eid)
+    {
+        uint vid0 = this->edge_vert_id(eid,0);
+        uint vid1 = this->edge_vert_id(eid,1);
+        int  v0   = v_map.at(vid0);
+        int  v1   = v_map.at(vid1);
+        if(v0<0 || v1<0 || v0==v1) continue;
+        int id = find_edge(v0,v1);
+        if(id<0) id = add_edge(v0,v1,eid);
+        else if(!is_merged(vid0) && !is_merged(vid1)) e_from.at(id) = eid; // prefer edges that were there already
+        e_map.at(eid) = id;
+    }
+    for(const auto & e : e_src)
+    {
+        int v0 = v_map.at(e.first.first);
+        int v1 = v_map.at(e.first.second);
+        if(v0<0 || v1<0 || v0==v1) continue;
+        int id = find_edge(v0,v1);
+        if(id<0) add_edge(v0,v1,e.second);
+        else if(e_from.at(id)<0) e_from.at(id) = e.second;
+    }
+    this->p2e.resize(np_new);
+    for(uint pid=0; pid<np_new; ++pid)
+    {
+        const std::vector<uint> & p = new_polys.at(pid);
+        std::vector<uint> & p2e = this->p2e.at(pid);
+        p2e.clear();
+        for(uint i=0; i<p.size(); ++i)
+        {
+            uint v0 = p.at(i);
+            uint v1 = p.at((i+1)%p.size());
+            int  id = find_edge(v0,v1);
+            if(id<0) id = add_edge(v0,v1,-1);
+            p2e.push_back(id);
+        }
+    }
+    std::vector<int> e_compact(e_from.size(),-1);
+    for(const auto & p2e : this->p2e) for(uint eid : p2e) e_compact.at(eid) = 0;
+    uint ne_new = 0;
+    for(uint eid=0; eid<e_from.size(); ++eid) if(e_compact.at(eid)==0) e_compact.at(eid) = ne_new++;
+    for(int & eid : e_map) if(eid>=0) eid = e_compact.at(eid);
+    for(auto & p2e : this->p2e) for(uint & eid : p2e) eid = e_compact.at(eid);
+
+    // write the new mesh
+    std::vector<vec3d> verts_new(nv_new);
+    std::vector<V>     v_data_new(nv_new);
+    std::vector<int>   v_from_new(nv_new,-1);
+    for(uint vid=0; vid<nv; ++vid)
+    {
+        if(is_merged(vid) || v_map.at(vid)<0) continue;
+        verts_new.at(v_map.at(vid))  = this->verts.at(vid);
+        v_data_new.at(v_map.at(vid)) = this->v_data.at(vid);
+        v_from_new.at(v_map.at(vid)) = vid;
+    }
+    std::vector<uint> edges_new;
+    std::vector<E>    e_data_new;
+    std::vector<int>  e_from_new;
+    edges_new.reserve(2*ne_new);
+    e_data_new.reserve(ne_new);
+    e_from_new.reserve(ne_new);
+    for(uint eid=0; eid<e_from.size(); ++eid)
+    {
+        if(e_compact.at(eid)<0) continue;
+        edges_new.push_back(edges_tmp.at(2*eid));
+        edges_new.push_back(edges_tmp.at(2*eid+1));
+        e_data_new.push_back((e_from.at(eid)>=0) ? this->e_data.at(e_from.at(eid)) : E());
+        e_from_new.push_back(e_from.at(eid));
+    }
+
+    this->verts.swap(verts_new);
+    this->v_data.swap(v_data_new);
+    this->edges.swap(edges_new);
+    this->e_data.swap(e_data_new);
+    this->polys.swap(new_polys);
+    this->p_data.swap(p_data_new);
+    this->v_props.gather(v_from_new);
+    this->e_props.gather(e_from_new);
+    this->p_props.gather(p_from_new);
+
+    // rebuild adjacencies, recycling the memory of the current lists
+    auto reset = [](std::vector<std::vector<uint>> & adj, const uint size)
+    {
+        adj.resize(size);
+        for(auto & l : adj) l.clear();
+    };
+    reset(this->v2v, nv_new);
+    reset(this->v2e, nv_new);
+    reset(this->v2p, nv_new);
+    reset(this->e2p, ne_new);
+    reset(this->p2p, np_new);
+    for(uint eid=0; eid<ne_new; ++eid)
+    {
+        uint v0 = this->edges.at(2*eid);
+        uint v1 = this->edges.at(2*eid+1);
+        this->v2e.at(v0).push_back(eid);
+        this->v2e.at(v1).push_back(eid);
+        this->v2v.at(v0).push_back(v1);
+        this->v2v.at(v1).push_back(v0);
+    }
+    for(uint pid=0; pid<np_new; ++pid)
+    {
+        for(uint vid : this->polys.at(pid)) this->v2p.at(vid).push_back(pid);
+        for(uint eid : this->p2e.at(pid))   this->e2p.at(eid).push_back(pid);
+    }
+    for(uint pid=0; pid<np_new; ++pid)
+    {
+        for(uint eid : this->p2e.at(pid))
+        for(uint nbr : this->e2p.at(eid))
+        {
+            if(nbr!=pid && DOES_NOT_CONTAIN_VEC(this->p2p.at(pid),nbr)) this->p2p.at(pid).push_back(nbr);
+        }
+    }
+
+    // refresh tessellations and normals only where something changed. Flags are used in place
+    // of update_dirty, which is much slower when the dirty set is a large part of the mesh
+    for(uint pid=0; pid<np_new; ++pid)
+    {
+        if(p_dirty_flag.at(pid)) continue;
+        for(uint vid : this->polys.at(pid)) if(v_dirty_flag.at(vid)) { p_dirty_flag.at(pid) = true; break; }
+    }
+    for(uint pid=0; pid<np_new; ++pid)
+    {
+        if(!p_dirty_flag.at(pid)) continue;
+        update_p_tessellation(pid);
+        if(this->mesh_data().update_normals) update_p_normal(pid);
+        for(uint vid : this->polys.at(pid)) v_dirty_flag.at(vid) = true;
+    }
+    if(this->mesh_data().update_normals)
+    {
+        for(uint vid=0; vid<nv_new; ++vid) if(v_dirty_flag.at(vid)) update_v_normal(vid);
+    }
+
+    std::vector<uint> v_dirty_new;
+    for(uint vid : this->v_dirty) if(vid<nv && v_map.at(vid)>=0) v_dirty_new.push_back(v_map.at(vid));
+    this->v_dirty.swap(v_dirty_new);
+
+    if(this->mesh_data().update_bbox) this->update_bbox();
+    this->reset_spatial_indices();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 std::vector<ipair> AbstractPolygonMesh<M,V,E,P>::get_boundary_edges() const
@@ -1661,6 +2170,9 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::operator+=(const AbstractPolygonMesh<M,V,E,P> & m)
 {
+    this->adjacency_require(ADJ_ALL);
+       m.adjacency_require(ADJ_ALL);
+
     uint nv = this->num_verts();
     uint ne = this->num_edges();
     uint np = this->num_polys();
@@ -1715,6 +2227,11 @@ void AbstractPolygonMesh<M,V,E,P>::operator+=(const AbstractPolygonMesh<M,V,E,P>
         this->v2v.push_back(tmp);
     }
 
+    // property layers are mesh specific: appended elements get default values
+    this->v_props.resize(this->num_verts());
+    this->e_props.resize(this->num_edges());
+    this->p_props.resize(this->num_polys());
+
     if(this->mesh_data().update_bbox) this->update_bbox();
 
     std::cout << "Appended " << m.mesh_data().filename << " to mesh " << this->mesh_data().filename << std::endl;
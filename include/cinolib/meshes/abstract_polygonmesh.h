@@ -40,6 +40,7 @@
 #include <cinolib/meshes/mesh_attributes.h>
 #include <cinolib/ipair.h>
 #include <cinolib/symbols.h>
+#include <cinolib/bvh.h>
 
 namespace cinolib
 {
@@ -55,6 +56,8 @@ class AbstractPolygonMesh : public AbstractMesh<M,V,E,P>
         std::vector<std::vector<uint>> poly_triangles; // triangles covering each quad. Useful for
                                                        // robust normal estimation and rendering
 
+        mutable BVH bvh_polys; // poly tessellations, for ray picking (see pick_poly)
+
     public:
 
         explicit AbstractPolygonMesh() : AbstractMesh<M,V,E,P>() {}
@@ -68,6 +71,8 @@ class AbstractPolygonMesh : public AbstractMesh<M,V,E,P>
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         void clear() override;
+        void reset_spatial_indices() override;
+        void permute(const MeshIdMaps & id_maps) override;
         void init(const std::vector<vec3d>             & verts,
                   const std::vector<std::vector<uint>> & polys);
         void init(      std::vector<vec3d>             & pos,       // vertex xyz positions
@@ -87,6 +92,7 @@ class AbstractPolygonMesh : public AbstractMesh<M,V,E,P>
                 void update_p_tessellations();
                 void update_p_normals();
                 void update_v_normals();
+                void update_dirty(); // refresh tessellation and normals only around the verts marked with vert_set_dirty()
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -104,6 +110,14 @@ class AbstractPolygonMesh : public AbstractMesh<M,V,E,P>
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+        // first (non hidden) polygon hit by the ray R(t) := ray_orig + t * ray_dir, t>=0.
+        // Returns -1 if the ray misses the mesh. Queries are accelerated with a BVH
+        // built at the first query (see pick_vert for details on its update)
+        using AbstractMesh<M,V,E,P>::pick_poly;
+        int pick_poly(const vec3d & ray_orig, const vec3d & ray_dir) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
         void operator+=(const AbstractPolygonMesh<M,V,E,P> & m);
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -191,6 +205,39 @@ class AbstractPolygonMesh : public AbstractMesh<M,V,E,P>
               std::vector<vec3d>   poly_vlist              (const uint pid) const;
         const std::vector<uint>  & poly_tessellation       (const uint pid) const;
               void                 poly_export_element     (const uint pid, std::vector<vec3d> & verts, std::vector<std::vector<uint>> & faces) const override;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // polys_rebuild replaces the whole list of polygons with new_polys, rebuilding all the
+        // connectivity at once. It is the backend of the batched editing operators (see for
+        // instance Trimesh::edges_split), which are much faster than long sequences of single
+        // element edits. Inputs are all expressed in current ids (new verts must be added
+        // with vert_add beforehand):
+        //
+        //   new_polys : new polygons. Empty polygons are discarded. The list is consumed
+        //   p_src     : polygon each new polygon inherits attributes from (-1 for defaults)
+        //   v_merge   : vertex each vertex is merged into (itself otherwise). Can be empty
+        //   e_src     : attribute sources for new edges. Surviving edges keep their attributes
+        //   v_moved   : vertices that were repositioned
+        //
+        // Vertices not referenced by any polygon are removed, and surviving elements keep their
+        // relative order. Old to new ids are returned in id_maps
+        //
+        void polys_rebuild(      std::vector<std::vector<uint>>     & new_polys,
+                           const std::vector<int>                   & p_src,
+                           const std::vector<uint>                  & v_merge,
+                           const std::vector<std::pair<ipair,uint>> & e_src,
+                           const std::vector<uint>                  & v_moved,
+                                 MeshIdMaps                         & id_maps);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    protected:
+
+        void init_soup(const std::vector<vec3d>             & verts,
+                       const std::vector<std::vector<uint>> & polys);
+
+        void adjacency_build(const int relations) override;
 };
 
 }
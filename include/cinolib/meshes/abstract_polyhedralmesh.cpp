@@ -37,6 +37,9 @@
 #include <cinolib/geometry/triangle.h>
 #include <cinolib/geometry/polygon_utils.h>
 #include <cinolib/how_many_seconds.h>
+#include <cinolib/stl_container_utilities.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/quality_report.h>
 #include <unordered_set>
 #include <unordered_map>
 #include <queue>
@@ -55,6 +58,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::clear()
     polys_face_winding.clear();
     //
     f_data.clear();
+    f_props.clear();
     //
     v2f.clear();
     e2f.clear();
@@ -66,6 +70,54 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::clear()
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::permute(const MeshIdMaps & id_maps)
+{
+    AbstractMesh<M,V,E,P>::permute(id_maps);
+
+    const std::vector<int> & v_map = id_maps.v_map;
+    const std::vector<int> & e_map = id_maps.e_map;
+    const std::vector<int> & f_map = id_maps.f_map;
+    const std::vector<int> & p_map = id_maps.p_map;
+
+    if(!v_map.empty())
+    {
+        PERMUTE_VEC(v2f, v_map);
+        for(auto & f : faces)          REMAP_VEC(f, v_map);
+        for(auto & t : face_triangles) REMAP_VEC(t, v_map);
+        for(auto & l : p2v)            REMAP_VEC(l, v_map);
+    }
+    if(!e_map.empty())
+    {
+        PERMUTE_VEC(e2f, e_map);
+        for(auto & l : f2e) REMAP_VEC(l, e_map);
+    }
+    if(!f_map.empty())
+    {
+        assert(f_map.size()==num_faces());
+        PERMUTE_VEC(faces,          f_map);
+        PERMUTE_VEC(face_triangles, f_map);
+        PERMUTE_VEC(f_data,         f_map);
+        f_props.permute(f_map);
+        PERMUTE_VEC(f2e,            f_map);
+        PERMUTE_VEC(f2f,            f_map);
+        PERMUTE_VEC(f2p,            f_map);
+        for(auto & l : v2f)         REMAP_VEC(l, f_map);
+        for(auto & l : e2f)         REMAP_VEC(l, f_map);
+        for(auto & l : f2f)         REMAP_VEC(l, f_map);
+        for(auto & l : this->polys) REMAP_VEC(l, f_map);
+    }
+    if(!p_map.empty())
+    {
+        PERMUTE_VEC(polys_face_winding, p_map);
+        PERMUTE_VEC(p2v,                p_map);
+        for(auto & l : f2p) REMAP_VEC(l, p_map);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>             & verts,
@@ -98,6 +150,10 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>
     this->e_data.reserve(ne);
     this->f_data.reserve(nf);
     this->p_data.reserve(np);
+    this->v_props.reserve(nv);
+    this->e_props.reserve(ne);
+    this->f_props.reserve(nf);
+    this->p_props.reserve(np);
     this->face_triangles.reserve(nf);
     this->polys_face_winding.reserve(np);
 
@@ -125,6 +181,12 @@ CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>             & verts,
                                              const std::vector<std::vector<uint>> & polys)
 {
+    if(this->soup)
+    {
+        init_soup(verts, polys);
+        return;
+    }
+
     std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
 
     // pre-allocate memory
@@ -140,6 +202,8 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>
     this->p2p.reserve(np);
     this->v_data.reserve(nv);
     this->p_data.reserve(np);
+    this->v_props.reserve(nv);
+    this->p_props.reserve(np);
     this->polys_face_winding.reserve(np);
 
     for(auto v : verts) vert_add(v);
@@ -160,6 +224,185 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::init_soup(const std::vector<vec3d>             & verts,
+                                                  const std::vector<std::vector<uint>> & polys)
+{
+    std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+
+    // faces are not even listed, hence p2v is the only connectivity stored. The poly to
+    // face lists are left empty (but sized), so that num_polys() is still meaningful
+    uint nv = verts.size(), np = polys.size();
+    this->verts = verts;
+    this->p2v   = polys;
+    this->polys.assign(np, std::vector<uint>());
+    this->polys_face_winding.assign(np, std::vector<bool>());
+    this->v_data.resize(nv);
+    this->p_data.resize(np);
+    this->v_props.resize(nv);
+    this->p_props.resize(np);
+
+    this->copy_xyz_to_uvw(UVW_param);
+    if(this->mesh_data().update_bbox) this->update_bbox();
+
+    this->adj_todo = ADJ_ALL;
+
+    std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+
+    std::cout << "load soup\t"     <<
+                 this->num_verts() << "V / " <<
+                 this->num_polys() << "P  [" <<
+                 how_many_seconds(t0,t1) << "s]" << std::endl;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::adjacency_build(const int relations)
+{
+    int todo = relations & this->adj_todo;
+    if(todo & ADJ_P2P) todo |= ADJ_FACES;                     // p2p is derived from f2p
+    if(todo & ADJ_FACES) todo |= (ADJ_EDGES & this->adj_todo); // faces refer to edges
+    todo &= this->adj_todo;
+    if(!todo) return;
+
+    // Everything is built in place: the containers that already exist (verts, p2v,
+    // attributes, and any relation built before) are never reallocated, so that
+    // references handed out before the build remain valid (e.g. adj_p2f() called
+    // while iterating over adj_v2p()). Faces and edges are generated exactly as
+    // poly_add() would do, hence ids are the same of a regular init
+
+    uint nv = this->num_verts();
+    uint np = this->num_polys();
+
+    // faces of a poly, in the order poly_add() would add them (p2v is not reordered
+    // until faces are built, so edges and faces see the same lists)
+    auto poly_faces = [this](const uint pid)
+    {
+        const std::vector<uint> & vlist = this->p2v.at(pid);
+        std::vector<std::vector<uint>> f;
+        if(vlist.size()==4) // tetrahedron
+        {
+            for(uint i=0; i<4; ++i) f.push_back({ vlist.at(TET_FACES[i][0]), vlist.at(TET_FACES[i][1]), vlist.at(TET_FACES[i][2]) });
+        }
+        else if(vlist.size()==8) // hexahedron
+        {
+            for(uint i=0; i<6; ++i) f.push_back({ vlist.at(HEXA_FACES[i][0]), vlist.at(HEXA_FACES[i][1]), vlist.at(HEXA_FACES[i][2]), vlist.at(HEXA_FACES[i][3]) });
+        }
+        else assert(false && "Unknown polyhedral element!");
+        return f;
+    };
+
+    if(todo & ADJ_V2P)
+    {
+        std::vector<uint> valence(nv,0);
+        for(const auto & p : this->p2v) for(uint vid : p) ++valence.at(vid);
+        this->v2p.assign(nv, std::vector<uint>());
+        for(uint vid=0; vid<nv; ++vid) this->v2p.at(vid).reserve(valence.at(vid));
+        for(uint pid=0; pid<np; ++pid)
+        for(uint vid : this->p2v.at(pid))
+        {
+            this->v2p.at(vid).push_back(pid);
+        }
+        this->adj_todo &= ~ADJ_V2P;
+    }
+
+    if(todo & ADJ_EDGES)
+    {
+        // edges are numbered in order of first appearance along the poly faces, as
+        // face_add() would do. Edge ids and e2p are the same of a regular init, p2e
+        // lists the same edges, but not necessarily in the same order
+        assert(this->edges.empty() && this->faces.empty());
+        this->v2v.assign(nv, std::vector<uint>());
+        this->v2e.assign(nv, std::vector<uint>());
+        this->p2e.assign(np, std::vector<uint>());
+        for(uint pid=0; pid<np; ++pid)
+        {
+            for(const auto & f : poly_faces(pid))
+            for(uint i=0; i<f.size(); ++i)
+            {
+                uint vid0 = f.at(i);
+                uint vid1 = f.at((i+1)%f.size());
+                int  eid  = -1;
+                for(uint j=0; j<this->v2v.at(vid0).size(); ++j)
+                {
+                    if(this->v2v.at(vid0).at(j)==vid1) { eid = this->v2e.at(vid0).at(j); break; }
+                }
+                if(eid==-1)
+                {
+                    eid = this->e2p.size();
+                    this->edges.push_back(vid0);
+                    this->edges.push_back(vid1);
+                    this->e2p.push_back(std::vector<uint>());
+                    this->v2v.at(vid1).push_back(vid0);
+                    this->v2v.at(vid0).push_back(vid1);
+                    this->v2e.at(vid0).push_back(eid);
+                    this->v2e.at(vid1).push_back(eid);
+                }
+                if(DOES_NOT_CONTAIN_VEC(this->p2e.at(pid), (uint)eid))
+                {
+                    this->e2p.at(eid).push_back(pid);
+                    this->p2e.at(pid).push_back(eid);
+                }
+            }
+        }
+        uint ne = this->e2p.size();
+        this->e2f.assign(ne, std::vector<uint>()); // filled with faces
+        this->e_data.assign(ne, E());
+        this->e_props.resize(0);
+        this->e_props.resize(ne);
+        this->adj_todo &= ~ADJ_EDGES;
+    }
+
+    if(todo & ADJ_FACES)
+    {
+        // faces and p2p come together, as poly adjacency is defined by shared faces
+        this->adj_todo &= ~(ADJ_FACES | ADJ_P2P); // face_add() must not trigger a nested build
+        assert(this->faces.empty());
+        this->v2f.assign(nv, std::vector<uint>());
+        this->p2p.assign(np, std::vector<uint>());
+
+        for(uint pid=0; pid<np; ++pid)
+        {
+            // detect (or add) faces and assign face winding. All edges exist already
+            std::vector<uint> & flist = this->polys.at(pid);
+            std::vector<bool> & w     = this->polys_face_winding.at(pid);
+            assert(flist.empty() && w.empty());
+            for(const auto & vf : poly_faces(pid))
+            {
+                int fid = this->face_id(vf);
+                if(fid == -1) fid = this->face_add(vf);
+                flist.push_back(fid);
+                w.push_back(this->face_verts_are_CCW(fid, vf.at(1), vf.at(0)));
+            }
+
+            // update connectivity (see poly_add)
+            for(uint fid : flist)
+            {
+                for(uint nbr : this->f2p.at(fid))
+                {
+                    if(DOES_NOT_CONTAIN_VEC(this->p2p.at(pid), nbr))
+                    {
+                        this->p2p.at(pid).push_back(nbr);
+                        this->p2p.at(nbr).push_back(pid);
+                    }
+                }
+                this->f2p.at(fid).push_back(pid);
+            }
+
+            // enforce standard vertex ordering (p2v keeps its storage)
+            poly_reorder_p2v(pid);
+        }
+
+        this->update_quality();
+        if(this->mesh_data().update_normals) this->update_v_normals();
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>             & verts,
@@ -312,10 +555,11 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::update_f_normals()
 {
-    for(uint fid=0; fid<num_faces(); ++fid)
+    this->adjacency_require(ADJ_FACES);
+    PARALLEL_FOR(0, num_faces(), 1000, [this](uint fid)
     {
         update_f_normal(fid);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -324,11 +568,12 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::update_f_tessellation()
 {
+    this->adjacency_require(ADJ_FACES);
     this->face_triangles.resize(this->num_faces());
-    for(uint fid=0; fid<this->num_faces(); ++fid)
+    PARALLEL_FOR(0, this->num_faces(), 1000, [this](uint fid)
     {
         update_f_tessellation(fid);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -337,9 +582,13 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::update_f_tessellation(const uint fid)
 {
+    // NOTE: no lazy build here (fid exists, hence so do faces). This is
+    // called per face by parallel loops, which must not trigger builds
     // Assume convexity and try trivial tessellation first. If something flips
-    // apply earcut algorithm to get a valid triangulation
-
+    // apply earcut algorithm to get a valid triangulation.
+    // Previous triangles are discarded: update_dirty() re-tessellates
+    // faces that already have one, and must not append to them
+    face_triangles.at(fid).clear();
     std::vector<vec3d> n;
     for (uint i=2; i<this->verts_per_face(fid); ++i)
     {
@@ -384,10 +633,11 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::update_v_normals()
 {
-    for(uint vid=0; vid<this->num_verts(); ++vid)
+    this->adjacency_require(ADJ_FACES);
+    PARALLEL_FOR(0, this->num_verts(), 1000, [this](uint vid)
     {
         if(vert_is_on_srf(vid)) update_v_normal(vid);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -422,10 +672,63 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::update_quality()
 {
-    for(uint pid=0; pid<this->num_polys(); ++pid)
+    if(this->mesh_type()==TETMESH || this->mesh_type()==HEXMESH)
+    {
+        // batched (SIMD friendly) evaluation of the scaled jacobian
+        std::vector<double> q;
+        polys_quality(*this, SCALED_JACOBIAN, q);
+        for(uint pid=0; pid<this->num_polys(); ++pid) this->poly_data(pid).quality = q.at(pid);
+        return;
+    }
+    PARALLEL_FOR(0, this->num_polys(), 1000, [this](uint pid)
     {
         update_p_quality(pid);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::update_dirty()
+{
+    // faces and polyhedra incident to a moved vertex need new normal, tessellation
+    // and quality. Then, vertex normals must be updated for all the surface vertices
+    // of such faces
+    std::vector<uint> fids, pids;
+    for(uint vid : this->v_dirty)
+    {
+        if(vid>=this->num_verts()) continue; // vert removed after being marked
+        for(uint fid : adj_v2f(vid))       fids.push_back(fid);
+        for(uint pid : this->adj_v2p(vid)) pids.push_back(pid);
+    }
+    REMOVE_DUPLICATES_FROM_VEC(fids);
+    REMOVE_DUPLICATES_FROM_VEC(pids);
+
+    PARALLEL_FOR(0, fids.size(), 1000, [&](uint i)
+    {
+        update_f_tessellation(fids[i]);
+        update_f_normal(fids[i]);
+    });
+
+    PARALLEL_FOR(0, pids.size(), 1000, [&](uint i)
+    {
+        update_p_quality(pids[i]);
+    });
+
+    std::vector<uint> vids;
+    for(uint fid : fids)
+    {
+        if(face_is_on_srf(fid)) for(uint vid : adj_f2v(fid)) vids.push_back(vid);
     }
+    REMOVE_DUPLICATES_FROM_VEC(vids);
+
+    PARALLEL_FOR(0, vids.size(), 1000, [&](uint i)
+    {
+        update_v_normal(vids[i]);
+    });
+
+    this->v_dirty.clear();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -477,6 +780,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 std::vector<uint> AbstractPolyhedralMesh<M,V,E,F,P>::face_tessellation(const uint fid) const
 {
+    this->adjacency_require(ADJ_FACES);
     return face_triangles.at(fid);
 }
 
@@ -1021,6 +1325,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::poly_face_id(const uint pid, const uint off) const
 {
+    this->adjacency_require(ADJ_FACES);
     return this->polys.at(pid).at(off);
 }
 
@@ -1030,6 +1335,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::poly_face_flip_winding(const uint pid, const uint fid)
 {
+    this->adjacency_require(ADJ_FACES);
     uint off = poly_face_offset(pid, fid);
     polys_face_winding.at(pid).at(off) = !polys_face_winding.at(pid).at(off);
 }
@@ -1040,6 +1346,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 bool AbstractPolyhedralMesh<M,V,E,F,P>::poly_face_winding(const uint pid, const uint fid) const
 {
+    this->adjacency_require(ADJ_FACES);
     assert(this->poly_contains_face(pid,fid));
     uint off = poly_face_offset(pid, fid);
     return polys_face_winding.at(pid).at(off);
@@ -1063,6 +1370,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 bool AbstractPolyhedralMesh<M,V,E,F,P>::poly_face_is_CW(const uint pid, const uint fid) const
 {
+    this->adjacency_require(ADJ_FACES);
     uint off = poly_face_offset(pid, fid);
     return (polys_face_winding.at(pid).at(off) == false);
 }
@@ -1082,6 +1390,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::poly_face_offset(const uint pid, const uint fid) const
 {
+    this->adjacency_require(ADJ_FACES);
     assert(poly_contains_face(pid,fid));
     for(uint off=0; off<this->polys.at(pid).size(); ++off)
     {
@@ -1126,6 +1435,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 std::vector<uint> AbstractPolyhedralMesh<M,V,E,F,P>::poly_e2f(const uint pid, const uint eid) const
 {
+    this->adjacency_require(ADJ_FACES);
     assert(this->poly_contains_edge(pid,eid));
     std::vector<uint> faces;
     for(uint fid : this->adj_e2f(eid))
@@ -1142,6 +1452,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 std::vector<uint> AbstractPolyhedralMesh<M,V,E,F,P>::poly_f2f(const uint pid, const uint fid) const
 {
+    this->adjacency_require(ADJ_FACES);
     assert(this->poly_contains_face(pid,fid));
     std::vector<uint> faces;
     for(uint nbr : this->adj_f2f(fid))
@@ -1158,6 +1469,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 std::vector<uint> AbstractPolyhedralMesh<M,V,E,F,P>::poly_v2f(const uint pid, const uint vid) const
 {
+    this->adjacency_require(ADJ_FACES);
     assert(this->poly_contains_vert(pid,vid));
     std::vector<uint> faces;
     for(uint fid : this->adj_v2f(vid))
@@ -1250,6 +1562,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::face_vert_id(const uint fid, const uint off) const
 {
+    this->adjacency_require(ADJ_FACES);
     return faces.at(fid).at(off);
 }
 
@@ -1409,6 +1722,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 std::vector<uint> AbstractPolyhedralMesh<M,V,E,F,P>::face_v2e(const uint fid, const uint vid) const
 {
+    this->adjacency_require(ADJ_FACES);
     assert(this->face_contains_vert(fid,vid));
     std::vector<uint> edges;
     for(uint eid : this->adj_v2e(vid))
@@ -1953,6 +2267,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::vert_switch_id(const uint vid0, const uint vid1)
 {
+    this->adjacency_require(ADJ_ALL);
     if (vid0 == vid1) return;
 
     std::swap(this->verts.at(vid0),   this->verts.at(vid1));
@@ -1961,6 +2276,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::vert_switch_id(const uint vid0, const ui
     std::swap(this->v2f.at(vid0),     this->v2f.at(vid1));
     std::swap(this->v2p.at(vid0),     this->v2p.at(vid1));
     std::swap(this->v_data.at(vid0),  this->v_data.at(vid1));
+    this->v_props.swap(vid0, vid1);
 
     std::unordered_set<uint> verts_to_update;
     verts_to_update.insert(this->adj_v2v(vid0).begin(), this->adj_v2v(vid0).end());
@@ -2036,6 +2352,8 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::vert_remove_unreferenced(const uint vid)
 {
+    this->adjacency_require(ADJ_ALL);
+    this->reset_spatial_indices();
     this->v2v.at(vid).clear();
     this->v2e.at(vid).clear();
     this->v2f.at(vid).clear();
@@ -2043,6 +2361,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::vert_remove_unreferenced(const uint vid)
     vert_switch_id(vid, this->num_verts()-1);
     this->verts.pop_back();
     this->v_data.pop_back();
+    this->v_props.pop_back();
     this->v2v.pop_back();
     this->v2e.pop_back();
     this->v2f.pop_back();
@@ -2055,12 +2374,15 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::vert_add(const vec3d & pos)
 {
+    this->adjacency_require(ADJ_ALL);
+    this->reset_spatial_indices();
     uint vid = this->num_verts();
     //
     this->verts.push_back(pos);
     //
     V data;
     this->v_data.push_back(data);
+    this->v_props.push_back();
     assert(this->verts.size() == this->v_data.size());
     //
     this->v2v.push_back(std::vector<uint>());
@@ -2080,6 +2402,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::edge_switch_id(const uint eid0, const uint eid1)
 {
+    this->adjacency_require(ADJ_ALL);
     if (eid0 == eid1) return;
 
     for(short off=0; off<2; ++off) std::swap(this->edges.at(2*eid0+off), this->edges.at(2*eid1+off));
@@ -2087,6 +2410,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::edge_switch_id(const uint eid0, const ui
     std::swap(this->e2f.at(eid0),     this->e2f.at(eid1));
     std::swap(this->e2p.at(eid0),     this->e2p.at(eid1));
     std::swap(this->e_data.at(eid0),  this->e_data.at(eid1));
+    this->e_props.swap(eid0, eid1);
 
     std::unordered_set<uint> verts_to_update;
     verts_to_update.insert(this->edge_vert_id(eid0,0));
@@ -2135,6 +2459,8 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::edge_add(const uint vid0, const uint vid1)
 {
+    this->adjacency_require(ADJ_ALL);
+    this->reset_spatial_indices();
     assert(this->edge_id(vid0, vid1)==-1); // make sure it doesn't exist already
     assert(vid0 < this->num_verts());
     assert(vid1 < this->num_verts());
@@ -2152,6 +2478,7 @@ uint AbstractPolyhedralMesh<M,V,E,F,P>::edge_add(const uint vid0, const uint vid
     //
     E data;
     this->e_data.push_back(data);
+    this->e_props.push_back();
     assert(this->edges.size()/2 == this->e_data.size());
     //
     this->v2v.at(vid1).push_back(vid0);
@@ -2178,11 +2505,14 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::edge_remove_unreferenced(const uint eid)
 {
+    this->adjacency_require(ADJ_ALL);
+    this->reset_spatial_indices();
     this->e2f.at(eid).clear();
     this->e2p.at(eid).clear();
     edge_switch_id(eid, this->num_edges()-1);
     this->edges.resize(this->edges.size()-2);
     this->e_data.pop_back();
+    this->e_props.pop_back();
     this->e2f.pop_back();
     this->e2p.pop_back();
 }
@@ -2193,12 +2523,14 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::face_switch_id(const uint fid0, const uint fid1)
 {
+    this->adjacency_require(ADJ_ALL);
     // should I do something for poly_face_winding?
 
     if (fid0 == fid1) return;
 
     std::swap(this->faces.at(fid0),          this->faces.at(fid1));
     std::swap(this->f_data.at(fid0),         this->f_data.at(fid1));
+    this->f_props.swap(fid0, fid1);
     std::swap(this->f2e.at(fid0),            this->f2e.at(fid1));
     std::swap(this->f2f.at(fid0),            this->f2f.at(fid1));
     std::swap(this->f2p.at(fid0),            this->f2p.at(fid1));
@@ -2263,6 +2595,8 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::face_add(const std::vector<uint> & f)
 {
+    this->adjacency_require(ADJ_ALL);
+    this->reset_spatial_indices();
     if(face_id(f)!=-1)
     {
         std::cout << ANSI_fg_color_red << "WARNING: adding duplicated face!" << ANSI_fg_color_default << std::endl;
@@ -2277,6 +2611,7 @@ uint AbstractPolyhedralMesh<M,V,E,F,P>::face_add(const std::vector<uint> & f)
 
     F data;
     this->f_data.push_back(data);
+    this->f_props.push_back();
     assert(this->faces.size() == this->f_data.size());
 
     this->f2e.push_back(std::vector<uint>());
@@ -2341,6 +2676,8 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::face_remove_unreferenced(const uint fid)
 {
+    this->adjacency_require(ADJ_ALL);
+    this->reset_spatial_indices();
     this->faces.at(fid).clear();
     this->f2e.at(fid).clear();
     this->f2f.at(fid).clear();
@@ -2349,6 +2686,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::face_remove_unreferenced(const uint fid)
     face_switch_id(fid, this->num_faces()-1);
     this->faces.pop_back();
     this->f_data.pop_back();
+    this->f_props.pop_back();
     this->f2e.pop_back();
     this->f2f.pop_back();
     this->f2p.pop_back();
@@ -2361,10 +2699,12 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::poly_switch_id(const uint pid0, const uint pid1)
 {
+    this->adjacency_require(ADJ_ALL);
     if (pid0 == pid1) return;
 
     std::swap(this->polys.at(pid0),              this->polys.at(pid1));
     std::swap(this->p_data.at(pid0),             this->p_data.at(pid1));
+    this->p_props.swap(pid0, pid1);
     std::swap(this->p2v.at(pid0),                this->p2v.at(pid1));
     std::swap(this->p2e.at(pid0),                this->p2e.at(pid1));
     std::swap(this->p2p.at(pid0),                this->p2p.at(pid1));
@@ -2430,6 +2770,8 @@ CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::poly_add(const std::vector<uint> & flist,
                                                  const std::vector<bool> & fwinding)
 {
+    this->adjacency_require(ADJ_ALL);
+    this->reset_spatial_indices();
     if(poly_id(flist)!=-1)
     {
         std::cout << ANSI_fg_color_red << "WARNING: adding duplicated poly!" << ANSI_fg_color_default << std::endl;
@@ -2446,6 +2788,7 @@ uint AbstractPolyhedralMesh<M,V,E,F,P>::poly_add(const std::vector<uint> & flist
 
     P data;
     this->p_data.push_back(data);
+    this->p_props.push_back();
     assert(this->polys.size() == this->p_data.size());
 
     this->p2v.push_back(std::vector<uint>());
@@ -2500,6 +2843,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::poly_add(const std::vector<uint> & vlist)
 {
+    this->adjacency_require(ADJ_ALL);
     if(vlist.size()==4) // tetrahedron
     {
         // detect faces
@@ -2662,6 +3006,8 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::poly_remove_unreferenced(const uint pid)
 {
+    this->adjacency_require(ADJ_ALL);
+    this->reset_spatial_indices();
     this->polys.at(pid).clear();
     this->p2v.at(pid).clear();
     this->p2e.at(pid).clear();
@@ -2670,6 +3016,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::poly_remove_unreferenced(const uint pid)
     poly_switch_id(pid, this->num_polys()-1);
     this->polys.pop_back();
     this->p_data.pop_back();
+    this->p_props.pop_back();
     this->p2v.pop_back();
     this->p2e.pop_back();
     this->p2p.pop_back();
@@ -2682,6 +3029,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::poly_remove(const uint pid, const bool delete_dangling_elements)
 {
+    this->adjacency_require(ADJ_ALL);
     std::set<uint,std::greater<uint>> dangling_verts; // higher ids first
     std::set<uint,std::greater<uint>> dangling_edges; // higher ids first
     std::set<uint,std::greater<uint>> dangling_faces; // higher ids first
@@ -2773,6 +3121,438 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::polys_remove(const std::vector<uint> & p
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::polys_rebuild(      std::vector<std::vector<uint>>                 & new_polys,
+                                                      const std::vector<int>                               & p_src,
+                                                      const std::vector<uint>                              & v_merge,
+                                                      const std::vector<std::pair<std::vector<uint>,uint>> & f_src,
+                                                      const std::vector<std::pair<ipair,uint>>             & e_src,
+                                                      const std::vector<uint>                              & v_moved,
+                                                            MeshIdMaps                                     & id_maps)
+{
+    this->adjacency_require(ADJ_ALL);
+    uint nv = this->num_verts();
+    uint ne = this->num_edges();
+    uint nf = this->num_faces();
+    uint np = this->num_polys();
+    assert(new_polys.size()==p_src.size());
+    assert(new_polys.size()>=np);
+    assert(v_merge.empty() || v_merge.size()==nv);
+
+    // compact vertices (keep only the referenced ones)
+    std::vector<int> & v_map = id_maps.v_map;
+    v_map.assign(nv,-1);
+    for(const auto & p : new_polys) for(uint vid : p) v_map.at(vid) = 0;
+    uint nv_new = 0;
+    for(uint vid=0; vid<nv; ++vid) if(v_map.at(vid)==0) v_map.at(vid) = nv_new++;
+    auto is_merged = [&](const uint vid) { return !v_merge.empty() && v_merge.at(vid)!=vid; };
+    for(uint vid=0; vid<nv; ++vid) if(is_merged(vid)) v_map.at(vid) = v_map.at(v_merge.at(vid));
+
+    // compact polyhedra. Vertices of polyhedra that changed (or disappeared) are marked
+    // as dirty, so that all the elements around them are refreshed at the end
+    std::vector<int> & p_map = id_maps.p_map;
+    p_map.assign(np,-1);
+    std::vector<bool> v_dirty_flag(nv_new, false);
+    std::vector<P>    p_data_new;
+    std::vector<int>  p_from_new; // source of the properties of each polyhedron (see PropertySet)
+    std::vector<int>  p_old; // current id of the polyhedra that did not change (-1 otherwise)
+    p_data_new.reserve(new_polys.size());
+    p_from_new.reserve(new_polys.size());
+    p_old.reserve(new_polys.size());
+    for(uint vid : v_moved) if(v_map.at(vid)>=0) v_dirty_flag.at(v_map.at(vid)) = true;
+    uint np_new = 0;
+    for(uint i=0; i<new_polys.size(); ++i)
+    {
+        bool changed = (i>=np || p_src.at(i)!=(int)i || new_polys.at(i)!=this->p2v.at(i));
+        if(changed && i<np) for(uint vid : this->p2v.at(i)) if(v_map.at(vid)>=0) v_dirty_flag.at(v_map.at(vid)) = true;
+        if(new_polys.at(i).empty()) continue;
+        assert(new_polys.at(i).size()==4 || new_polys.at(i).size()==8);
+
+        uint pid = np_new++;
+        int  src = p_src.at(i);
+        if(src>=0 && p_map.at(src)==-1) p_map.at(src) = pid;
+        p_data_new.push_back((src>=0) ? this->p_data.at(src) : P());
+        p_from_new.push_back(src);
+        p_old.push_back((changed) ? -1 : (int)i);
+
+        for(uint & vid : new_polys.at(i)) vid = v_map.at(vid);
+        if(changed) for(uint vid : new_polys.at(i)) v_dirty_flag.at(vid) = true;
+        if(pid!=i) new_polys.at(pid).swap(new_polys.at(i));
+    }
+    new_polys.resize(np_new);
+
+    // faces are generated first for the current faces that survive (so that they keep their
+    // relative order, vertex order and attributes), then for the new ones. Faces are matched
+    // by vertex set (sorted vertices, bucketed by smallest vertex), and those that do not bound
+    // any new polyhedron are discarded at the end. The vertex-to-face lists of the current mesh
+    // are recycled as buckets
+    std::vector<std::vector<uint>> faces_tmp;
+    std::vector<int>               f_from;
+    std::vector<uint>              f_keys; // 4 sorted vids per face (padded with -1 for triangles)
+    std::vector<bool>              f_keeps_tris;
+    faces_tmp.reserve(nf);
+    f_from.reserve(nf);
+    f_keys.reserve(4*nf);
+    std::vector<std::vector<uint>> & f_buckets = this->v2f;
+    f_buckets.resize(nv_new);
+    for(auto & l : f_buckets) l.clear();
+    auto make_key = [](const uint * f, const uint n, uint * key) -> bool
+    {
+        key[3] = uint(-1);
+        for(uint i=0; i<n; ++i) key[i] = f[i];
+        std::sort(key, key+n);
+        for(uint i=0; i<n; ++i) if(key[i]==uint(-1) || (i>0 && key[i]==key[i-1])) return false; // degenerate
+        return true;
+    };
+    auto find_face = [&](const uint * key) -> int
+    {
+        for(uint fid : f_buckets.at(key[0]))
+        {
+            const uint * k = &f_keys.at(4*fid);
+            if(k[1]==key[1] && k[2]==key[2] && k[3]==key[3]) return fid;
+        }
+        return -1;
+    };
+    auto add_face = [&](std::vector<uint> & f, const uint * key, const int src, const bool keeps_tris) -> uint
+    {
+        uint fid = f_from.size();
+        f_buckets.at(key[0]).push_back(fid);
+        f_keys.insert(f_keys.end(), key, key+4);
+        faces_tmp.push_back(std::vector<uint>());
+        faces_tmp.back().swap(f);
+        f_from.push_back(src);
+        f_keeps_tris.push_back(keeps_tris);
+        return fid;
+    };
+    std::vector<int> & f_map = id_maps.f_map;
+    f_map.assign(nf,-1);
+    uint key[4];
+    for(uint fid=0; fid<nf; ++fid)
+    {
+        bool merged = false;
+        std::vector<uint> & f = this->faces.at(fid);
+        for(uint & vid : f)
+        {
+            if(is_merged(vid)) merged = true;
+            vid = v_map.at(vid);
+        }
+        if(!make_key(f.data(), f.size(), key)) continue;
+        int id = find_face(key);
+        if(id<0) id = add_face(f, key, fid, !merged);
+        else if(!merged) // prefer faces that were there already (also their vertex order)
+        {
+            f_from.at(id) = fid;
+            faces_tmp.at(id).swap(f);
+            f_keeps_tris.at(id) = true;
+        }
+        f_map.at(fid) = id;
+    }
+    for(const auto & f : f_src)
+    {
+        std::vector<uint> tmp;
+        for(uint vid : f.first) tmp.push_back(v_map.at(vid));
+        if(!make_key(tmp.data(), tmp.size(), key)) continue;
+        int id = find_face(key);
+        if(id<0) add_face(tmp, key, f.second, false);
+        else if(f_from.at(id)<0) f_from.at(id) = f.second;
+    }
+    for(uint pid=0; pid<np_new; ++pid)
+    {
+        // polyhedra that did not change keep their faces and windings. Since p_old is
+        // increasing and p_old[pid]>=pid, lists can be moved in place
+        if(p_old.at(pid)<0) continue;
+        this->polys.at(pid).swap(this->polys.at(p_old.at(pid)));
+        this->polys_face_winding.at(pid).swap(this->polys_face_winding.at(p_old.at(pid)));
+        for(uint & fid : this->polys.at(pid)) fid = f_map.at(fid);
+    }
+    this->polys.resize(np_new);
+    this->polys_face_winding.resize(np_new);
+    for(uint pid=0; pid<np_new; ++pid)
+    {
+        if(p_old.at(pid)>=0) continue;
+        const std::vector<uint> & p = new_polys.at(pid);
+        bool is_tet = (p.size()==4);
+        uint n_faces = (is_tet) ? 4 : 6;
+        uint n_verts = (is_tet) ? 3 : 4;
+        std::vector<uint> & flist = this->polys.at(pid);
+        std::vector<bool> & w     = this->polys_face_winding.at(pid);
+        flist.clear();
+        w.clear();
+        for(uint i=0; i<n_faces; ++i)
+        {
+            uint f[4];
+            for(uint j=0; j<n_verts; ++j) f[j] = p.at((is_tet) ? TET_FACES[i][j] : HEXA_FACES[i][j]);
+            make_key(f, n_verts, key);
+            int fid = find_face(key);
+            if(fid<0)
+            {
+                std::vector<uint> tmp(f, f+n_verts);
+                fid = add_face(tmp, key, -1, false);
+            }
+            const std::vector<uint> & sf = faces_tmp.at(fid);
+            uint off = std::find(sf.begin(), sf.end(), f[0]) - sf.begin();
+            flist.push_back(fid);
+            w.push_back(sf.at((off+1)%sf.size())==f[1]);
+        }
+    }
+    std::vector<int> f_compact(f_from.size(),-1);
+    for(const auto & flist : this->polys) for(uint fid : flist) f_compact.at(fid) = 0;
+    uint nf_new = 0;
+    for(uint fid=0; fid<f_from.size(); ++fid) if(f_compact.at(fid)==0) f_compact.at(fid) = nf_new++;
+    for(int & fid : f_map) if(fid>=0) fid = f_compact.at(fid);
+    for(auto & flist : this->polys) for(uint & fid : flist) fid = f_compact.at(fid);
+
+    std::vector<std::vector<uint>> faces_new(nf_new), tris_new(nf_new);
+    std::vector<F>                 f_data_new(nf_new);
+    std::vector<int>               f_from_new(nf_new,-1);
+    std::vector<bool>              f_dirty_flag(nf_new,false);
+    std::vector<int>               f_old(nf_new,-1); // current id of the faces that did not change (-1 otherwise)
+    for(uint fid=0; fid<f_from.size(); ++fid)
+    {
+        int id = f_compact.at(fid);
+        if(id<0) continue;
+        faces_new.at(id).swap(faces_tmp.at(fid));
+        int src = f_from.at(fid);
+        if(src>=0) f_data_new.at(id) = this->f_data.at(src);
+        f_from_new.at(id) = src;
+        if(f_keeps_tris.at(fid))
+        {
+            f_old.at(id) = src;
+            tris_new.at(id).swap(this->face_triangles.at(src));
+            for(uint & vid : tris_new.at(id)) vid = v_map.at(vid);
+        }
+        else f_dirty_flag.at(id) = true;
+    }
+
+    // edges are generated the same way: current edges first, then the new ones. Edges that
+    // do not bound any face are discarded at the end
+    std::vector<uint> edges_tmp;
+    std::vector<int>  e_from;
+    edges_tmp.reserve(2*ne);
+    e_from.reserve(ne);
+    std::vector<std::vector<uint>> & v2e_tmp = this->v2e;
+    v2e_tmp.resize(nv_new);
+    for(auto & l : v2e_tmp) l.clear();
+    auto find_edge = [&](const uint v0, const uint v1) -> int
+    {
+        for(uint eid : v2e_tmp.at(v0))
+        {
+            if(edges_tmp.at(2*eid)+edges_tmp.at(2*eid+1)-v0 == v1) return eid;
+        }
+        return -1;
+    };
+    auto add_edge = [&](const uint v0, const uint v1, const int src) -> uint
+    {
+        uint eid = e_from.size();
+        edges_tmp.push_back(v0);
+        edges_tmp.push_back(v1);
+        e_from.push_back(src);
+        v2e_tmp.at(v0).push_back(eid);
+        v2e_tmp.at(v1).push_back(eid);
+        return eid;
+    };
+    std::vector<int> & e_map = id_maps.e_map;
+    e_map.assign(ne,-1);
+    for(uint eid=0; eid<ne; ++eid)
+    {
+        uint vid0 = this->edge_vert_id(eid,0);
+        uint vid1 = this->edge_vert_id(eid,1);
+        int  v0   = v_map.at(vid0);
+        int  v1   = v_map.at(vid1);
+        if(v0<0 || v1<0 || v0==v1) continue;
+        int id = find_edge(v0,v1);
+        if(id<0) id = add_edge(v0,v1,eid);
+        else if(!is_merged(vid0) && !is_merged(vid1)) e_from.at(id) = eid; // prefer edges that were there already
+        e_map.at(eid) = id;
+    }
+    for(const auto & e : e_src)
+    {
+        int v0 = v_map.at(e.first.first);
+        int v1 = v_map.at(e.first.second);
+        if(v0<0 || v1<0 || v0==v1) continue;
+        int id = find_edge(v0,v1);
+        if(id<0) add_edge(v0,v1,e.second);
+        else if(e_from.at(id)<0) e_from.at(id) = e.second;
+    }
+    this->f2e.resize(std::max(nf,nf_new));
+    for(uint fid=0; fid<nf_new; ++fid)
+    {
+        // faces that did not change keep their edges (f_old[fid]>=fid and each slot is used
+        // only once, hence lists can be moved in place)
+        std::vector<uint> & f2e = this->f2e.at(fid);
+        if(f_old.at(fid)>=0)
+        {
+            f2e.swap(this->f2e.at(f_old.at(fid)));
+            for(uint & eid : f2e) eid = e_map.at(eid);
+            continue;
+        }
+        const std::vector<uint> & f = faces_new.at(fid);
+        f2e.clear();
+        for(uint i=0; i<f.size(); ++i)
+        {
+            uint v0 = f.at(i);
+            uint v1 = f.at((i+1)%f.size());
+            int  id = find_edge(v0,v1);
+            if(id<0) id = add_edge(v0,v1,-1);
+            f2e.push_back(id);
+        }
+    }
+    this->f2e.resize(nf_new);
+    std::vector<int> e_compact(e_from.size(),-1);
+    for(const auto & f2e : this->f2e) for(uint eid : f2e) e_compact.at(eid) = 0;
+    uint ne_new = 0;
+    for(uint eid=0; eid<e_from.size(); ++eid) if(e_compact.at(eid)==0) e_compact.at(eid) = ne_new++;
+    for(int & eid : e_map) if(eid>=0) eid = e_compact.at(eid);
+    for(auto & f2e : this->f2e) for(uint & eid : f2e) eid = e_compact.at(eid);
+
+    // write the new mesh
+    std::vector<vec3d> verts_new(nv_new);
+    std::vector<V>     v_data_new(nv_new);
+    std::vector<int>   v_from_new(nv_new,-1);
+    for(uint vid=0; vid<nv; ++vid)
+    {
+        if(is_merged(vid) || v_map.at(vid)<0) continue;
+        verts_new.at(v_map.at(vid))  = this->verts.at(vid);
+        v_data_new.at(v_map.at(vid)) = this->v_data.at(vid);
+        v_from_new.at(v_map.at(vid)) = vid;
+    }
+    std::vector<uint> edges_new;
+    std::vector<E>    e_data_new;
+    std::vector<int>  e_from_new;
+    edges_new.reserve(2*ne_new);
+    e_data_new.reserve(ne_new);
+    e_from_new.reserve(ne_new);
+    for(uint eid=0; eid<e_from.size(); ++eid)
+    {
+        if(e_compact.at(eid)<0) continue;
+        edges_new.push_back(edges_tmp.at(2*eid));
+        edges_new.push_back(edges_tmp.at(2*eid+1));
+        e_data_new.push_back((e_from.at(eid)>=0) ? this->e_data.at(e_from.at(eid)) : E());
+        e_from_new.push_back(e_from.at(eid));
+    }
+
+    this->verts.swap(verts_new);
+    this->v_data.swap(v_data_new);
+    this->edges.swap(edges_new);
+    this->e_data.swap(e_data_new);
+    this->faces.swap(faces_new);
+    this->f_data.swap(f_data_new);
+    this->face_triangles.swap(tris_new);
+    this->p2v.swap(new_polys);
+    this->p_data.swap(p_data_new);
+    this->v_props.gather(v_from_new);
+    this->e_props.gather(e_from_new);
+    this->f_props.gather(f_from_new);
+    this->p_props.gather(p_from_new);
+
+    // rebuild adjacencies, recycling the memory of the current lists
+    auto reset = [](std::vector<std::vector<uint>> & adj, const uint size)
+    {
+        adj.resize(size);
+        for(auto & l : adj) l.clear();
+    };
+    reset(this->v2v, nv_new);
+    reset(this->v2e, nv_new);
+    reset(this->v2f, nv_new);
+    reset(this->v2p, nv_new);
+    reset(this->e2f, ne_new);
+    reset(this->e2p, ne_new);
+    reset(this->f2f, nf_new);
+    reset(this->f2p, nf_new);
+    reset(this->p2e, np_new);
+    reset(this->p2p, np_new);
+    for(uint eid=0; eid<ne_new; ++eid)
+    {
+        uint v0 = this->edges.at(2*eid);
+        uint v1 = this->edges.at(2*eid+1);
+        this->v2e.at(v0).push_back(eid);
+        this->v2e.at(v1).push_back(eid);
+        this->v2v.at(v0).push_back(v1);
+        this->v2v.at(v1).push_back(v0);
+    }
+    for(uint fid=0; fid<nf_new; ++fid)
+    {
+        for(uint vid : this->faces.at(fid)) this->v2f.at(vid).push_back(fid);
+        for(uint eid : this->f2e.at(fid))
+        {
+            for(uint nbr : this->e2f.at(eid))
+            {
+                if(DOES_NOT_CONTAIN_VEC(this->f2f.at(fid),nbr))
+                {
+                    this->f2f.at(fid).push_back(nbr);
+                    this->f2f.at(nbr).push_back(fid);
+                }
+            }
+            this->e2f.at(eid).push_back(fid);
+        }
+    }
+    for(uint pid=0; pid<np_new; ++pid)
+    {
+        for(uint vid : this->p2v.at(pid)) this->v2p.at(vid).push_back(pid);
+        for(uint fid : this->polys.at(pid))
+        {
+            for(uint eid : this->f2e.at(fid))
+            {
+                if(DOES_NOT_CONTAIN_VEC(this->p2e.at(pid),eid))
+                {
+                    this->p2e.at(pid).push_back(eid);
+                    this->e2p.at(eid).push_back(pid);
+                }
+            }
+            for(uint nbr : this->f2p.at(fid))
+            {
+                if(DOES_NOT_CONTAIN_VEC(this->p2p.at(pid),nbr))
+                {
+                    this->p2p.at(pid).push_back(nbr);
+                    this->p2p.at(nbr).push_back(pid);
+                }
+            }
+            this->f2p.at(fid).push_back(pid);
+        }
+    }
+    PARALLEL_FOR(0, np_new, 1000, [this](uint pid)
+    {
+        poly_reorder_p2v(pid);
+    });
+
+    // refresh tessellations, normals and quality only where something changed. Flags are used
+    // in place of update_dirty, which is much slower when the dirty set is a large part of the mesh
+    for(uint fid=0; fid<nf_new; ++fid)
+    {
+        if(f_dirty_flag.at(fid)) continue;
+        for(uint vid : this->faces.at(fid)) if(v_dirty_flag.at(vid)) { f_dirty_flag.at(fid) = true; break; }
+    }
+    PARALLEL_FOR(0, nf_new, 1000, [&](uint fid)
+    {
+        if(!f_dirty_flag.at(fid)) return;
+        update_f_tessellation(fid);
+        this->update_f_normal(fid);
+    });
+    PARALLEL_FOR(0, np_new, 1000, [&](uint pid)
+    {
+        for(uint vid : this->p2v.at(pid)) if(v_dirty_flag.at(vid)) { update_p_quality(pid); return; }
+    });
+    if(this->mesh_data().update_normals)
+    {
+        std::fill(v_dirty_flag.begin(), v_dirty_flag.end(), false);
+        for(uint fid=0; fid<nf_new; ++fid)
+        {
+            if(f_dirty_flag.at(fid) && face_is_on_srf(fid)) for(uint vid : this->faces.at(fid)) v_dirty_flag.at(vid) = true;
+        }
+        for(uint vid=0; vid<nv_new; ++vid) if(v_dirty_flag.at(vid)) update_v_normal(vid);
+    }
+
+    std::vector<uint> v_dirty_new;
+    for(uint vid : this->v_dirty) if(vid<nv && v_map.at(vid)>=0) v_dirty_new.push_back(v_map.at(vid));
+    this->v_dirty.swap(v_dirty_new);
+
+    if(this->mesh_data().update_bbox) this->update_bbox();
+    this->reset_spatial_indices();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 bool AbstractPolyhedralMesh<M,V,E,F,P>::poly_faces_share_orientation(const uint pid, const uint fid0, const uint fid1) const
@@ -2944,6 +3724,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::poly_export_element(const uint
                                                              std::vector<vec3d>             & verts,
                                                              std::vector<std::vector<uint>> & faces) const
 {
+    this->adjacency_require(ADJ_FACES);
     std::unordered_map<uint,uint> v_map;
     for(uint fid : this->adj_p2f(pid))
     {
@@ -2986,6 +3767,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 std::vector<bool> AbstractPolyhedralMesh<M,V,E,F,P>::poly_faces_winding(const uint pid) const
 {
+    this->adjacency_require(ADJ_FACES);
     return this->polys_face_winding.at(pid);
 }
 
@@ -2995,13 +3777,25 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::pick_face(const vec3d & p) const
 {
-    std::vector<std::pair<double,uint>> closest;
-    for(uint fid=0; fid<this->num_faces(); ++fid)
+    if(kd_faces.size()!=this->num_faces())
     {
-        if(!this->face_data(fid).flags[HIDDEN]) closest.push_back(std::make_pair(this->face_centroid(fid).dist(p),fid));
+        std::vector<vec3d> centroids(this->num_faces());
+        for(uint fid=0; fid<this->num_faces(); ++fid) centroids[fid] = this->face_centroid(fid);
+        kd_faces.build(centroids);
     }
-    std::sort(closest.begin(), closest.end());
-    return closest.front().second;
+    int fid = kd_faces.nearest(p, [this](const uint fid) { return this->face_data(fid).flags[HIDDEN]; });
+    assert(fid>=0);
+    return fid;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::reset_spatial_indices()
+{
+    AbstractMesh<M,V,E,P>::reset_spatial_indices();
+    kd_faces.clear();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -56,6 +56,7 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
         std::vector<std::vector<bool>> polys_face_winding; // true if the face is CCW, false if it is CW
 
         std::vector<F> f_data;
+        PropertySet    f_props;
 
         std::vector<std::vector<uint>> v2f; // vert to face adjacency
         std::vector<std::vector<uint>> e2f; // edge to face adjacency
@@ -66,6 +67,8 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
 
         std::vector<std::vector<uint>> face_triangles; // per face serialized triangulation (e.g., for rendering)
 
+        mutable KdTree kd_faces; // face centroids, for picking (see pick_face)
+
     public:
 
         typedef F F_type;
@@ -76,6 +79,8 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         void clear() override;
+        void reset_spatial_indices() override;
+        void permute(const MeshIdMaps & id_maps) override; // also uses id_maps.f_map
 
         void init(const std::vector<vec3d>             & verts,
                   const std::vector<std::vector<uint>> & faces,
@@ -105,18 +110,19 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
                 void update_f_normals();
         virtual void update_f_normal(const uint fid) = 0;
                 void update_f_tessellation();
-                void update_f_tessellation(const uint fid);
+                void update_f_tessellation(const uint fid); // rebuilds the triangles of fid from scratch (can be called repeatedly)
                 void update_v_normals();
                 void update_v_normal(const uint vid);
                 void update_quality();
                 void update_p_quality(const uint pid);
+                void update_dirty(); // refresh normals, tessellation and quality only around the verts marked with vert_set_dirty()
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         virtual uint verts_per_poly(const uint pid) const override { return this->p2v.at(pid).size();   }
-        virtual uint faces_per_poly(const uint pid) const          { return this->polys.at(pid).size(); }
-        virtual uint verts_per_face(const uint fid) const          { return this->faces.at(fid).size(); }
-        virtual uint edges_per_face(const uint fid) const          { return this->faces.at(fid).size(); }
+        virtual uint faces_per_poly(const uint pid) const          { this->adjacency_require(ADJ_FACES); return this->polys.at(pid).size(); }
+        virtual uint verts_per_face(const uint fid) const          { this->adjacency_require(ADJ_FACES); return this->faces.at(fid).size(); }
+        virtual uint edges_per_face(const uint fid) const          { this->adjacency_require(ADJ_FACES); return this->faces.at(fid).size(); }
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -124,11 +130,11 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
         uint num_srf_edges() const;
         uint num_srf_faces() const;
         uint num_srf_polys() const;
-        uint num_faces()     const { return faces.size(); }
+        uint num_faces()     const { this->adjacency_require(ADJ_FACES); return faces.size(); }
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        const std::vector<std::vector<uint>> & vector_faces() const { return faces; }
+        const std::vector<std::vector<uint>> & vector_faces() const { this->adjacency_require(ADJ_FACES); return faces; }
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -138,31 +144,34 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        const std::vector<uint> & adj_v2f(const uint vid) const          { return v2f.at(vid);         }
-              std::vector<uint> & adj_v2f(const uint vid)                { return v2f.at(vid);         }
-        const std::vector<uint> & adj_e2f(const uint eid) const          { return e2f.at(eid);         }
-              std::vector<uint> & adj_e2f(const uint eid)                { return e2f.at(eid);         }
-        const std::vector<uint> & adj_f2v(const uint fid) const          { return this->faces.at(fid); }
-              std::vector<uint> & adj_f2v(const uint fid)                { return this->faces.at(fid); }
-        const std::vector<uint> & adj_f2e(const uint fid) const          { return f2e.at(fid);         }
-              std::vector<uint> & adj_f2e(const uint fid)                { return f2e.at(fid);         }
-        const std::vector<uint> & adj_f2f(const uint fid) const          { return f2f.at(fid);         }
-              std::vector<uint> & adj_f2f(const uint fid)                { return f2f.at(fid);         }
-        const std::vector<uint> & adj_f2p(const uint fid) const          { return f2p.at(fid);         }
-              std::vector<uint> & adj_f2p(const uint fid)                { return f2p.at(fid);         }
-        const std::vector<uint> & adj_p2f(const uint pid) const          { return this->polys.at(pid); }
-              std::vector<uint> & adj_p2f(const uint pid)                { return this->polys.at(pid); }
+        const std::vector<uint> & adj_v2f(const uint vid) const          { this->adjacency_require(ADJ_FACES); return v2f.at(vid);         }
+              std::vector<uint> & adj_v2f(const uint vid)                { this->adjacency_require(ADJ_FACES); return v2f.at(vid);         }
+        const std::vector<uint> & adj_e2f(const uint eid) const          { this->adjacency_require(ADJ_FACES); return e2f.at(eid);         }
+              std::vector<uint> & adj_e2f(const uint eid)                { this->adjacency_require(ADJ_FACES); return e2f.at(eid);         }
+        const std::vector<uint> & adj_f2v(const uint fid) const          { this->adjacency_require(ADJ_FACES); return this->faces.at(fid); }
+              std::vector<uint> & adj_f2v(const uint fid)                { this->adjacency_require(ADJ_FACES); return this->faces.at(fid); }
+        const std::vector<uint> & adj_f2e(const uint fid) const          { this->adjacency_require(ADJ_FACES); return f2e.at(fid);         }
+              std::vector<uint> & adj_f2e(const uint fid)                { this->adjacency_require(ADJ_FACES); return f2e.at(fid);         }
+        const std::vector<uint> & adj_f2f(const uint fid) const          { this->adjacency_require(ADJ_FACES); return f2f.at(fid);         }
+              std::vector<uint> & adj_f2f(const uint fid)                { this->adjacency_require(ADJ_FACES); return f2f.at(fid);         }
+        const std::vector<uint> & adj_f2p(const uint fid) const          { this->adjacency_require(ADJ_FACES); return f2p.at(fid);         }
+              std::vector<uint> & adj_f2p(const uint fid)                { this->adjacency_require(ADJ_FACES); return f2p.at(fid);         }
+        const std::vector<uint> & adj_p2f(const uint pid) const          { this->adjacency_require(ADJ_FACES); return this->polys.at(pid); }
+              std::vector<uint> & adj_p2f(const uint pid)                { this->adjacency_require(ADJ_FACES); return this->polys.at(pid); }
         const std::vector<uint> & adj_p2v(const uint pid) const override { return p2v.at(pid);         }
               std::vector<uint> & adj_p2v(const uint pid)       override { return p2v.at(pid);         }
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        const F & face_data(const uint fid) const { return f_data.at(fid); }
-              F & face_data(const uint fid)       { return f_data.at(fid); }
+        const F & face_data(const uint fid) const { this->adjacency_require(ADJ_FACES); return f_data.at(fid); }
+              F & face_data(const uint fid)       { this->adjacency_require(ADJ_FACES); return f_data.at(fid); }
+
+        const PropertySet & face_properties() const { this->adjacency_require(ADJ_FACES); return f_props; }
+              PropertySet & face_properties()       { this->adjacency_require(ADJ_FACES); return f_props; }
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        // useful for GUIs with mouse picking
+        // useful for GUIs with mouse picking (see AbstractMesh::pick_vert for details)
         uint pick_face(const vec3d & p) const;
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -300,6 +309,40 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
                 bool               poly_is_prism               (const uint pid, const uint fid) const; // check if it is a prism using fid as base
                 bool               poly_is_hexable_w_midpoint  (const uint pid) const; // check if this element can be hexed with midpoint subdivision
 
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // polys_rebuild replaces the whole list of polyhedra with new_polys, rebuilding all the
+        // connectivity at once. It is the volumetric counterpart of AbstractPolygonMesh::polys_rebuild,
+        // and the backend of the batched editing operators (see for instance Tetmesh::edges_split).
+        // Inputs are all expressed in current ids (new verts must be added with vert_add beforehand):
+        //
+        //   new_polys : new polyhedra, as lists of vertices in standard ordering (tetrahedra or
+        //               hexahedra only). Empty lists are discarded. The list is consumed
+        //   p_src     : polyhedron each new polyhedron inherits attributes from (-1 for defaults)
+        //   v_merge   : vertex each vertex is merged into (itself otherwise). Can be empty
+        //   f_src     : attribute sources for new faces. Surviving faces keep their attributes
+        //   e_src     : attribute sources for new edges. Surviving edges keep their attributes
+        //   v_moved   : vertices that were repositioned
+        //
+        // Elements not referenced by any polyhedron are removed, and surviving elements keep
+        // their relative order. Old to new ids are returned in id_maps
+        //
+        void polys_rebuild(      std::vector<std::vector<uint>>                 & new_polys,
+                           const std::vector<int>                               & p_src,
+                           const std::vector<uint>                              & v_merge,
+                           const std::vector<std::pair<std::vector<uint>,uint>> & f_src,
+                           const std::vector<std::pair<ipair,uint>>             & e_src,
+                           const std::vector<uint>                              & v_moved,
+                                 MeshIdMaps                                     & id_maps);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    protected:
+
+        void init_soup(const std::vector<vec3d>             & verts,
+                       const std::vector<std::vector<uint>> & polys);
+
+        void adjacency_build(const int relations) override;
 };
 
 }
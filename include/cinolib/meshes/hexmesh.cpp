@@ -160,6 +160,7 @@ void Hexmesh<M,V,E,F,P>::save(const char * filename) const
     else if (filetype.compare(".hedra") == 0 ||
              filetype.compare(".HEDRA") == 0)
     {
+        this->adjacency_require(ADJ_FACES);
         write_HEDRA(filename, this->verts, this->faces, this->polys, this->polys_face_winding);
     }
     else
@@ -0,0 +1,259 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/meshes/mesh_properties.h>
+#include <cinolib/stl_container_utilities.h>
+#include <cassert>
+#include <utility>
+
+namespace cinolib
+{
+
+template<typename T>
+CINO_INLINE
+void Property<T>::swap(const uint i, const uint j)
+{
+    T tmp       = data.at(i);
+    data.at(i)  = data.at(j);
+    data.at(j)  = tmp;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+void Property<T>::permute(const std::vector<int> & old2new)
+{
+    PERMUTE_VEC(data, old2new);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+void Property<T>::gather(const std::vector<int> & from)
+{
+    std::vector<T> tmp(from.size(), def);
+    for(uint i=0; i<from.size(); ++i) if(from.at(i)>=0) tmp.at(i) = data.at(from.at(i));
+    data.swap(tmp);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+PropertySet::PropertySet(const PropertySet & ps)
+{
+    *this = ps;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+PropertySet & PropertySet::operator=(const PropertySet & ps)
+{
+    if(this==&ps) return *this;
+    n_elems = ps.n_elems;
+    props.clear();
+    for(const auto & p : ps.props) props[p.first] = std::unique_ptr<AbstractProperty>(p.second->clone());
+    return *this;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+std::vector<T> & PropertySet::add(const std::string & name, const T & def)
+{
+    auto it = props.find(name);
+    if(it!=props.end())
+    {
+        assert(it->second->type()==typeid(T) && "property already exists, with a different type");
+        return get<T>(name);
+    }
+    Property<T> * p = new Property<T>(n_elems, def);
+    props[name] = std::unique_ptr<AbstractProperty>(p);
+    return p->data;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+std::vector<T> & PropertySet::get(const std::string & name)
+{
+    auto it = props.find(name);
+    assert(it!=props.end() && "property not found");
+    assert(it->second->type()==typeid(T) && "wrong property type");
+    return static_cast<Property<T>*>(it->second.get())->data;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+const std::vector<T> & PropertySet::get(const std::string & name) const
+{
+    auto it = props.find(name);
+    assert(it!=props.end() && "property not found");
+    assert(it->second->type()==typeid(T) && "wrong property type");
+    return static_cast<const Property<T>*>(it->second.get())->data;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+bool PropertySet::exists(const std::string & name) const
+{
+    auto it = props.find(name);
+    return (it!=props.end() && it->second->type()==typeid(T));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool PropertySet::exists(const std::string & name) const
+{
+    return props.find(name)!=props.end();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertySet::remove(const std::string & name)
+{
+    props.erase(name);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertySet::remove_all()
+{
+    props.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<std::string> PropertySet::names() const
+{
+    std::vector<std::string> list;
+    for(const auto & p : props) list.push_back(p.first);
+    return list;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+size_t PropertySet::bytes() const
+{
+    size_t b = 0;
+    for(const auto & p : props) b += p.second->bytes();
+    return b;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertySet::reserve(const size_t n)
+{
+    for(auto & p : props) p.second->reserve(n);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertySet::resize(const size_t n)
+{
+    n_elems = n;
+    for(auto & p : props) p.second->resize(n);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertySet::push_back()
+{
+    ++n_elems;
+    for(auto & p : props) p.second->push_back();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertySet::pop_back()
+{
+    assert(n_elems>0);
+    --n_elems;
+    for(auto & p : props) p.second->pop_back();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertySet::swap(const uint i, const uint j)
+{
+    for(auto & p : props) p.second->swap(i,j);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertySet::permute(const std::vector<int> & old2new)
+{
+    assert(old2new.size()==n_elems);
+    for(auto & p : props) p.second->permute(old2new);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertySet::gather(const std::vector<int> & from)
+{
+    n_elems = from.size();
+    for(auto & p : props) p.second->gather(from);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertySet::clear()
+{
+    n_elems = 0;
+    for(auto & p : props) p.second->clear();
+}
+
+}
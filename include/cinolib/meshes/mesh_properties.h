@@ -0,0 +1,172 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_MESH_PROPERTIES_H
+#define CINO_MESH_PROPERTIES_H
+
+#include <map>
+#include <vector>
+#include <string>
+#include <memory>
+#include <typeinfo>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+
+namespace cinolib
+{
+
+/* Runtime attribute layers. Differently from the attributes in mesh_attributes.h,
+ * which are bundled into one struct per element (array of structures), each
+ * property is stored in its own contiguous array (structure of arrays), and can
+ * be added or removed at runtime by name. A pipeline therefore pays (in memory and
+ * bandwidth) only for the attributes it actually uses, and a loop over a property
+ * reads a dense array, without striding over all the other attributes.
+ *
+ * Every mesh owns one PropertySet per element type, and keeps it in sync with its
+ * elements (additions, removals, id switches, batched edits, permutations):
+ *
+ *    std::vector<float> & w = m.vert_properties().add<float>("weight", 1.f);
+ *    for(uint vid=0; vid<m.num_verts(); ++vid) w.at(vid) = ...
+ *    ...
+ *    m.vert_properties().remove("weight");
+ *
+ * The returned arrays can be read and written, but must not be resized. References
+ * to them remain valid until the property is removed, but (as for any std::vector)
+ * they are invalidated when elements are added to the mesh.
+*/
+
+class AbstractProperty
+{
+    public:
+
+        virtual ~AbstractProperty() {}
+
+        virtual AbstractProperty      * clone()                                 const = 0;
+        virtual const std::type_info  & type()                                  const = 0;
+        virtual size_t                  size()                                  const = 0;
+        virtual size_t                  bytes()                                 const = 0;
+        virtual void                    reserve  (const size_t n)                     = 0;
+        virtual void                    resize   (const size_t n)                     = 0; // new entries get the default value
+        virtual void                    push_back()                                   = 0; // appends the default value
+        virtual void                    pop_back ()                                   = 0;
+        virtual void                    swap     (const uint i, const uint j)         = 0;
+        virtual void                    permute  (const std::vector<int> & old2new)   = 0; // see PERMUTE_VEC
+        virtual void                    gather   (const std::vector<int> & from)      = 0; // new[i] = old[from[i]] (default if from[i]<0)
+        virtual void                    clear()                                       = 0;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+class Property : public AbstractProperty
+{
+    public:
+
+        explicit Property(const size_t n, const T & def) : data(n,def), def(def) {}
+
+        AbstractProperty      * clone()    const override { return new Property<T>(*this); }
+        const std::type_info  & type()     const override { return typeid(T);              }
+        size_t                  size()     const override { return data.size();            }
+        size_t                  bytes()    const override { return data.capacity()*sizeof(T); }
+        void                    reserve  (const size_t n)               override { data.reserve(n);     }
+        void                    resize   (const size_t n)               override { data.resize(n, def); }
+        void                    push_back()                             override { data.push_back(def); }
+        void                    pop_back ()                             override { data.pop_back();     }
+        void                    swap     (const uint i, const uint j)   override;
+        void                    permute  (const std::vector<int> & old2new) override;
+        void                    gather   (const std::vector<int> & from)    override;
+        void                    clear()                                 override { data.clear();        }
+
+        std::vector<T> data;
+        T              def;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+class PropertySet
+{
+    public:
+
+        explicit PropertySet() {}
+
+        PropertySet(const PropertySet & ps);
+        PropertySet & operator=(const PropertySet & ps);
+        PropertySet(PropertySet && ps) = default;
+        PropertySet & operator=(PropertySet && ps) = default;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // adds a property initialized with def for all the current elements. If a property
+        // with the same name and type already exists, it is returned as it is
+        template<typename T> std::vector<T>       & add(const std::string & name, const T & def = T());
+        template<typename T> std::vector<T>       & get(const std::string & name);
+        template<typename T> const std::vector<T> & get(const std::string & name) const;
+        template<typename T> bool                   exists(const std::string & name) const; // also checks the type
+                             bool                   exists(const std::string & name) const;
+                             void                   remove(const std::string & name);
+                             void                   remove_all();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        std::vector<std::string> names()         const;
+        uint                     num_properties() const { return props.size(); }
+        uint                     num_elements()   const { return n_elems;       }
+        size_t                   bytes()          const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // used by the meshes to keep all properties in sync with their elements
+        void reserve  (const size_t n);
+        void resize   (const size_t n);
+        void push_back();
+        void pop_back ();
+        void swap     (const uint i, const uint j);
+        void permute  (const std::vector<int> & old2new);
+        void gather   (const std::vector<int> & from);
+        void clear();
+
+    protected:
+
+        size_t                                                  n_elems = 0;
+        std::map<std::string,std::unique_ptr<AbstractProperty>> props;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "mesh_properties.cpp"
+#endif
+
+#endif // CINO_MESH_PROPERTIES_H
@@ -135,6 +135,7 @@ void Polyhedralmesh<M,V,E,F,P>::save(const char * filename) const
     if (filetype.compare(".hedra") == 0 ||
         filetype.compare(".HEDRA") == 0)
     {
+        this->adjacency_require(ADJ_FACES);
         write_HEDRA(filename, this->verts, this->faces, this->polys, this->polys_face_winding);
     }
     else
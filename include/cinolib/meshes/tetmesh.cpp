@@ -42,6 +42,8 @@
 #include <cinolib/cot.h>
 #include <cinolib/symbols.h>
 #include <cinolib/io/io_utilities.h>
+#include <numeric>
+#include <set>
 
 namespace cinolib
 {
@@ -161,6 +163,7 @@ void Tetmesh<M,V,E,F,P>::save(const char * filename) const
     else if (filetype.compare(".hedra") == 0 ||
              filetype.compare(".HEDRA") == 0)
     {
+        this->adjacency_require(ADJ_FACES);
         write_HEDRA(filename, this->verts, this->faces, this->polys, this->polys_face_winding);
     }
     else
@@ -470,7 +473,7 @@ bool Tetmesh<M,V,E,F,P>::face_flip(const uint fid, bool geometric_check) // 2-to
             if(orient3d(this->vert(tets[i][0]),
                         this->vert(tets[i][1]),
                         this->vert(tets[i][2]),
-                        this->vert(tets[i][3]))<=0) return false;
+                        this->vert(tets[i][3]))>=0) return false; // standard tets have negative orientation
         }
         ++i;
     }
@@ -492,6 +495,201 @@ bool Tetmesh<M,V,E,F,P>::face_flip(const uint fid, bool geometric_check) // 2-to
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+std::vector<int> Tetmesh<M,V,E,F,P>::edges_split(const std::vector<uint> & eids, MeshIdMaps & id_maps, const double lambda)
+{
+    this->adjacency_require(ADJ_ALL);
+    uint nv = this->num_verts();
+    std::vector<std::vector<uint>> polys = this->p2v;
+    std::vector<int> p_src(polys.size());
+    std::iota(p_src.begin(), p_src.end(), 0);
+    std::vector<std::pair<std::vector<uint>,uint>> f_src;
+    std::vector<std::pair<ipair,uint>> e_src;
+    std::vector<bool> p_locked(this->num_polys(), false);
+    std::vector<int>  res(eids.size(), -1);
+
+    for(uint i=0; i<eids.size(); ++i)
+    {
+        uint eid = eids.at(i);
+        if(this->edge_valence(eid)==0) continue;
+        bool locked = false;
+        for(uint pid : this->adj_e2p(eid)) if(p_locked.at(pid)) locked = true;
+        if(locked) continue;
+
+        uint vid0    = this->edge_vert_id(eid,0);
+        uint vid1    = this->edge_vert_id(eid,1);
+        uint new_vid = this->vert_add(this->edge_sample_at(eid,lambda));
+
+        // each tet is split in two: one takes the place of the original
+        // tet, the other goes at the end of the list
+        for(uint pid : this->adj_e2p(eid))
+        {
+            p_locked.at(pid) = true;
+            std::vector<uint> p = polys.at(pid);
+            for(uint & vid : polys.at(pid)) if(vid==vid1) vid = new_vid;
+            for(uint & vid : p)             if(vid==vid0) vid = new_vid;
+            polys.push_back(p);
+            p_src.push_back(pid);
+        }
+
+        // propagate attributes to sub-elements
+        e_src.push_back(std::make_pair(ipair(vid0,new_vid),eid));
+        e_src.push_back(std::make_pair(ipair(vid1,new_vid),eid));
+        for(uint fid : this->adj_e2f(eid))
+        {
+            uint vopp = this->face_vert_opposite_to(fid,eid);
+            f_src.push_back(std::make_pair(std::vector<uint>({vid0,new_vid,vopp}),fid));
+            f_src.push_back(std::make_pair(std::vector<uint>({vid1,new_vid,vopp}),fid));
+        }
+        res.at(i) = new_vid;
+    }
+
+    this->polys_rebuild(polys, p_src, {}, f_src, e_src, {}, id_maps);
+
+    for(int & vid : res) if(vid>=0) vid = id_maps.v_map.at(vid);
+    id_maps.v_map.resize(nv);
+    return res;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+std::vector<int> Tetmesh<M,V,E,F,P>::edges_collapse(const std::vector<uint> & eids,
+                                                    MeshIdMaps              & id_maps,
+                                                    const double              lambda,
+                                                    const bool                topologic_check,
+                                                    const bool                geometric_check)
+{
+    this->adjacency_require(ADJ_ALL);
+    std::vector<std::vector<uint>> polys = this->p2v;
+    std::vector<int> p_src(polys.size());
+    std::iota(p_src.begin(), p_src.end(), 0);
+    std::vector<uint> v_merge(this->num_verts());
+    std::iota(v_merge.begin(), v_merge.end(), 0);
+    std::vector<uint>  v_moved;
+    std::vector<vec3d> v_pos;
+    std::vector<bool>  p_locked(this->num_polys(), false);
+    std::vector<int>   res(eids.size(), -1);
+
+    for(uint i=0; i<eids.size(); ++i)
+    {
+        // the whole star of the edge changes, hence it must be untouched by previous
+        // collapses (this also guarantees that the checks below are still valid)
+        uint eid  = eids.at(i);
+        uint vid0 = this->edge_vert_id(eid,0);
+        uint vid1 = this->edge_vert_id(eid,1);
+        bool locked = false;
+        for(uint pid : this->adj_v2p(vid0)) if(p_locked.at(pid)) locked = true;
+        for(uint pid : this->adj_v2p(vid1)) if(p_locked.at(pid)) locked = true;
+        if(locked) continue;
+
+        vec3d p = this->edge_sample_at(eid, lambda);
+        if(topologic_check && !edge_is_topologically_collapsible(eid))    continue;
+        if(geometric_check && !edge_is_geometrically_collapsible(eid, p)) continue;
+
+        for(uint pid : this->adj_v2p(vid0)) p_locked.at(pid) = true;
+        for(uint pid : this->adj_v2p(vid1)) p_locked.at(pid) = true;
+
+        uint vert_to_keep   = std::min(vid0,vid1); // remove vert with highest ID
+        uint vert_to_remove = std::max(vid0,vid1);
+        v_moved.push_back(vert_to_keep);
+        v_pos.push_back(p);
+        v_merge.at(vert_to_remove) = vert_to_keep;
+
+        for(uint pid : this->adj_v2p(vert_to_remove))
+        {
+            if(this->poly_contains_edge(pid, eid)) polys.at(pid).clear();
+            else for(uint & vid : polys.at(pid)) if(vid==vert_to_remove) vid = vert_to_keep;
+        }
+        res.at(i) = vert_to_keep;
+    }
+
+    for(uint i=0; i<v_moved.size(); ++i) this->vert(v_moved.at(i)) = v_pos.at(i);
+
+    this->polys_rebuild(polys, p_src, v_merge, {}, {}, v_moved, id_maps);
+
+    for(int & vid : res) if(vid>=0) vid = id_maps.v_map.at(vid);
+    return res;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+std::vector<int> Tetmesh<M,V,E,F,P>::faces_flip(const std::vector<uint> & fids, MeshIdMaps & id_maps, const bool geometric_check)
+{
+    this->adjacency_require(ADJ_ALL);
+    std::vector<std::vector<uint>> polys = this->p2v;
+    std::vector<int> p_src(polys.size());
+    std::iota(p_src.begin(), p_src.end(), 0);
+    std::vector<ipair> new_edges;
+    std::set<ipair>    new_edges_set;
+    std::vector<bool>  p_locked(this->num_polys(), false);
+    std::vector<int>   res(fids.size(), -1);
+
+    for(uint i=0; i<fids.size(); ++i)
+    {
+        uint fid = fids.at(i);
+        if(this->adj_f2p(fid).size()!=2) continue;
+        uint pid0 = this->adj_f2p(fid).front();
+        uint pid1 = this->adj_f2p(fid).back();
+        if(p_locked.at(pid0) || p_locked.at(pid1)) continue;
+        uint opp0 = this->poly_vert_opposite_to(pid0, fid);
+        uint opp1 = this->poly_vert_opposite_to(pid1, fid);
+
+        // the new edge must not exist already (neither in the mesh nor in the batch)
+        if(this->edge_id(opp0, opp1)!=-1) continue;
+        if(new_edges_set.count(unique_pair(opp0,opp1))>0) continue;
+
+        // each new tet is obtained from pid0 by replacing one of the vertices of
+        // fid with opp1, and must have the same orientation of pid0
+        std::vector<std::vector<uint>> tets;
+        bool valid = true;
+        for(uint vid : this->adj_f2v(fid))
+        {
+            std::vector<uint> tet = this->adj_p2v(pid0);
+            for(uint & v : tet) if(v==vid) v = opp1;
+            tets.push_back(tet);
+        }
+        if(geometric_check)
+        {
+            const std::vector<uint> & p = this->adj_p2v(pid0);
+            double o = orient3d(this->vert(p[0]), this->vert(p[1]), this->vert(p[2]), this->vert(p[3]));
+            for(const auto & tet : tets)
+            {
+                double ot = orient3d(this->vert(tet[0]), this->vert(tet[1]), this->vert(tet[2]), this->vert(tet[3]));
+                if(ot*o<=0) valid = false;
+            }
+        }
+        if(!valid) continue;
+
+        p_locked.at(pid0) = true;
+        p_locked.at(pid1) = true;
+        polys.at(pid0) = tets.at(0);
+        polys.at(pid1) = tets.at(1);
+        polys.push_back(tets.at(2));
+        p_src.push_back(pid0);
+        res.at(i) = new_edges.size(); // temporary: position of the new edge in new_edges
+        new_edges.push_back(unique_pair(opp0,opp1));
+        new_edges_set.insert(new_edges.back());
+    }
+
+    this->polys_rebuild(polys, p_src, {}, {}, {}, {}, id_maps);
+
+    for(uint i=0; i<fids.size(); ++i)
+    {
+        if(res.at(i)<0) continue;
+        const ipair & e = new_edges.at(res.at(i));
+        res.at(i) = this->edge_id(id_maps.v_map.at(e.first), id_maps.v_map.at(e.second));
+        assert(res.at(i)>=0);
+    }
+    return res;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 bool Tetmesh<M,V,E,F,P>::edge_flip(const uint eid) // 3-to-2 flip
@@ -113,6 +113,19 @@ class Tetmesh : public AbstractPolyhedralMesh<M,V,E,F,P>
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+        // batched versions of edge_split, edge_collapse and face_flip. All operations refer to the
+        // mesh as it is before the call, and are validated against it. An operation that touches a
+        // tetrahedron already modified by a previous operation in the list is discarded (call again
+        // to process it). Connectivity is rebuilt only once, and ids are compacted (see
+        // AbstractPolyhedralMesh::polys_rebuild). For each operation, the returned vector contains
+        // the (new) id of the vertex created or kept (split and collapse) or of the edge created
+        // (flip), or -1 if the operation was not applied
+        std::vector<int> edges_split   (const std::vector<uint> & eids, MeshIdMaps & id_maps, const double lambda = 0.5);
+        std::vector<int> edges_collapse(const std::vector<uint> & eids, MeshIdMaps & id_maps, const double lambda = 0.5, const bool topologic_check = true, const bool geometric_check = true);
+        std::vector<int> faces_flip    (const std::vector<uint> & fids, MeshIdMaps & id_maps, const bool geometric_check = true); // 2-to-3 flips
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
         bool   face_flip            (const uint fid, const bool geometric_check = true); // 2-to-3 flip
         double face_area            (const uint fid) const;
         uint   face_edge_opposite_to(const uint fid, const uint vid) const;
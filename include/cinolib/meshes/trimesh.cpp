@@ -40,6 +40,8 @@
 #include <cinolib/vector_serialization.h>
 
 #include <unordered_set>
+#include <numeric>
+#include <set>
 
 namespace cinolib
 {
@@ -453,6 +455,167 @@ int Trimesh<M,V,E,P>::edge_flip(const uint eid, const bool geometric_check)
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<int> Trimesh<M,V,E,P>::edges_split(const std::vector<uint> & eids, MeshIdMaps & id_maps, const double lambda)
+{
+    uint nv = this->num_verts();
+    std::vector<std::vector<uint>> polys = this->polys;
+    std::vector<int> p_src(polys.size());
+    std::iota(p_src.begin(), p_src.end(), 0);
+    std::vector<std::pair<ipair,uint>> e_src;
+    std::vector<bool> p_locked(this->num_polys(), false);
+    std::vector<int>  res(eids.size(), -1);
+
+    for(uint i=0; i<eids.size(); ++i)
+    {
+        uint eid = eids.at(i);
+        bool locked = false;
+        for(uint pid : this->adj_e2p(eid)) if(p_locked.at(pid)) locked = true;
+        if(locked) continue;
+
+        uint vid0    = this->edge_vert_id(eid,0);
+        uint vid1    = this->edge_vert_id(eid,1);
+        uint new_vid = this->vert_add(this->edge_sample_at(eid,lambda));
+
+        // each triangle is split in two: one takes the place of the original
+        // triangle, the other goes at the end of the list
+        for(uint pid : this->adj_e2p(eid))
+        {
+            p_locked.at(pid) = true;
+            std::vector<uint> p = polys.at(pid);
+            for(uint & vid : polys.at(pid)) if(vid==vid1) vid = new_vid;
+            for(uint & vid : p)             if(vid==vid0) vid = new_vid;
+            polys.push_back(p);
+            p_src.push_back(pid);
+        }
+        e_src.push_back(std::make_pair(ipair(vid0,new_vid),eid));
+        e_src.push_back(std::make_pair(ipair(vid1,new_vid),eid));
+        res.at(i) = new_vid;
+    }
+
+    this->polys_rebuild(polys, p_src, {}, e_src, {}, id_maps);
+
+    for(int & vid : res) if(vid>=0) vid = id_maps.v_map.at(vid);
+    id_maps.v_map.resize(nv);
+    return res;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<int> Trimesh<M,V,E,P>::edges_collapse(const std::vector<uint> & eids,
+                                                  MeshIdMaps              & id_maps,
+                                                  const double              lambda,
+                                                  const bool                topologic_check,
+                                                  const bool                geometric_check)
+{
+    std::vector<std::vector<uint>> polys = this->polys;
+    std::vector<int> p_src(polys.size());
+    std::iota(p_src.begin(), p_src.end(), 0);
+    std::vector<uint> v_merge(this->num_verts());
+    std::iota(v_merge.begin(), v_merge.end(), 0);
+    std::vector<uint>  v_moved;
+    std::vector<vec3d> v_pos;
+    std::vector<bool>  p_locked(this->num_polys(), false);
+    std::vector<int>   res(eids.size(), -1);
+
+    for(uint i=0; i<eids.size(); ++i)
+    {
+        // the whole umbrella of the edge changes, hence it must be untouched by previous
+        // collapses (this also guarantees that the checks below are still valid)
+        uint eid  = eids.at(i);
+        uint vid0 = this->edge_vert_id(eid,0);
+        uint vid1 = this->edge_vert_id(eid,1);
+        bool locked = false;
+        for(uint pid : this->adj_v2p(vid0)) if(p_locked.at(pid)) locked = true;
+        for(uint pid : this->adj_v2p(vid1)) if(p_locked.at(pid)) locked = true;
+        if(locked) continue;
+
+        if(topologic_check && !edge_is_topologically_collapsible(eid))         continue;
+        if(geometric_check && !edge_is_geometrically_collapsible(eid, lambda)) continue;
+
+        for(uint pid : this->adj_v2p(vid0)) p_locked.at(pid) = true;
+        for(uint pid : this->adj_v2p(vid1)) p_locked.at(pid) = true;
+
+        uint vert_to_keep   = std::min(vid0,vid1); // remove vert with highest ID
+        uint vert_to_remove = std::max(vid0,vid1);
+        v_moved.push_back(vert_to_keep);
+        v_pos.push_back(this->edge_sample_at(eid, lambda));
+        v_merge.at(vert_to_remove) = vert_to_keep;
+
+        for(uint pid : this->adj_v2p(vert_to_remove))
+        {
+            if(this->poly_contains_edge(pid, eid)) polys.at(pid).clear();
+            else for(uint & vid : polys.at(pid)) if(vid==vert_to_remove) vid = vert_to_keep;
+        }
+        res.at(i) = vert_to_keep;
+    }
+
+    for(uint i=0; i<v_moved.size(); ++i) this->vert(v_moved.at(i)) = v_pos.at(i);
+
+    this->polys_rebuild(polys, p_src, v_merge, {}, v_moved, id_maps);
+
+    for(int & vid : res) if(vid>=0) vid = id_maps.v_map.at(vid);
+    return res;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<int> Trimesh<M,V,E,P>::edges_flip(const std::vector<uint> & eids, MeshIdMaps & id_maps, const bool geometric_check)
+{
+    std::vector<std::vector<uint>> polys = this->polys;
+    std::vector<int> p_src(polys.size());
+    std::iota(p_src.begin(), p_src.end(), 0);
+    std::vector<std::pair<ipair,uint>> e_src;
+    std::set<ipair>   new_edges;
+    std::vector<bool> p_locked(this->num_polys(), false);
+    std::vector<int>  res(eids.size(), -1);
+
+    for(uint i=0; i<eids.size(); ++i)
+    {
+        uint eid = eids.at(i);
+        if(this->adj_e2p(eid).size()!=2) continue;
+        uint pid0 = this->adj_e2p(eid).front();
+        uint pid1 = this->adj_e2p(eid).back();
+        if(p_locked.at(pid0) || p_locked.at(pid1)) continue;
+        if(geometric_check && !edge_is_flippable(eid)) continue;
+
+        uint vid0 = this->edge_vert_id(eid,0);
+        uint vid1 = this->edge_vert_id(eid,1);
+        uint opp0 = this->vert_opposite_to(pid0,vid0,vid1);
+        uint opp1 = this->vert_opposite_to(pid1,vid0,vid1);
+
+        // the new edge must not exist already (neither in the mesh nor in the batch)
+        if(this->edge_id(opp0,opp1)>=0) continue;
+        if(!new_edges.insert(unique_pair(opp0,opp1)).second) continue;
+
+        p_locked.at(pid0) = true;
+        p_locked.at(pid1) = true;
+        if(!this->poly_verts_are_CCW(pid0, vid1, vid0)) std::swap(vid0,vid1);
+        polys.at(pid0) = { opp0, vid0, opp1 };
+        polys.at(pid1) = { opp1, vid1, opp0 };
+        res.at(i) = e_src.size(); // temporary: position of the new edge in e_src
+        e_src.push_back(std::make_pair(ipair(opp0,opp1),eid));
+    }
+
+    this->polys_rebuild(polys, p_src, {}, e_src, {}, id_maps);
+
+    for(uint i=0; i<eids.size(); ++i)
+    {
+        if(res.at(i)<0) continue;
+        const ipair & e = e_src.at(res.at(i)).first;
+        res.at(i) = this->edge_id(id_maps.v_map.at(e.first), id_maps.v_map.at(e.second));
+        assert(res.at(i)>=0);
+    }
+    return res;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void Trimesh<M,V,E,P>::poly_bary_coords(const uint pid, const vec3d & p, double bc[]) const
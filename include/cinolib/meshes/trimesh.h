@@ -112,6 +112,19 @@ class Trimesh : public AbstractPolygonMesh<M,V,E,P>
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+        // batched versions of edge_split, edge_collapse and edge_flip. All operations refer to
+        // the mesh as it is before the call, and are validated against it. An operation that
+        // touches a triangle already modified by a previous operation in the list is discarded
+        // (call again to process it). Connectivity is rebuilt only once, and ids are compacted
+        // (see AbstractPolygonMesh::polys_rebuild). For each operation, the returned vector
+        // contains the (new) id the single element call would have returned, or -1 if the
+        // operation was not applied
+        std::vector<int>  edges_split                      (const std::vector<uint> & eids, MeshIdMaps & id_maps, const double lambda = 0.5);
+        std::vector<int>  edges_collapse                   (const std::vector<uint> & eids, MeshIdMaps & id_maps, const double lambda = 0.5, const bool topologic_check = true, const bool geometric_check = true);
+        std::vector<int>  edges_flip                       (const std::vector<uint> & eids, MeshIdMaps & id_maps, const bool geometric_check = true);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
         int                 poly_id            (const uint eid0, const uint eid1) const;
         double              poly_area          (const uint pid) const;
         bool                poly_is_cap        (const uint pid, const double angle_thresh_deg = 177.0) const;
@@ -38,5 +38,6 @@
 
 #include <cinolib/quality_tet.h>
 #include <cinolib/quality_hex.h>
+#include <cinolib/quality_batch.h>
 
 #endif // CINO_QUALITY
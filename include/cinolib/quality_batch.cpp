@@ -0,0 +1,757 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/quality_batch.h>
+#include <cinolib/min_max_inf.h>
+#include <cmath>
+#include <limits>
+
+/*
+ * All metrics implemented here all based on:
+ *
+ * The Verdict Geometric Quality Library
+ * SANDIA Report SAND2007-1751
+ *
+ * Intermediate quantities (edges, principal axes, sub tet determinants...)
+ * are computed for the whole batch at once and stored in SoA layout, so that
+ * each stage is a simple loop over the elements of the batch.
+*/
+
+namespace cinolib
+{
+
+// NOTE: only the first b.size entries of a batch vector are ever written and read.
+// Batch vectors are nevertheless zero initialized, so that compilers cannot tell
+// apart the trailing entries of partial batches from uninitialized memory
+typedef struct
+{
+    double x[QUALITY_BATCH_SIZE];
+    double y[QUALITY_BATCH_SIZE];
+    double z[QUALITY_BATCH_SIZE];
+}
+BatchVec3;
+
+// edges, principal axes, cross derivatives and diagonals of a hexahedron
+// (see quality_hex.cpp). Each vector is expressed as a sum of differences
+// between corners, in the same order used by the scalar code
+static const uint HEX_BATCH_EDGES[12][2] =
+{
+    {1,0}, {2,1}, {3,2}, {3,0}, {4,0}, {5,1}, {6,2}, {7,3}, {5,4}, {6,5}, {7,6}, {7,4}
+};
+static const uint HEX_BATCH_AXES[3][8] =
+{
+    {1,0, 2,3, 5,4, 6,7},
+    {3,0, 2,1, 7,4, 6,5},
+    {4,0, 5,1, 6,2, 7,3}
+};
+static const uint HEX_BATCH_CROSS_DERIVATIVES[3][8] =
+{
+    {2,3, 0,1, 6,7, 4,5}, // (p2-p3) - (p1-p0) + (p6-p7) - (p5-p4)
+    {5,1, 0,4, 6,2, 3,7}, // (p5-p1) - (p4-p0) + (p6-p2) - (p7-p3)
+    {7,4, 0,3, 6,5, 1,2}  // (p7-p4) - (p3-p0) + (p6-p5) - (p2-p1)
+};
+static const uint HEX_BATCH_DIAGONALS[4][2] =
+{
+    {6,0}, {7,1}, {4,2}, {5,3}
+};
+
+// the 9 sub tets used by hex metrics, as triplets of edges (or principal axes for
+// the last one) and the sign of their determinant (see hex_subtets in quality_hex.cpp)
+static const uint HEX_BATCH_SUBTETS[9][3] =
+{
+    {0,3,4}, {1,0,5}, {2,1,6}, {3,2,7}, {11,8,4}, {8,9,5}, {9,10,6}, {10,11,7}, {0,1,2}
+};
+static const double HEX_BATCH_SUBTETS_SIGN[9] = { 1, -1, -1, 1, -1, 1, 1, -1, 1 };
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void batch_set_vert(HexBatch & b, const uint k, const uint i, const vec3d & p)
+{
+    assert(k<QUALITY_BATCH_SIZE && i<8);
+    b.x[i][k] = p.x();
+    b.y[i][k] = p.y();
+    b.z[i][k] = p.z();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void batch_set_vert(TetBatch & b, const uint k, const uint i, const vec3d & p)
+{
+    assert(k<QUALITY_BATCH_SIZE && i<4);
+    b.x[i][k] = p.x();
+    b.y[i][k] = p.y();
+    b.z[i][k] = p.z();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// v = p[i] - p[j]
+template<class Batch>
+CINO_INLINE
+void batch_diff(const Batch & b, const uint i, const uint j, BatchVec3 & v)
+{
+    for(uint k=0; k<b.size; ++k)
+    {
+        v.x[k] = b.x[i][k] - b.x[j][k];
+        v.y[k] = b.y[i][k] - b.y[j][k];
+        v.z[k] = b.z[i][k] - b.z[j][k];
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// v = (p[i0]-p[i1]) + (p[i2]-p[i3]) + (p[i4]-p[i5]) + (p[i6]-p[i7])
+CINO_INLINE
+void batch_sum_of_diffs(const HexBatch & b, const uint i[8], BatchVec3 & v)
+{
+    for(uint k=0; k<b.size; ++k)
+    {
+        v.x[k] = (b.x[i[0]][k] - b.x[i[1]][k]) + (b.x[i[2]][k] - b.x[i[3]][k]) + (b.x[i[4]][k] - b.x[i[5]][k]) + (b.x[i[6]][k] - b.x[i[7]][k]);
+        v.y[k] = (b.y[i[0]][k] - b.y[i[1]][k]) + (b.y[i[2]][k] - b.y[i[3]][k]) + (b.y[i[4]][k] - b.y[i[5]][k]) + (b.y[i[6]][k] - b.y[i[7]][k]);
+        v.z[k] = (b.z[i[0]][k] - b.z[i[1]][k]) + (b.z[i[2]][k] - b.z[i[3]][k]) + (b.z[i[4]][k] - b.z[i[5]][k]) + (b.z[i[6]][k] - b.z[i[7]][k]);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void batch_norms(const BatchVec3 & v, const uint n, double * norms)
+{
+    for(uint k=0; k<n; ++k) norms[k] = sqrt(v.x[k]*v.x[k] + v.y[k]*v.y[k] + v.z[k]*v.z[k]);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// normalize all non null vectors (null vectors are left untouched)
+CINO_INLINE
+void batch_normalize(BatchVec3 & v, const uint n)
+{
+    for(uint k=0; k<n; ++k)
+    {
+        double len = sqrt(v.x[k]*v.x[k] + v.y[k]*v.y[k] + v.z[k]*v.z[k]);
+        double div = (len==0) ? 1.0 : len;
+        v.x[k] /= div;
+        v.y[k] /= div;
+        v.z[k] /= div;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// det = sign * a.dot(b.cross(c))
+CINO_INLINE
+void batch_determinant(const BatchVec3 & a, const BatchVec3 & b, const BatchVec3 & c, const double sign, const uint n, double * det)
+{
+    for(uint k=0; k<n; ++k)
+    {
+        double cx = b.y[k] * c.z[k] - b.z[k] * c.y[k];
+        double cy = b.z[k] * c.x[k] - b.x[k] * c.z[k];
+        double cz = b.x[k] * c.y[k] - b.y[k] * c.x[k];
+        det[k] = sign * (a.x[k] * cx + a.y[k] * cy + a.z[k] * cz);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void batch_dot(const BatchVec3 & a, const BatchVec3 & b, const uint n, double * dot)
+{
+    for(uint k=0; k<n; ++k) dot[k] = a.x[k] * b.x[k] + a.y[k] * b.y[k] + a.z[k] * b.z[k];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// squared norm of a.cross(b)
+CINO_INLINE
+void batch_cross_length_squared(const BatchVec3 & a, const BatchVec3 & b, const uint n, double * res)
+{
+    for(uint k=0; k<n; ++k)
+    {
+        double cx = a.y[k] * b.z[k] - a.z[k] * b.y[k];
+        double cy = a.z[k] * b.x[k] - a.x[k] * b.z[k];
+        double cz = a.x[k] * b.y[k] - a.y[k] * b.x[k];
+        res[k] = cx * cx + cy * cy + cz * cz;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_batch_edges(const HexBatch & b, BatchVec3 L[12], const bool normalized)
+{
+    for(uint i=0; i<12; ++i)
+    {
+        batch_diff(b, HEX_BATCH_EDGES[i][0], HEX_BATCH_EDGES[i][1], L[i]);
+        if(normalized) batch_normalize(L[i], b.size);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_batch_principal_axes(const HexBatch & b, BatchVec3 X[3], const bool normalized)
+{
+    for(uint i=0; i<3; ++i)
+    {
+        batch_sum_of_diffs(b, HEX_BATCH_AXES[i], X[i]);
+        if(normalized) batch_normalize(X[i], b.size);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// determinants of the 9 sub tets
+CINO_INLINE
+void hex_batch_subtets_det(const HexBatch & b, const BatchVec3 L[12], const BatchVec3 X[3], double det[9][QUALITY_BATCH_SIZE])
+{
+    for(uint i=0; i<9; ++i)
+    {
+        const BatchVec3 * v = (i<8) ? L : X;
+        batch_determinant(v[HEX_BATCH_SUBTETS[i][0]],
+                          v[HEX_BATCH_SUBTETS[i][1]],
+                          v[HEX_BATCH_SUBTETS[i][2]],
+                          HEX_BATCH_SUBTETS_SIGN[i], b.size, det[i]);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// squared norms of the columns of the 9 sub tets (summed up)
+CINO_INLINE
+void hex_batch_subtets_sqrd_norms(const HexBatch & b, const BatchVec3 L[12], const BatchVec3 X[3], double den[9][QUALITY_BATCH_SIZE])
+{
+    double d0[QUALITY_BATCH_SIZE], d1[QUALITY_BATCH_SIZE], d2[QUALITY_BATCH_SIZE];
+    for(uint i=0; i<9; ++i)
+    {
+        const BatchVec3 * v = (i<8) ? L : X;
+        batch_dot(v[HEX_BATCH_SUBTETS[i][0]], v[HEX_BATCH_SUBTETS[i][0]], b.size, d0);
+        batch_dot(v[HEX_BATCH_SUBTETS[i][1]], v[HEX_BATCH_SUBTETS[i][1]], b.size, d1);
+        batch_dot(v[HEX_BATCH_SUBTETS[i][2]], v[HEX_BATCH_SUBTETS[i][2]], b.size, d2);
+        for(uint k=0; k<b.size; ++k) den[i][k] = d0[k] + d1[k] + d2[k];
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// aspect Frobenius of the first 8 sub tets (see frobenius in quality_hex.cpp)
+CINO_INLINE
+void hex_batch_subtets_frobenius(const HexBatch & b, double frob[8][QUALITY_BATCH_SIZE])
+{
+    BatchVec3 L[12] = {}, X[3] = {};
+    hex_batch_edges(b, L, false);
+    hex_batch_principal_axes(b, X, false);
+
+    double det[9][QUALITY_BATCH_SIZE];
+    double term1[9][QUALITY_BATCH_SIZE];
+    hex_batch_subtets_det(b, L, X, det);
+    hex_batch_subtets_sqrd_norms(b, L, X, term1);
+
+    double c01[QUALITY_BATCH_SIZE], c12[QUALITY_BATCH_SIZE], c20[QUALITY_BATCH_SIZE];
+    for(uint i=0; i<8; ++i)
+    {
+        batch_cross_length_squared(L[HEX_BATCH_SUBTETS[i][0]], L[HEX_BATCH_SUBTETS[i][1]], b.size, c01);
+        batch_cross_length_squared(L[HEX_BATCH_SUBTETS[i][1]], L[HEX_BATCH_SUBTETS[i][2]], b.size, c12);
+        batch_cross_length_squared(L[HEX_BATCH_SUBTETS[i][2]], L[HEX_BATCH_SUBTETS[i][0]], b.size, c20);
+        for(uint k=0; k<b.size; ++k)
+        {
+            double term2 = c01[k] + c12[k] + c20[k];
+            double f     = sqrt(term1[i][k]*term2)/det[i][k];
+            frob[i][k]   = (det[i][k] <= min_double) ? max_double : f/3.0;
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_quality(const HexBatch & b, const QualityMetric metric, double * q, const double avg_V)
+{
+    switch(metric)
+    {
+        case SCALED_JACOBIAN       : hex_scaled_jacobian      (b, q);        break;
+        case VOLUME                : hex_volume               (b, q);        break;
+        case UNSIGNED_VOLUME       : hex_unsigned_volume      (b, q);        break;
+        case DIAGONAL              : hex_diagonal             (b, q);        break;
+        case EDGE_RATIO            : hex_edge_ratio           (b, q);        break;
+        case JACOBIAN              : hex_jacobian             (b, q);        break;
+        case MAX_EDGE_RATIO        : hex_max_edge_ratio       (b, q);        break;
+        case MAX_ASPECT_FROBENIUS  : hex_max_aspect_Frobenius (b, q);        break;
+        case MEAN_ASPECT_FROBENIUS : hex_mean_aspect_Frobenius(b, q);        break;
+        case ODDY                  : hex_oddy                 (b, q);        break;
+        case RELATIVE_SIZE_SQUARED : hex_relative_size_squared(b, avg_V, q); break;
+        case SHAPE                 : hex_shape                (b, q);        break;
+        case SHAPE_AND_SIZE        : hex_shape_and_size       (b, avg_V, q); break;
+        case SHEAR                 : hex_shear                (b, q);        break;
+        case SHEAR_AND_SIZE        : hex_shear_and_size       (b, avg_V, q); break;
+        case SKEW                  : hex_skew                 (b, q);        break;
+        case STRETCH               : hex_stretch              (b, q);        break;
+        case TAPER                 : hex_taper                (b, q);        break;
+        default : // not a hex metric
+            for(uint k=0; k<b.size; ++k) q[k] = std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool quality_metric_supports_tets(const QualityMetric metric)
+{
+    return metric==SCALED_JACOBIAN || metric==VOLUME || metric==UNSIGNED_VOLUME;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void tet_quality(const TetBatch & b, const QualityMetric metric, double * q)
+{
+    switch(metric)
+    {
+        case SCALED_JACOBIAN : tet_scaled_jacobian(b, q); break;
+        case VOLUME          : tet_volume         (b, q); break;
+        case UNSIGNED_VOLUME : tet_unsigned_volume(b, q); break;
+        default : // hex only metric
+            for(uint k=0; k<b.size; ++k) q[k] = std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_diagonal(const HexBatch & b, double * q)
+{
+    BatchVec3 D = {};
+    double D_min[QUALITY_BATCH_SIZE], D_max[QUALITY_BATCH_SIZE], D_norms[QUALITY_BATCH_SIZE];
+    for(uint i=0; i<4; ++i)
+    {
+        batch_diff(b, HEX_BATCH_DIAGONALS[i][0], HEX_BATCH_DIAGONALS[i][1], D);
+        batch_norms(D, b.size, D_norms);
+        for(uint k=0; k<b.size; ++k)
+        {
+            D_min[k] = (i==0) ? D_norms[k] : std::min(D_min[k], D_norms[k]);
+            D_max[k] = (i==0) ? D_norms[k] : std::max(D_max[k], D_norms[k]);
+        }
+    }
+    for(uint k=0; k<b.size; ++k) q[k] = D_min[k] / D_max[k];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_edge_ratio(const HexBatch & b, double * q)
+{
+    BatchVec3 L = {};
+    double L_min[QUALITY_BATCH_SIZE], L_max[QUALITY_BATCH_SIZE], L_norms[QUALITY_BATCH_SIZE];
+    for(uint i=0; i<12; ++i)
+    {
+        batch_diff(b, HEX_BATCH_EDGES[i][0], HEX_BATCH_EDGES[i][1], L);
+        batch_norms(L, b.size, L_norms);
+        for(uint k=0; k<b.size; ++k)
+        {
+            L_min[k] = (i==0) ? L_norms[k] : std::min(L_min[k], L_norms[k]);
+            L_max[k] = (i==0) ? L_norms[k] : std::max(L_max[k], L_norms[k]);
+        }
+    }
+    for(uint k=0; k<b.size; ++k) q[k] = L_max[k] / L_min[k];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_jacobian(const HexBatch & b, double * q)
+{
+    BatchVec3 L[12] = {}, X[3] = {};
+    hex_batch_edges(b, L, false);
+    hex_batch_principal_axes(b, X, false);
+
+    double det[9][QUALITY_BATCH_SIZE];
+    hex_batch_subtets_det(b, L, X, det);
+    for(uint k=0; k<b.size; ++k)
+    {
+        double sj = det[0][k];
+        for(uint i=1; i<8; ++i) sj = std::min(sj, det[i][k]);
+        q[k] = std::min(sj, det[8][k]/64.0);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_max_edge_ratio(const HexBatch & b, double * q)
+{
+    BatchVec3 X[3] = {};
+    double    X_norms[3][QUALITY_BATCH_SIZE];
+    hex_batch_principal_axes(b, X, false);
+    for(uint i=0; i<3; ++i) batch_norms(X[i], b.size, X_norms[i]);
+
+    for(uint k=0; k<b.size; ++k)
+    {
+        double n0 = X_norms[0][k];
+        double n1 = X_norms[1][k];
+        double n2 = X_norms[2][k];
+        double r  = std::max(std::max(std::max(n0/n1, n1/n0),
+                                      std::max(n0/n2, n2/n0)),
+                                      std::max(n1/n2, n2/n1));
+        q[k] = (n0 < min_double || n1 < min_double || n2 < min_double) ? max_double : r;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_max_aspect_Frobenius(const HexBatch & b, double * q)
+{
+    double frob[8][QUALITY_BATCH_SIZE];
+    hex_batch_subtets_frobenius(b, frob);
+    for(uint k=0; k<b.size; ++k)
+    {
+        q[k] = frob[0][k];
+        for(uint i=1; i<8; ++i) q[k] = std::max(q[k], frob[i][k]);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_mean_aspect_Frobenius(const HexBatch & b, double * q)
+{
+    double frob[8][QUALITY_BATCH_SIZE];
+    hex_batch_subtets_frobenius(b, frob);
+    for(uint k=0; k<b.size; ++k)
+    {
+        double sum = 0;
+        for(uint i=0; i<8; ++i) sum += frob[i][k];
+        q[k] = sum/8.0;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_oddy(const HexBatch & b, double * q)
+{
+    static double four_over_three = 4.0/3.0;
+
+    BatchVec3 L[12] = {}, X[3] = {};
+    hex_batch_edges(b, L, false);
+    hex_batch_principal_axes(b, X, false);
+
+    double det[9][QUALITY_BATCH_SIZE];
+    hex_batch_subtets_det(b, L, X, det);
+
+    double a11[QUALITY_BATCH_SIZE], a12[QUALITY_BATCH_SIZE], a13[QUALITY_BATCH_SIZE];
+    double a22[QUALITY_BATCH_SIZE], a23[QUALITY_BATCH_SIZE], a33[QUALITY_BATCH_SIZE];
+    float  oddy_max[QUALITY_BATCH_SIZE];
+    bool   degenerate[QUALITY_BATCH_SIZE];
+    for(uint i=0; i<9; ++i)
+    {
+        const BatchVec3 * v  = (i<8) ? L : X;
+        const BatchVec3 & c0 = v[HEX_BATCH_SUBTETS[i][0]];
+        const BatchVec3 & c1 = v[HEX_BATCH_SUBTETS[i][1]];
+        const BatchVec3 & c2 = v[HEX_BATCH_SUBTETS[i][2]];
+        batch_dot(c0, c0, b.size, a11);
+        batch_dot(c0, c1, b.size, a12);
+        batch_dot(c0, c2, b.size, a13);
+        batch_dot(c1, c1, b.size, a22);
+        batch_dot(c1, c2, b.size, a23);
+        batch_dot(c2, c2, b.size, a33);
+        for(uint k=0; k<b.size; ++k)
+        {
+            // the sign of the columns does not matter here (all products appear squared)
+            double AtA_sqrd = a11[k]*a11[k] + 2.0*a12[k]*a12[k] + 2.0*a13[k]*a13[k] + a22[k]*a22[k] + 2.0*a23[k]*a23[k] +a33[k]*a33[k];
+            double A_sqrd   = a11[k] + a22[k] + a33[k];
+            bool   deg      = !(det[i][k] > min_double);
+            float  oddy     = (deg) ? 0.f : (AtA_sqrd - A_sqrd*A_sqrd/3.0) / pow(det[i][k],four_over_three);
+            oddy_max[k]     = (i==0) ? oddy : std::max(oddy_max[k], oddy);
+            degenerate[k]   = (i==0) ? deg  : (degenerate[k] || deg);
+        }
+    }
+    for(uint k=0; k<b.size; ++k) q[k] = (degenerate[k]) ? max_double : oddy_max[k];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_relative_size_squared(const HexBatch & b, const double & avgV, double * q)
+{
+    BatchVec3 X[3] = {};
+    hex_batch_principal_axes(b, X, false);
+
+    double D[QUALITY_BATCH_SIZE];
+    batch_determinant(X[0], X[1], X[2], 1.0, b.size, D);
+    for(uint k=0; k<b.size; ++k)
+    {
+        double d = D[k] / (64.0*avgV);
+        double m = std::min(d, 1.f/d);
+        q[k] = (avgV<=min_double || d<=min_double) ? 0 : m*m;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_scaled_jacobian(const HexBatch & b, double * q)
+{
+    BatchVec3 L[12] = {}, X[3] = {};
+    hex_batch_edges(b, L, true);
+    hex_batch_principal_axes(b, X, true);
+
+    double det[9][QUALITY_BATCH_SIZE];
+    hex_batch_subtets_det(b, L, X, det);
+    for(uint k=0; k<b.size; ++k)
+    {
+        double msj = det[0][k];
+        for(uint i=1; i<9; ++i) msj = std::min(msj, det[i][k]);
+        q[k] = (msj > 1.0001) ? -1.0 : msj;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_shape(const HexBatch & b, double * q)
+{
+    static double two_over_three = 2.0/3.0;
+
+    BatchVec3 L[12] = {}, X[3] = {};
+    hex_batch_edges(b, L, false);
+    hex_batch_principal_axes(b, X, false);
+
+    double det[9][QUALITY_BATCH_SIZE];
+    double den[9][QUALITY_BATCH_SIZE];
+    hex_batch_subtets_det(b, L, X, det);
+    hex_batch_subtets_sqrd_norms(b, L, X, den);
+    for(uint k=0; k<b.size; ++k)
+    {
+        double shape = max_double;
+        bool   deg   = false;
+        for(uint i=0; i<9; ++i)
+        {
+            deg   = deg || det[i][k]<=min_double || den[i][k]<=min_double;
+            shape = std::min(shape, 3.0 * pow(det[i][k], two_over_three)/den[i][k]);
+        }
+        q[k] = (deg) ? 0 : shape;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_shape_and_size(const HexBatch & b, const double & avg_V, double * q)
+{
+    double rss[QUALITY_BATCH_SIZE];
+    hex_shape(b, q);
+    hex_relative_size_squared(b, avg_V, rss);
+    for(uint k=0; k<b.size; ++k) q[k] *= rss[k];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_shear(const HexBatch & b, double * q)
+{
+    BatchVec3 L[12] = {}, X[3] = {};
+    hex_batch_edges(b, L, true);
+    hex_batch_principal_axes(b, X, true);
+
+    double det[9][QUALITY_BATCH_SIZE];
+    hex_batch_subtets_det(b, L, X, det);
+    for(uint k=0; k<b.size; ++k)
+    {
+        double shear = det[0][k];
+        for(uint i=1; i<9; ++i) shear = std::min(shear, det[i][k]);
+        q[k] = (shear<=min_double) ? 0 : shear;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_shear_and_size(const HexBatch & b, const double & avg_V, double * q)
+{
+    double rss[QUALITY_BATCH_SIZE];
+    hex_shear(b, q);
+    hex_relative_size_squared(b, avg_V, rss);
+    for(uint k=0; k<b.size; ++k) q[k] *= rss[k];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_skew(const HexBatch & b, double * q)
+{
+    BatchVec3 X[3] = {};
+    hex_batch_principal_axes(b, X, true);
+
+    double X_norms[3][QUALITY_BATCH_SIZE];
+    double skew[3][QUALITY_BATCH_SIZE];
+    for(uint i=0; i<3; ++i) batch_norms(X[i], b.size, X_norms[i]);
+    batch_dot(X[0], X[1], b.size, skew[0]);
+    batch_dot(X[0], X[2], b.size, skew[1]);
+    batch_dot(X[1], X[2], b.size, skew[2]);
+    for(uint k=0; k<b.size; ++k)
+    {
+        double s = std::max(std::max(std::fabs(skew[0][k]), std::fabs(skew[1][k])), std::fabs(skew[2][k]));
+        q[k] = (X_norms[0][k] <= min_double || X_norms[1][k] <= min_double || X_norms[2][k] <= min_double) ? 0 : s;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_stretch(const HexBatch & b, double * q)
+{
+    static double sqrt3 = 1.732050807568877f;
+
+    BatchVec3 v = {};
+    double norms[QUALITY_BATCH_SIZE], L_min[QUALITY_BATCH_SIZE], D_max[QUALITY_BATCH_SIZE];
+    for(uint i=0; i<12; ++i)
+    {
+        batch_diff(b, HEX_BATCH_EDGES[i][0], HEX_BATCH_EDGES[i][1], v);
+        batch_norms(v, b.size, norms);
+        for(uint k=0; k<b.size; ++k) L_min[k] = (i==0) ? norms[k] : std::min(L_min[k], norms[k]);
+    }
+    for(uint i=0; i<4; ++i)
+    {
+        batch_diff(b, HEX_BATCH_DIAGONALS[i][0], HEX_BATCH_DIAGONALS[i][1], v);
+        batch_norms(v, b.size, norms);
+        for(uint k=0; k<b.size; ++k) D_max[k] = (i==0) ? norms[k] : std::max(D_max[k], norms[k]);
+    }
+    for(uint k=0; k<b.size; ++k) q[k] = sqrt3 * L_min[k] / D_max[k];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_taper(const HexBatch & b, double * q)
+{
+    BatchVec3 X[3] = {}, XX[3] = {};
+    double    X_norms[3][QUALITY_BATCH_SIZE];
+    double    XX_norms[3][QUALITY_BATCH_SIZE];
+    hex_batch_principal_axes(b, X, false);
+    for(uint i=0; i<3; ++i)
+    {
+        batch_sum_of_diffs(b, HEX_BATCH_CROSS_DERIVATIVES[i], XX[i]);
+        batch_norms(X[i],  b.size, X_norms[i]);
+        batch_norms(XX[i], b.size, XX_norms[i]);
+    }
+    for(uint k=0; k<b.size; ++k)
+    {
+        double t = std::max(std::max(XX_norms[0][k] / std::min(X_norms[0][k], X_norms[1][k]),
+                                     XX_norms[1][k] / std::min(X_norms[0][k], X_norms[2][k])),
+                                     XX_norms[2][k] / std::min(X_norms[1][k], X_norms[2][k]));
+        q[k] = (X_norms[0][k] <= min_double || X_norms[1][k] <= min_double || X_norms[2][k] <= min_double) ? max_double : t;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_volume(const HexBatch & b, double * q)
+{
+    BatchVec3 X[3] = {};
+    hex_batch_principal_axes(b, X, false);
+    batch_determinant(X[0], X[1], X[2], 1.0, b.size, q);
+    for(uint k=0; k<b.size; ++k) q[k] /= 64.0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_unsigned_volume(const HexBatch & b, double * q)
+{
+    hex_volume(b, q);
+    for(uint k=0; k<b.size; ++k) q[k] = fabs(q[k]);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void tet_scaled_jacobian(const TetBatch & b, double * q)
+{
+    static double sqrt_2 = 1.414213562373095;
+
+    BatchVec3 L0 = {}, L2 = {}, L3 = {};
+    batch_diff(b, 1, 0, L0);
+    batch_diff(b, 0, 2, L2);
+    batch_diff(b, 3, 0, L3);
+
+    double J[QUALITY_BATCH_SIZE];
+    batch_determinant(L3, L2, L0, 1.0, b.size, J); // (L2 x L0) . L3
+
+    BatchVec3 v = {};
+    double L_length[6][QUALITY_BATCH_SIZE];
+    batch_norms(L0, b.size, L_length[0]);
+    batch_diff (b, 2, 1, v); batch_norms(v, b.size, L_length[1]);
+    batch_norms(L2, b.size, L_length[2]);
+    batch_norms(L3, b.size, L_length[3]);
+    batch_diff (b, 3, 1, v); batch_norms(v, b.size, L_length[4]);
+    batch_diff (b, 3, 2, v); batch_norms(v, b.size, L_length[5]);
+
+    for(uint k=0; k<b.size; ++k)
+    {
+        double max = std::max(std::max(std::max(std::max(L_length[0][k] * L_length[2][k] * L_length[3][k],
+                                                         L_length[0][k] * L_length[1][k] * L_length[4][k]),
+                                                         L_length[1][k] * L_length[2][k] * L_length[5][k]),
+                                                         L_length[3][k] * L_length[4][k] * L_length[5][k]),
+                                                         J[k]);
+        q[k] = (max < -inf_double) ? -1.0 : (J[k] * sqrt_2 / max);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void tet_volume(const TetBatch & b, double * q)
+{
+    BatchVec3 L0 = {}, L2 = {}, L3 = {};
+    batch_diff(b, 1, 0, L0);
+    batch_diff(b, 0, 2, L2);
+    batch_diff(b, 3, 0, L3);
+    batch_determinant(L3, L2, L0, 1.0, b.size, q); // (L2 x L0) . L3
+    for(uint k=0; k<b.size; ++k) q[k] /= 6.0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void tet_unsigned_volume(const TetBatch & b, double * q)
+{
+    tet_volume(b, q);
+    for(uint k=0; k<b.size; ++k) q[k] = fabs(q[k]);
+}
+
+}
@@ -0,0 +1,186 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_QUALITY_BATCH
+#define CINO_QUALITY_BATCH
+
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec3.h>
+#include <string>
+
+/*
+ * Batched versions of the per element quality metrics defined in quality_hex.h
+ * and quality_tet.h. Element coordinates are stored in structure of arrays (SoA)
+ * layout, and each metric is evaluated one stage at a time on all the elements
+ * of the batch, with plain loops that the compiler can map to SIMD instructions.
+ * Metrics perform the very same floating point operations of their scalar
+ * counterparts, in the same order. The two agree up to rounding (relative
+ * difference below 1e-12), as the compiler may contract multiply-adds into
+ * FMA instructions differently in the two versions.
+ *
+ * See quality_report.h for mesh level evaluation of these metrics.
+*/
+
+namespace cinolib
+{
+
+typedef enum
+{
+    SCALED_JACOBIAN       , // hex, tet
+    VOLUME                , // hex, tet
+    UNSIGNED_VOLUME       , // hex, tet
+    DIAGONAL              , // hex
+    EDGE_RATIO            , // hex
+    JACOBIAN              , // hex
+    MAX_EDGE_RATIO        , // hex
+    MAX_ASPECT_FROBENIUS  , // hex
+    MEAN_ASPECT_FROBENIUS , // hex
+    ODDY                  , // hex
+    RELATIVE_SIZE_SQUARED , // hex (requires the average volume)
+    SHAPE                 , // hex
+    SHAPE_AND_SIZE        , // hex (requires the average volume)
+    SHEAR                 , // hex
+    SHEAR_AND_SIZE        , // hex (requires the average volume)
+    SKEW                  , // hex
+    STRETCH               , // hex
+    TAPER                 , // hex
+}
+QualityMetric;
+
+static const std::string quality_metric_txt[18] =
+{
+    "SCALED_JACOBIAN"      ,
+    "VOLUME"               ,
+    "UNSIGNED_VOLUME"      ,
+    "DIAGONAL"             ,
+    "EDGE_RATIO"           ,
+    "JACOBIAN"             ,
+    "MAX_EDGE_RATIO"       ,
+    "MAX_ASPECT_FROBENIUS" ,
+    "MEAN_ASPECT_FROBENIUS",
+    "ODDY"                 ,
+    "RELATIVE_SIZE_SQUARED",
+    "SHAPE"                ,
+    "SHAPE_AND_SIZE"       ,
+    "SHEAR"                ,
+    "SHEAR_AND_SIZE"       ,
+    "SKEW"                 ,
+    "STRETCH"              ,
+    "TAPER"                ,
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+static const uint QUALITY_BATCH_SIZE = 64;
+
+typedef struct
+{
+    uint   size; // number of elements in the batch (at most QUALITY_BATCH_SIZE)
+    double x[8][QUALITY_BATCH_SIZE];
+    double y[8][QUALITY_BATCH_SIZE];
+    double z[8][QUALITY_BATCH_SIZE];
+}
+HexBatch;
+
+typedef struct
+{
+    uint   size; // number of elements in the batch (at most QUALITY_BATCH_SIZE)
+    double x[4][QUALITY_BATCH_SIZE];
+    double y[4][QUALITY_BATCH_SIZE];
+    double z[4][QUALITY_BATCH_SIZE];
+}
+TetBatch;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// store the i-th corner of the k-th element of the batch
+//
+CINO_INLINE
+void batch_set_vert(HexBatch & b, const uint k, const uint i, const vec3d & p);
+
+CINO_INLINE
+void batch_set_vert(TetBatch & b, const uint k, const uint i, const vec3d & p);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// evaluate a metric on all the elements of the batch, writing the result in q[0...b.size-1].
+// avg_V is the average element volume, and is used only by size related metrics. Metrics
+// that are not defined for the batch element (e.g. ODDY for tets) produce NaN values
+//
+CINO_INLINE
+void hex_quality(const HexBatch & b, const QualityMetric metric, double * q, const double avg_V = 0);
+
+CINO_INLINE
+void tet_quality(const TetBatch & b, const QualityMetric metric, double * q);
+
+// true if the metric is defined for tetrahedra (all metrics are defined for hexahedra)
+//
+CINO_INLINE
+bool quality_metric_supports_tets(const QualityMetric metric);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE void hex_diagonal              (const HexBatch & b, double * q);
+CINO_INLINE void hex_edge_ratio            (const HexBatch & b, double * q);
+CINO_INLINE void hex_jacobian              (const HexBatch & b, double * q);
+CINO_INLINE void hex_max_edge_ratio        (const HexBatch & b, double * q);
+CINO_INLINE void hex_max_aspect_Frobenius  (const HexBatch & b, double * q);
+CINO_INLINE void hex_mean_aspect_Frobenius (const HexBatch & b, double * q);
+CINO_INLINE void hex_oddy                  (const HexBatch & b, double * q);
+CINO_INLINE void hex_relative_size_squared (const HexBatch & b, const double & avgV,  double * q);
+CINO_INLINE void hex_scaled_jacobian       (const HexBatch & b, double * q);
+CINO_INLINE void hex_shape                 (const HexBatch & b, double * q);
+CINO_INLINE void hex_shape_and_size        (const HexBatch & b, const double & avg_V, double * q);
+CINO_INLINE void hex_shear                 (const HexBatch & b, double * q);
+CINO_INLINE void hex_shear_and_size        (const HexBatch & b, const double & avg_V, double * q);
+CINO_INLINE void hex_skew                  (const HexBatch & b, double * q);
+CINO_INLINE void hex_stretch               (const HexBatch & b, double * q);
+CINO_INLINE void hex_taper                 (const HexBatch & b, double * q);
+CINO_INLINE void hex_volume                (const HexBatch & b, double * q);
+CINO_INLINE void hex_unsigned_volume       (const HexBatch & b, double * q);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE void tet_scaled_jacobian       (const TetBatch & b, double * q);
+CINO_INLINE void tet_volume                (const TetBatch & b, double * q);
+CINO_INLINE void tet_unsigned_volume       (const TetBatch & b, double * q);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "quality_batch.cpp"
+#endif
+
+#endif // CINO_QUALITY_BATCH
@@ -0,0 +1,198 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/quality_report.h>
+#include <cinolib/parallel_for.h>
+#include <numeric>
+#include <limits>
+#include <iostream>
+#include <sstream>
+
+namespace cinolib
+{
+
+CINO_INLINE
+std::ostream & operator<<(std::ostream & in, const QualityReport & report)
+{
+    in << ":::::::::::::::::::::: QUALITY REPORT ::::::::::::::::::::::\n";
+    in << "Metric    : " << quality_metric_txt[report.metric] << "\n";
+    in << "Polys     : " << report.num_polys                   << "\n";
+    in << "Min       : " << report.min                         << "\n";
+    in << "Avg       : " << report.avg                         << "\n";
+    in << "Max       : " << report.max                         << "\n";
+    for(uint i=0; i<report.percentiles.size(); ++i)
+    {
+        std::ostringstream ss;
+        ss << "P" << report.percentiles_at.at(i) << "%";
+        std::string label = ss.str();
+        label.resize(std::max<size_t>(label.size(),10),' ');
+        in << label << ": " << report.percentiles.at(i) << "\n";
+    }
+    in << "Inverted  : " << report.inverted.size() << " (" << 100.0*report.inverted.size()/std::max(report.num_polys,1u) << "%)\n";
+    in << "::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::\n";
+    return in;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void polys_quality(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                   const QualityMetric                       metric,
+                         std::vector<double>               & q)
+{
+    q.resize(m.num_polys());
+    if(m.num_polys()==0) return;
+
+    double avg_V = 0;
+    if(metric==RELATIVE_SIZE_SQUARED || metric==SHAPE_AND_SIZE || metric==SHEAR_AND_SIZE)
+    {
+        polys_quality(m, VOLUME, 0, m.num_polys(), q.data());
+        avg_V = std::accumulate(q.begin(), q.end(), 0.0) / static_cast<double>(m.num_polys());
+    }
+    polys_quality(m, metric, 0, m.num_polys(), q.data(), avg_V);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void polys_quality(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                   const QualityMetric                       metric,
+                   const uint                                beg,
+                   const uint                                end,
+                         double                            * q,
+                   const double                              avg_V)
+{
+    assert(m.mesh_type()==TETMESH || m.mesh_type()==HEXMESH);
+    assert(beg<=end && end<=m.num_polys());
+
+    bool is_hex = (m.mesh_type()==HEXMESH);
+    uint n_batches = (end - beg + QUALITY_BATCH_SIZE - 1) / QUALITY_BATCH_SIZE;
+    PARALLEL_FOR(0, n_batches, 16, [&](const uint i)
+    {
+        uint b_beg = beg + i*QUALITY_BATCH_SIZE;
+        uint b_end = std::min(end, b_beg + QUALITY_BATCH_SIZE);
+        if(is_hex)
+        {
+            HexBatch b;
+            b.size = b_end - b_beg;
+            for(uint k=0; k<b.size; ++k)
+            for(uint j=0; j<8;      ++j) batch_set_vert(b, k, j, m.poly_vert(b_beg+k,j));
+            hex_quality(b, metric, q + (b_beg-beg), avg_V);
+        }
+        else
+        {
+            TetBatch b;
+            b.size = b_end - b_beg;
+            for(uint k=0; k<b.size; ++k)
+            for(uint j=0; j<4;      ++j) batch_set_vert(b, k, j, m.poly_vert(b_beg+k,j));
+            tet_quality(b, metric, q + (b_beg-beg));
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+QualityReport quality_report(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                             const QualityMetric                       metric,
+                             const std::vector<double>               & percentiles_at)
+{
+    QualityReport report;
+    report.metric         = metric;
+    report.num_polys      = m.num_polys();
+    report.percentiles_at = percentiles_at;
+    if(m.num_polys()==0) return report;
+
+    if(m.mesh_type()==TETMESH && !quality_metric_supports_tets(metric))
+    {
+        std::cerr << "ERROR : quality metric " << quality_metric_txt[metric] << " is not defined for tetrahedra" << std::endl;
+        report.min = report.max = report.avg = std::numeric_limits<double>::quiet_NaN();
+        report.percentiles.assign(percentiles_at.size(), std::numeric_limits<double>::quiet_NaN());
+        return report;
+    }
+
+    std::vector<double> q, sj;
+    polys_quality(m, metric, q);
+    if(metric!=SCALED_JACOBIAN) polys_quality(m, SCALED_JACOBIAN, sj);
+    const std::vector<double> & q_sj = (metric==SCALED_JACOBIAN) ? q : sj;
+
+    // per batch min/max/sum and inverted elements, merged in batch order
+    // (so that the result does not depend on the number of threads)
+    uint n_batches = (m.num_polys() + QUALITY_BATCH_SIZE - 1) / QUALITY_BATCH_SIZE;
+    std::vector<double> b_min(n_batches), b_max(n_batches), b_sum(n_batches);
+    std::vector<std::vector<uint>> b_inverted(n_batches);
+    PARALLEL_FOR(0, n_batches, 16, [&](const uint i)
+    {
+        uint b_beg = i*QUALITY_BATCH_SIZE;
+        uint b_end = std::min(m.num_polys(), b_beg + QUALITY_BATCH_SIZE);
+        b_min.at(i) = q.at(b_beg);
+        b_max.at(i) = q.at(b_beg);
+        b_sum.at(i) = 0;
+        for(uint pid=b_beg; pid<b_end; ++pid)
+        {
+            b_min.at(i)  = std::min(b_min.at(i), q.at(pid));
+            b_max.at(i)  = std::max(b_max.at(i), q.at(pid));
+            b_sum.at(i) += q.at(pid);
+            if(q_sj.at(pid)<=0) b_inverted.at(i).push_back(pid);
+        }
+    });
+    report.min = *std::min_element(b_min.begin(), b_min.end());
+    report.max = *std::max_element(b_max.begin(), b_max.end());
+    report.avg = std::accumulate(b_sum.begin(), b_sum.end(), 0.0) / static_cast<double>(m.num_polys());
+    for(const auto & inv : b_inverted) report.inverted.insert(report.inverted.end(), inv.begin(), inv.end());
+
+    // percentiles (nearest rank). Processing them in increasing order each
+    // selection only needs to scan the values above the previous one
+    std::vector<uint> order(percentiles_at.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](const uint i, const uint j) { return percentiles_at.at(i) < percentiles_at.at(j); });
+    report.percentiles.resize(percentiles_at.size());
+    uint from = 0;
+    for(uint i : order)
+    {
+        assert(percentiles_at.at(i)>=0 && percentiles_at.at(i)<=100);
+        uint pos = std::round(percentiles_at.at(i)/100.0 * (q.size()-1));
+        pos = std::max(pos, from);
+        std::nth_element(q.begin()+from, q.begin()+pos, q.end());
+        report.percentiles.at(i) = q.at(pos);
+        from = pos;
+    }
+    return report;
+}
+
+}
@@ -0,0 +1,105 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_QUALITY_REPORT_H
+#define CINO_QUALITY_REPORT_H
+
+#include <cinolib/meshes/abstract_polyhedralmesh.h>
+#include <cinolib/quality_batch.h>
+
+namespace cinolib
+{
+
+typedef struct
+{
+    QualityMetric       metric      = SCALED_JACOBIAN;
+    uint                num_polys   = 0;
+    double              min         = 0;
+    double              max         = 0;
+    double              avg         = 0;
+    std::vector<double> percentiles;    // one value for each entry in percentiles_at
+    std::vector<double> percentiles_at; // in [0,100]
+    std::vector<uint>   inverted;       // polys with non positive scaled jacobian
+}
+QualityReport;
+
+CINO_INLINE
+std::ostream & operator<<(std::ostream & in, const QualityReport & report);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// evaluates a quality metric for all the polys of a tetmesh or hexmesh
+// (see quality_batch.h for the list of metrics). Elements are processed in
+// batches of QUALITY_BATCH_SIZE consecutive polys, in parallel. For size
+// metrics the average element volume is computed first. Hex only metrics
+// evaluated on a tetmesh produce NaN values
+//
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void polys_quality(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                   const QualityMetric                       metric,
+                         std::vector<double>               & q);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// same as above, for polys in the range [beg,end) only. Results are written in q[0,end-beg)
+//
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void polys_quality(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                   const QualityMetric                       metric,
+                   const uint                                beg,
+                   const uint                                end,
+                         double                            * q,
+                   const double                              avg_V = 0);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// min/avg/max and percentiles of a quality metric, and the list of inverted elements.
+// Asking for a hex only metric on a tetmesh prints an error and returns NaN statistics
+//
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+QualityReport quality_report(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                             const QualityMetric                       metric         = SCALED_JACOBIAN,
+                             const std::vector<double>               & percentiles_at = {1,5,25,50,75,95,99});
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "quality_report.cpp"
+#endif
+
+#endif // CINO_QUALITY_REPORT_H
@@ -0,0 +1,354 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/reorder.h>
+#include <cinolib/geometry/aabb.h>
+#include <algorithm>
+#include <numeric>
+
+namespace cinolib
+{
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+MeshIdMaps reorder(AbstractPolygonMesh<M,V,E,P> & m, const ReorderStrategy strategy)
+{
+    MeshIdMaps id_maps = reorder_maps(m, strategy);
+    m.permute(id_maps);
+    return id_maps;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+MeshIdMaps reorder(AbstractPolyhedralMesh<M,V,E,F,P> & m, const ReorderStrategy strategy)
+{
+    MeshIdMaps id_maps = reorder_maps(m, strategy);
+    m.permute(id_maps);
+    return id_maps;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void reorder_verts_and_edges(const AbstractMesh<M,V,E,P> & m,
+                             const ReorderStrategy         strategy,
+                                   MeshIdMaps            & id_maps)
+{
+    switch(strategy)
+    {
+        case REORDER_MORTON  : id_maps.v_map = morton_order(m.vector_verts());                  break;
+        case REORDER_HILBERT : id_maps.v_map = hilbert_order(m.vector_verts());                 break;
+        case REORDER_RCM     : id_maps.v_map = reverse_Cuthill_McKee_order(m.vector_adj_v2v()); break;
+        default: assert(false && "unknown reordering strategy");
+    }
+
+    std::vector<uint64_t> keys(m.num_edges());
+    for(uint eid=0; eid<m.num_edges(); ++eid)
+    {
+        uint64_t v0 = id_maps.v_map.at(m.edge_vert_id(eid,0));
+        uint64_t v1 = id_maps.v_map.at(m.edge_vert_id(eid,1));
+        if(v0>v1) std::swap(v0,v1);
+        keys.at(eid) = (v0<<32) | v1;
+    }
+    id_maps.e_map = order_by_key(keys);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+MeshIdMaps reorder_maps(const AbstractPolygonMesh<M,V,E,P> & m, const ReorderStrategy strategy)
+{
+    MeshIdMaps id_maps;
+    reorder_verts_and_edges(m, strategy, id_maps);
+    id_maps.p_map = element_order(m.vector_polys(), id_maps.v_map);
+    return id_maps;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+MeshIdMaps reorder_maps(const AbstractPolyhedralMesh<M,V,E,F,P> & m, const ReorderStrategy strategy)
+{
+    MeshIdMaps id_maps;
+    reorder_verts_and_edges(m, strategy, id_maps);
+    id_maps.f_map = element_order(m.vector_faces(), id_maps.v_map);
+    std::vector<uint64_t> keys(m.num_polys());
+    for(uint pid=0; pid<m.num_polys(); ++pid) keys.at(pid) = element_key(m.adj_p2v(pid), id_maps.v_map);
+    id_maps.p_map = order_by_key(keys);
+    return id_maps;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint64_t element_key(const std::vector<uint> & verts, const std::vector<int> & v_map)
+{
+    assert(!verts.empty());
+    uint64_t min = v_map.at(verts.front());
+    uint64_t max = min;
+    for(uint vid : verts)
+    {
+        min = std::min(min, (uint64_t)v_map.at(vid));
+        max = std::max(max, (uint64_t)v_map.at(vid));
+    }
+    return (min<<32) | max;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<int> element_order(const std::vector<std::vector<uint>> & elem_verts,
+                               const std::vector<int>               & v_map)
+{
+    std::vector<uint64_t> keys(elem_verts.size());
+    for(uint i=0; i<elem_verts.size(); ++i) keys.at(i) = element_key(elem_verts.at(i), v_map);
+    return order_by_key(keys);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<int> order_by_key(const std::vector<uint64_t> & keys)
+{
+    std::vector<uint> sorted(keys.size());
+    std::iota(sorted.begin(), sorted.end(), 0);
+    std::stable_sort(sorted.begin(), sorted.end(), [&](const uint a, const uint b)
+    {
+        return keys.at(a) < keys.at(b);
+    });
+
+    std::vector<int> old2new(keys.size());
+    for(uint i=0; i<sorted.size(); ++i) old2new.at(sorted.at(i)) = i;
+    return old2new;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+namespace
+{
+    // maps points to a 2^21 x 2^21 x 2^21 integer grid fitted to their bounding box
+    CINO_INLINE
+    void quantize(const std::vector<vec3d> & points, std::vector<uint> & q)
+    {
+        AABB bb(points);
+        double s = 2097151.0 / std::max(bb.delta().max_entry(), 1e-300);
+        q.resize(3*points.size());
+        for(uint i=0; i<points.size(); ++i)
+        {
+            vec3d p = (points.at(i) - bb.min) * s;
+            q.at(3*i  ) = std::min(2097151u, (uint)std::max(0.0, p.x()));
+            q.at(3*i+1) = std::min(2097151u, (uint)std::max(0.0, p.y()));
+            q.at(3*i+2) = std::min(2097151u, (uint)std::max(0.0, p.z()));
+        }
+    }
+
+    // spreads the lowest 21 bits of x, so that there are two zeros between each bit
+    CINO_INLINE
+    uint64_t spread_bits(const uint x)
+    {
+        uint64_t b = x & 0x1fffff;
+        b = (b | b << 32) & 0x1f00000000ffff;
+        b = (b | b << 16) & 0x1f0000ff0000ff;
+        b = (b | b <<  8) & 0x100f00f00f00f00f;
+        b = (b | b <<  4) & 0x10c30c30c30c30c3;
+        b = (b | b <<  2) & 0x1249249249249249;
+        return b;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint64_t morton_code(const uint x, const uint y, const uint z)
+{
+    return spread_bits(x) | (spread_bits(y) << 1) | (spread_bits(z) << 2);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint64_t hilbert_code(const uint x, const uint y, const uint z)
+{
+    // Skilling's algorithm: converts axes to the "transposed" Hilbert index,
+    // which is then interleaved as a Morton code. Reference:
+    //
+    //   Programming the Hilbert curve
+    //   John Skilling
+    //   AIP Conference Proceedings, 2004
+    //
+    uint X[3] = { x & 0x1fffff, y & 0x1fffff, z & 0x1fffff };
+    const uint M = 1u << 20;
+
+    for(uint Q=M; Q>1; Q>>=1) // inverse undo
+    {
+        uint P = Q-1;
+        for(uint i=0; i<3; ++i)
+        {
+            if(X[i] & Q) X[0] ^= P; else
+            {
+                uint t = (X[0] ^ X[i]) & P;
+                X[0] ^= t;
+                X[i] ^= t;
+            }
+        }
+    }
+    for(uint i=1; i<3; ++i) X[i] ^= X[i-1]; // Gray encode
+    uint t = 0;
+    for(uint Q=M; Q>1; Q>>=1) if(X[2] & Q) t ^= Q-1;
+    for(uint i=0; i<3; ++i) X[i] ^= t;
+
+    // X[0] holds the most significant bit of each triplet
+    return morton_code(X[2], X[1], X[0]);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<int> morton_order(const std::vector<vec3d> & points)
+{
+    if(points.empty()) return std::vector<int>();
+    std::vector<uint> q;
+    quantize(points, q);
+    std::vector<uint64_t> keys(points.size());
+    for(uint i=0; i<points.size(); ++i) keys.at(i) = morton_code(q.at(3*i), q.at(3*i+1), q.at(3*i+2));
+    return order_by_key(keys);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<int> hilbert_order(const std::vector<vec3d> & points)
+{
+    if(points.empty()) return std::vector<int>();
+    std::vector<uint> q;
+    quantize(points, q);
+    std::vector<uint64_t> keys(points.size());
+    for(uint i=0; i<points.size(); ++i) keys.at(i) = hilbert_code(q.at(3*i), q.at(3*i+1), q.at(3*i+2));
+    return order_by_key(keys);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<int> reverse_Cuthill_McKee_order(const std::vector<std::vector<uint>> & adj)
+{
+    uint n = adj.size();
+    std::vector<uint> order;
+    order.reserve(n);
+    std::vector<bool> visited(n, false);
+    std::vector<uint> level(n, 0);
+    std::vector<uint> stamp(n, 0);
+    uint curr_stamp = 0;
+
+    // BFS restricted to the unvisited vertices. Returns the eccentricity of
+    // the seed and the min degree vertex in its last level
+    auto bfs_last_level = [&](const uint seed, uint & far) -> uint
+    {
+        ++curr_stamp;
+        std::vector<uint> q(1, seed);
+        stamp.at(seed) = curr_stamp;
+        level.at(seed) = 0;
+        uint ecc = 0;
+        far = seed;
+        for(uint i=0; i<q.size(); ++i)
+        {
+            uint vid = q.at(i);
+            if(level.at(vid) > ecc || (level.at(vid)==ecc && adj.at(vid).size() < adj.at(far).size()))
+            {
+                ecc = level.at(vid);
+                far = vid;
+            }
+            for(uint nbr : adj.at(vid))
+            {
+                if(visited.at(nbr) || stamp.at(nbr)==curr_stamp) continue;
+                stamp.at(nbr) = curr_stamp;
+                level.at(nbr) = level.at(vid)+1;
+                q.push_back(nbr);
+            }
+        }
+        return ecc;
+    };
+
+    std::vector<uint> nbrs;
+    for(uint vid=0; vid<n; ++vid)
+    {
+        if(visited.at(vid)) continue;
+
+        // pseudo peripheral vertex (George and Liu)
+        uint root = vid, far;
+        uint ecc  = bfs_last_level(root, far);
+        for(uint it=0; it<8 && far!=root; ++it)
+        {
+            uint tmp;
+            uint far_ecc = bfs_last_level(far, tmp);
+            if(far_ecc <= ecc) break;
+            ecc  = far_ecc;
+            root = far;
+            far  = tmp;
+        }
+
+        // Cuthill-McKee: BFS visiting neighbors by increasing degree
+        uint beg = order.size();
+        order.push_back(root);
+        visited.at(root) = true;
+        for(uint i=beg; i<order.size(); ++i)
+        {
+            nbrs.clear();
+            for(uint nbr : adj.at(order.at(i)))
+            {
+                if(visited.at(nbr)) continue;
+                visited.at(nbr) = true;
+                nbrs.push_back(nbr);
+            }
+            std::stable_sort(nbrs.begin(), nbrs.end(), [&](const uint a, const uint b)
+            {
+                return adj.at(a).size() < adj.at(b).size();
+            });
+            order.insert(order.end(), nbrs.begin(), nbrs.end());
+        }
+    }
+    assert(order.size()==n);
+
+    std::vector<int> old2new(n);
+    for(uint i=0; i<n; ++i) old2new.at(order.at(i)) = n-1-i;
+    return old2new;
+}
+
+}
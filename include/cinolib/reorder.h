@@ -0,0 +1,152 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_REORDER_H
+#define CINO_REORDER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/meshes/abstract_polygonmesh.h>
+#include <cinolib/meshes/abstract_polyhedralmesh.h>
+
+/* Cache friendly relabeling of mesh elements. Element ids usually come
+ * straight from the input file, hence traversing adjacencies (e.g. while
+ * assembling a Laplacian, smoothing or running Dijkstra) jumps randomly
+ * through memory. Vertices can be sorted along a space filling curve
+ * (Morton or Hilbert), which keeps spatially close vertices close in
+ * memory, or with the reverse Cuthill-McKee algorithm, which minimizes the
+ * bandwidth of the vertex adjacency (hence of any matrix built upon it).
+ * Edges, faces and polys are then sorted by the new ids of their vertices,
+ * so that all element lists follow the same order.
+ *
+ * All the functions return old to new ids, in the same format used by
+ * the mesh editing operators (see MeshIdMaps in abstract_mesh.h)
+*/
+
+namespace cinolib
+{
+
+typedef enum
+{
+    REORDER_MORTON  , // z-order curve
+    REORDER_HILBERT , // Hilbert curve (better locality than Morton)
+    REORDER_RCM     , // reverse Cuthill-McKee (minimum bandwidth)
+}
+ReorderStrategy;
+
+static const std::string reorder_strategy_txt[3] =
+{
+    "REORDER_MORTON" ,
+    "REORDER_HILBERT",
+    "REORDER_RCM"    ,
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// sorts the elements of m with the given strategy, and returns the permutations
+// that have been applied (f_map is filled only for volume meshes)
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+MeshIdMaps reorder(AbstractPolygonMesh<M,V,E,P> & m, const ReorderStrategy strategy = REORDER_HILBERT);
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+MeshIdMaps reorder(AbstractPolyhedralMesh<M,V,E,F,P> & m, const ReorderStrategy strategy = REORDER_HILBERT);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// computes (without applying them) the permutations used by reorder()
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+MeshIdMaps reorder_maps(const AbstractPolygonMesh<M,V,E,P> & m, const ReorderStrategy strategy = REORDER_HILBERT);
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+MeshIdMaps reorder_maps(const AbstractPolyhedralMesh<M,V,E,F,P> & m, const ReorderStrategy strategy = REORDER_HILBERT);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// vertex orders (old to new ids)
+//
+CINO_INLINE
+std::vector<int> morton_order(const std::vector<vec3d> & points);
+
+CINO_INLINE
+std::vector<int> hilbert_order(const std::vector<vec3d> & points);
+
+CINO_INLINE
+std::vector<int> reverse_Cuthill_McKee_order(const std::vector<std::vector<uint>> & adj);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// sorts a list of elements by the smallest new id of their vertices, breaking
+// ties with the biggest new id (and then with the original order)
+//
+CINO_INLINE
+std::vector<int> element_order(const std::vector<std::vector<uint>> & elem_verts,
+                               const std::vector<int>               & v_map);
+
+// sorting key used by element_order: (min new vertex id, max new vertex id)
+//
+CINO_INLINE
+uint64_t element_key(const std::vector<uint> & verts, const std::vector<int> & v_map);
+
+// stable sort of element ids by key (returns old to new ids)
+//
+CINO_INLINE
+std::vector<int> order_by_key(const std::vector<uint64_t> & keys);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// 63 bits keys for points in a 2^21 x 2^21 x 2^21 integer grid
+//
+CINO_INLINE
+uint64_t morton_code(const uint x, const uint y, const uint z);
+
+CINO_INLINE
+uint64_t hilbert_code(const uint x, const uint y, const uint z);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "reorder.cpp"
+#endif
+
+#endif // CINO_REORDER_H
@@ -34,38 +34,103 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/sample_mesh.h>
-#include <cinolib/geodesics.h>
+#include <cinolib/min_max_inf.h>
+#include <set>
+#include <queue>
 
 namespace cinolib
 {
 
 template<class M, class V, class E, class P>
 CINO_INLINE
-void sample_mesh(AbstractPolygonMesh<M,V,E,P> & m, const uint n_samples, std::vector<uint> & samples)
+void farthest_point_sampling(const AbstractMesh<M,V,E,P> & m,
+                             const uint                    n_samples,
+                             const uint                    first_sample,
+                                   std::vector<uint>     & samples,
+                                   std::vector<double>   & dist,
+                                   std::vector<uint>     & voronoi)
 {
     assert(n_samples > 0);
+    assert(first_sample < m.num_verts());
 
-    srand(time(NULL));
-    samples = { rand()%m.num_verts() };
+    uint nv = m.num_verts();
+    samples.clear();
+    dist    = std::vector<double>(nv, inf_double);
+    voronoi = std::vector<uint>(nv, 0);
 
-    GeodesicsCache cache;
-    ScalarField f = compute_geodesics_amortized(m, cache, samples);
+    // the farthest vertex is kept on top of a max heap. Distances can only decrease,
+    // hence instead of updating an entry a new one is pushed, and entries that do not
+    // match the current distance are discarded when they reach the top. Ties are
+    // broken in favor of the smallest vertex id
+    typedef std::pair<double,uint> Entry;
+    auto closer = [](const Entry & a, const Entry & b)
+    {
+        return (a.first < b.first) || (a.first == b.first && a.second > b.second);
+    };
+    std::vector<Entry> heap_data(nv);
+    for(uint vid=0; vid<nv; ++vid) heap_data[vid] = std::make_pair(inf_double,vid);
+    std::priority_queue<Entry,std::vector<Entry>,decltype(closer)> farthest(closer, std::move(heap_data));
 
-    for(uint i=1; i<n_samples; ++i)
+    std::set<std::pair<double,uint>> q;
+    uint next = first_sample;
+    while(samples.size() < n_samples)
     {
-        double dist = f[samples.back()];
-        uint   sample;
-        for(uint vid=0; vid<m.num_verts(); ++vid)
+        uint sid = samples.size();
+        samples.push_back(next);
+
+        // pruned Dijkstra: a vertex is expanded only if the new sample
+        // is closer than any of the previous ones. Vertices that do not
+        // improve cannot be on a shortest path to vertices that do, hence
+        // the updated field is exact
+        dist.at(next)    = 0.0;
+        voronoi.at(next) = sid;
+        q.insert(std::make_pair(0.0,next));
+        while(!q.empty())
         {
-            if(f[vid] < dist)
+            uint vid = q.begin()->second;
+            q.erase(q.begin());
+
+            for(uint nbr : m.adj_v2v(vid))
             {
-                dist   = f[vid];
-                sample = vid;
+                double new_dist = dist.at(vid) + m.vert(vid).dist(m.vert(nbr));
+                if(dist.at(nbr) > new_dist)
+                {
+                    if(dist.at(nbr)<inf_double && voronoi.at(nbr)==sid) // already in queue for this source: update its priority
+                    {
+                        auto it = q.find(std::make_pair(dist.at(nbr),nbr));
+                        assert(it!=q.end());
+                        q.erase(it);
+                    }
+                    dist.at(nbr)    = new_dist;
+                    voronoi.at(nbr) = sid;
+                    q.insert(std::make_pair(new_dist,nbr));
+                    farthest.push(std::make_pair(new_dist,nbr));
+                }
             }
         }
-        samples.push_back(sample);
-        f = compute_geodesics_amortized(m, cache, samples);
+
+        if(samples.size() == n_samples) break;
+
+        while(!farthest.empty() && farthest.top().first != dist.at(farthest.top().second)) farthest.pop(); // outdated
+        if(farthest.empty()) break; // all vertices have been sampled
+        next = farthest.top().second;
+
+        if(dist.at(next) == 0.0) break; // all vertices have been sampled
     }
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void sample_mesh(AbstractPolygonMesh<M,V,E,P> & m, const uint n_samples, std::vector<uint> & samples)
+{
+    assert(n_samples > 0);
+
+    srand(time(NULL));
+    std::vector<double> dist;
+    std::vector<uint>   voronoi;
+    farthest_point_sampling(m, n_samples, rand()%m.num_verts(), samples, dist, voronoi);
+}
+
 }
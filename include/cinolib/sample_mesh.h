@@ -41,16 +41,41 @@
 namespace cinolib
 {
 
-/* This is just an awful method that selects a subset of mesh vertices from an input mesh.
- * It works by starting from a random vertex, and iteratively picking as next vertex the one
- * that is furthest from all the previously selected vertices. Distance computation is cheap
- * because the amortized heat based geodesics are used.
+/* Farthest point sampling of the vertices of a mesh, using the edge graph
+ * as metric. Starting from first_sample, at each iteration the vertex that
+ * is farthest from the current set of samples is added to it.
  *
- * For a more serious resource to solve this problem, one may refer to:
+ * The method is incremental: a running min-distance field is kept for all
+ * vertices, and each new sample updates it with a Dijkstra visit that stops
+ * expanding as soon as it reaches vertices that are already closer to some
+ * other sample. As the sampling densifies, each visit touches only the
+ * Voronoi cell of the new sample, making the extraction of thousands of
+ * samples affordable. The farthest vertex is taken from a lazy max-heap of
+ * distances (stale entries are discarded when popped), so that each pick
+ * does not need to scan all the vertices.
  *
- * Efficient and Flexible Sampling with Blue Noise Properties of Triangular Meshes
- * IEEE Transactions on Visualization and Computer Graphics (2012)
- * M.Corsini, P.Cignoni, R.Scopigno
+ * In output:
+ *  - samples: the ids of the sampled vertices, in order of extraction
+ *  - dist   : for each vertex, the distance from its closest sample
+ *  - voronoi: for each vertex, the position (in samples) of its closest sample
+ *
+ * If the mesh has multiple connected components, samples will eventually
+ * land on each of them. Sampling stops early if all vertices are sampled.
+*/
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void farthest_point_sampling(const AbstractMesh<M,V,E,P> & m,
+                             const uint                    n_samples,
+                             const uint                    first_sample,
+                                   std::vector<uint>     & samples,
+                                   std::vector<double>   & dist,
+                                   std::vector<uint>     & voronoi);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Selects a subset of n_samples mesh vertices by farthest point sampling,
+ * starting from a random vertex.
 */
 
 template<class M, class V, class E, class P>
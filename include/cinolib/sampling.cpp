@@ -61,4 +61,28 @@ std::vector<T> sample_within_interval(const T    min,
     return samples;
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<vec3d> sample_within_box(const vec3d & min,
+                                     const vec3d & max,
+                                     const uint    nx,
+                                     const uint    ny,
+                                     const uint    nz)
+{
+    std::vector<double> x = sample_within_interval(min.x(), max.x(), nx);
+    std::vector<double> y = sample_within_interval(min.y(), max.y(), ny);
+    std::vector<double> z = sample_within_interval(min.z(), max.z(), nz);
+
+    std::vector<vec3d> samples;
+    samples.reserve(nx*ny*nz);
+    for(uint k=0; k<nz; ++k)
+    for(uint j=0; j<ny; ++j)
+    for(uint i=0; i<nx; ++i)
+    {
+        samples.push_back(vec3d(x[i], y[j], z[k]));
+    }
+    return samples;
+}
+
 }
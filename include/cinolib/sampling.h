@@ -39,6 +39,7 @@
 #include <vector>
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec3.h>
 
 namespace cinolib
 {
@@ -47,6 +48,15 @@ namespace cinolib
     std::vector<T> sample_within_interval(const T    min,
                                           const T    max,
                                           const uint n_samples);
+
+    // nodes of a regular grid with nx*ny*nz samples spanning the box [min,max].
+    // Samples are serialized with x running fastest, i.e. node (i,j,k) is at i + nx*(j + ny*k)
+    CINO_INLINE
+    std::vector<vec3d> sample_within_box(const vec3d & min,
+                                         const vec3d & max,
+                                         const uint    nx,
+                                         const uint    ny,
+                                         const uint    nz);
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -49,11 +49,26 @@ namespace cinolib
 template<class M, class V, class E, class P>
 CINO_INLINE
 void shortest_path_tree(AbstractPolygonMesh<M,V,E,P> & m, const uint root, std::vector<bool> & tree)
+{
+    std::vector<double> dist;
+    std::vector<int>    parent;
+    shortest_path_tree(m, root, tree, dist, parent);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void shortest_path_tree(const AbstractPolygonMesh<M,V,E,P> & m,
+                        const uint                           root,
+                              std::vector<bool>            & tree,
+                              std::vector<double>          & dist,
+                              std::vector<int>             & parent)
 {
     // if true, the edge is on the tree
-    tree = std::vector<bool>(m.num_edges(), false);
+    tree.assign(m.num_edges(), false);
+    parent.assign(m.num_verts(), -1);
 
-    std::vector<double> dist;
     dijkstra_exhaustive(m, root, dist);
 
     for(uint vid=0; vid<m.num_verts(); ++vid)
@@ -61,20 +76,19 @@ void shortest_path_tree(AbstractPolygonMesh<M,V,E,P> & m, const uint root, std::
         if(vid==root) continue;
 
         // there may be multiple shortest paths from root to vid.
-        // I store them all, and consistently choose the one with
-        // lowest ID. This should avoid the generation of loops
+        // I consistently choose the one with lowest ID. This should
+        // avoid the generation of loops
         // (https://en.wikipedia.org/wiki/Shortest-path_tree)
-        std::vector<uint> parent;
         for(uint nbr : m.adj_v2v(vid))
         {
             int eid = m.edge_id(vid, nbr); assert(eid>=0);
             if(dist.at(vid) == m.edge_length(eid) + dist.at(nbr))
             {
-                parent.push_back(nbr);
+                if(parent.at(vid)==-1 || (int)nbr<parent.at(vid)) parent.at(vid) = nbr;
             }
         }
-        assert(!parent.empty());
-        int eid = m.edge_id(vid, *std::min_element(parent.begin(), parent.end()));
+        assert(parent.at(vid)>=0);
+        int eid = m.edge_id(vid, parent.at(vid));
         tree.at(eid) = true;
     }
 }
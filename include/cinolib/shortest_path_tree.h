@@ -52,6 +52,16 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void shortest_path_tree(AbstractPolygonMesh<M,V,E,P> & m, const uint root, std::vector<bool> & tree);
 
+// same as above, but also returns the geodesic distance from the root (dist) and,
+// for each vertex, the next vertex along its tree path to the root (parent, -1 for the root)
+template<class M, class V, class E, class P>
+CINO_INLINE
+void shortest_path_tree(const AbstractPolygonMesh<M,V,E,P> & m,
+                        const uint                           root,
+                              std::vector<bool>            & tree,
+                              std::vector<double>          & dist,
+                              std::vector<int>             & parent);
+
 }
 
 #ifndef  CINO_STATIC_LIB
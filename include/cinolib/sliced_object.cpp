@@ -35,9 +35,12 @@
 *********************************************************************************/
 #include <cinolib/sliced_object.h>
 #include <cinolib/io/read_CLI.h>
+#include <cinolib/layer_slicing.h>
 #include <cinolib/triangle_wrap.h>
 #include <cinolib/vector_serialization.h>
 #include <cinolib/ANSI_color_codes.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/min_max_inf.h>
 
 namespace cinolib
 {
@@ -73,6 +76,25 @@ SlicedObj<M,V,E,P>::SlicedObj(const std::vector<std::vector<std::vector<vec3d>>>
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+SlicedObj<M,V,E,P>::SlicedObj(const Trimesh<M,V,E,P> & m,
+                              const double             layer_thickness,
+                              const double             thick_radius)
+    : Trimesh<M,V,E,P>()
+    , thick_radius(thick_radius)
+{
+    std::vector<double> layer_z;
+    std::vector<std::vector<std::vector<vec3d>>> slice_polys;
+    std::vector<std::vector<std::vector<vec3d>>> slice_holes;
+    slice_into_layers(m, layer_thickness, layer_z, slice_polys, slice_holes);
+    std::vector<std::vector<std::vector<vec3d>>> supports(layer_z.size());
+    hatches.resize(layer_z.size());
+    init(slice_polys, slice_holes, supports);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 BoostMultiPolygon SlicedObj<M,V,E,P>::slice_as_boost_poly(const uint sid) const
@@ -90,17 +112,27 @@ void SlicedObj<M,V,E,P>::init(const std::vector<std::vector<std::vector<vec3d>>>
 {
     uint num_slices = slice_polys.size();
 
+    // empty slices are skipped
+    std::vector<uint> sids;
     for(uint sid=0; sid<num_slices; ++sid)
     {
         uint np = slice_holes.at(sid).size();
-        uint nh = slice_polys.at(sid).size();
         uint ns = (thick_radius>0) ? supports.at(sid).size() : 0;
 
-        std::cout << "processing slice " << sid << " out of " << num_slices << "\t(" << np << " polys / " << nh << " holes / "  << ns << " supports)" << std::endl;
-
         if(np>0) z.push_back(slice_holes.at(sid).front().front().z()); else
         if(ns>0) z.push_back(supports.at(sid).front().front().z());    else
-        continue; // empty slice, skip it
+        continue;
+
+        sids.push_back(sid);
+    }
+
+    std::cout << "processing " << sids.size() << " non empty slices out of " << num_slices << std::endl;
+
+    // slices are independent from each other: process them in parallel
+    slices.resize(sids.size());
+    PARALLEL_FOR(0, sids.size(), 2, [&](const uint i)
+    {
+        uint sid = sids.at(i);
 
         std::vector<BoostPolygon> polys;
         std::vector<BoostPolygon> holes;
@@ -117,9 +149,10 @@ void SlicedObj<M,V,E,P>::init(const std::vector<std::vector<std::vector<vec3d>>>
         mp = polygon_simplify(mp, 0.1*thick_radius);
 
         assert(mp.size()>0);
-        slices.push_back(mp);
-    }
+        slices.at(i) = mp;
+    });
 
+    build_slice_grids();
     triangulate_slices();
 }
 
@@ -129,34 +162,96 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void SlicedObj<M,V,E,P>::triangulate_slices()
 {
-    for(uint sid=0; sid<slices.size(); ++sid)
+    // triangulate each slice independently. This is done serially because
+    // Triangle keeps its state in globals and is not reentrant...
+    std::vector<std::vector<vec3d>> slice_verts(num_slices());
+    std::vector<std::vector<uint>>  slice_tris (num_slices());
+    for(uint sid=0; sid<num_slices(); ++sid)
+    {
+        triangulate_polygon(slices.at(sid), "Q", z.at(sid), slice_verts.at(sid), slice_tris.at(sid));
+    }
+
+    // ...and merge them into the mesh in one step
+    std::vector<vec3d> verts;
+    std::vector<uint>  tris;
+    std::vector<uint>  v_sid, p_sid;
+    for(uint sid=0; sid<num_slices(); ++sid)
+    {
+        uint base_addr = verts.size();
+        for(uint vid : slice_tris.at(sid)) tris.push_back(base_addr + vid);
+        verts.insert(verts.end(), slice_verts.at(sid).begin(), slice_verts.at(sid).end());
+        v_sid.insert(v_sid.end(), slice_verts.at(sid).size(),  sid);
+        p_sid.insert(p_sid.end(), slice_tris.at(sid).size()/3, sid);
+    }
+    Trimesh<M,V,E,P>::init(verts, polys_from_serialized_vids(tris,3));
+
+    PARALLEL_FOR(0, this->num_verts(), 1000, [&](const uint vid)
+    {
+        this->vert_data(vid).uvw   = vec3d(static_cast<double>(v_sid.at(vid))/static_cast<double>(num_slices()),0,0);
+        this->vert_data(vid).label = v_sid.at(vid);
+    });
+    PARALLEL_FOR(0, this->num_polys(), 1000, [&](const uint pid)
+    {
+        this->poly_data(pid).label = p_sid.at(pid);
+    });
+    PARALLEL_FOR(0, this->num_edges(), 1000, [&](const uint eid)
+    {
+        this->edge_data(eid).label = p_sid.at(this->adj_e2p(eid).front());
+    });
+
+    std::cout << "new sliced object (" << num_slices() << " slices)" << std::endl;
+    this->edge_mark_boundaries();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void SlicedObj<M,V,E,P>::build_slice_grids()
+{
+    grids.resize(num_slices());
+    PARALLEL_FOR(0, num_slices(), 2, [&](const uint sid)
     {
-        const BoostMultiPolygon & mp = slices.at(sid);
+        SliceGrid & g = grids.at(sid);
+        polygon_get_edges(slices.at(sid), g.verts, g.edges);
+
+        g.min = vec2d( inf_double,  inf_double);
+        g.max = vec2d(-inf_double, -inf_double);
+        for(const vec2d & p : g.verts)
+        {
+            g.min = g.min.min(p);
+            g.max = g.max.max(p);
+        }
 
-        std::vector<vec3d> verts;
-        std::vector<uint>  tris;
-        triangulate_polygon(mp, "Q", z.at(sid), verts, tris);
+        // about four edges per band on average
+        uint   n_edges = g.edges.size()/2;
+        uint   n_bands = std::max(n_edges/4, uint(1));
+        double dy      = g.max.y() - g.min.y();
+        g.band_h       = (dy>0) ? dy/n_bands : 1.0;
 
-        uint base_addr = this->num_verts();
-        uint n_tris = tris.size()/3;
+        auto band = [&](const double y)
+        {
+            return std::min(n_bands-1, static_cast<uint>((y-g.min.y())/g.band_h));
+        };
 
-        for(auto p : verts)
+        g.band_off.assign(n_bands+1, 0);
+        for(uint eid=0; eid<n_edges; ++eid)
         {
-            uint vid = this->vert_add(p);
-            this->vert_data(vid).uvw[0] = static_cast<double>(sid)/static_cast<double>(num_slices());
-            this->vert_data(vid).label  = sid;
+            double y0 = g.verts.at(g.edges.at(2*eid+0)).y();
+            double y1 = g.verts.at(g.edges.at(2*eid+1)).y();
+            for(uint b=band(std::min(y0,y1)); b<=band(std::max(y0,y1)); ++b) ++g.band_off.at(b+1);
         }
-        for(uint i=0; i<n_tris; ++i)
+        for(uint b=0; b<n_bands; ++b) g.band_off.at(b+1) += g.band_off.at(b);
+
+        g.band_edges.resize(g.band_off.back());
+        std::vector<uint> fill(g.band_off.begin(), g.band_off.end()-1);
+        for(uint eid=0; eid<n_edges; ++eid)
         {
-            uint pid = this->poly_add(base_addr + tris.at(3*i+0),
-                                      base_addr + tris.at(3*i+1),
-                                      base_addr + tris.at(3*i+2));
-            this->poly_data(pid).label = sid;
-            for(uint eid : this->adj_p2e(pid)) this->edge_data(eid).label = sid;
+            double y0 = g.verts.at(g.edges.at(2*eid+0)).y();
+            double y1 = g.verts.at(g.edges.at(2*eid+1)).y();
+            for(uint b=band(std::min(y0,y1)); b<=band(std::max(y0,y1)); ++b) g.band_edges.at(fill.at(b)++) = eid;
         }
-    }
-    std::cout << "new sliced object (" << num_slices() << " slices)" << std::endl;
-    this->edge_mark_boundaries();
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -231,7 +326,34 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 bool SlicedObj<M,V,E,P>::slice_contains(const uint sid, const vec2d & p) const
 {
-    return polygon_contains(slices.at(sid), p, true);
+    // crossing number test against the edges of the band containing p.
+    // Points on the slice boundary are considered inside
+    const SliceGrid & g = grids.at(sid);
+    if(g.edges.empty()) return false;
+    if(p.x() < g.min.x() || p.x() > g.max.x() ||
+       p.y() < g.min.y() || p.y() > g.max.y()) return false;
+
+    uint n_bands = g.band_off.size()-1;
+    uint b       = std::min(n_bands-1, static_cast<uint>((p.y()-g.min.y())/g.band_h));
+    bool inside  = false;
+    for(uint i=g.band_off.at(b); i<g.band_off.at(b+1); ++i)
+    {
+        uint          eid = g.band_edges.at(i);
+        const vec2d & v0  = g.verts.at(g.edges.at(2*eid+0));
+        const vec2d & v1  = g.verts.at(g.edges.at(2*eid+1));
+
+        double orient = (v1.x()-v0.x())*(p.y()-v0.y()) - (v1.y()-v0.y())*(p.x()-v0.x());
+        if(orient == 0 &&
+           p.x() >= std::min(v0.x(),v1.x()) && p.x() <= std::max(v0.x(),v1.x()) &&
+           p.y() >= std::min(v0.y(),v1.y()) && p.y() <= std::max(v0.y(),v1.y())) return true;
+
+        if((v0.y() > p.y()) != (v1.y() > p.y()))
+        {
+            double x = v0.x() + (p.y()-v0.y())*(v1.x()-v0.x())/(v1.y()-v0.y());
+            if(p.x() < x) inside = !inside;
+        }
+    }
+    return inside;
 }
 
 }
@@ -70,6 +70,13 @@ class SlicedObj : public Trimesh<M,V,E,P>
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+        // slices a closed triangle mesh into uniform layers (see layer_slicing.h)
+        explicit SlicedObj(const Trimesh<M,V,E,P> & m,
+                           const double             layer_thickness,
+                           const double             thick_radius = 0.01);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
         uint num_slices() const { return slices.size(); }
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -95,9 +102,30 @@ class SlicedObj : public Trimesh<M,V,E,P>
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+        void build_slice_grids();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // Scanline acceleration structure for point in slice queries. The y range of
+        // the slice is split into horizontal bands of equal height, and each band
+        // stores the boundary edges that overlap it (CSR layout)
+        //
+        struct SliceGrid
+        {
+            vec2d              min, max;   // slice bounding box
+            double             band_h;     // band height
+            std::vector<vec2d> verts;      // boundary vertices
+            std::vector<uint>  edges;      // boundary edges (serialized pairs of vids)
+            std::vector<uint>  band_off;   // edges in band i are band_edges[band_off[i]...band_off[i+1]-1]
+            std::vector<uint>  band_edges;
+        };
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
         double                                       thick_radius; // supports thickening radius
         std::vector<float>                           z;            // per slice z-coord
         std::vector<BoostMultiPolygon>               slices;       // slices (included thickened supports)
+        std::vector<SliceGrid>                       grids;        // per slice acceleration structure for slice_contains
         std::vector<std::vector<std::vector<vec3d>>> hatches;      // unused so far, just keeping them
 };
 
@@ -117,6 +117,16 @@ static const uint TET_INCIDENT_EDEGES[4][3] =
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+static const uint TET_CORNERS[4][3] = // verts adjacent to each vert, ordered as a right handed frame
+{
+    { 1, 2, 3 }, // v0
+    { 0, 3, 2 }, // v1
+    { 3, 0, 1 }, // v2
+    { 2, 1, 0 }, // v3
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 static const uint HEXA_FACES[6][4] = // for outgoing normals
 {
     { 0 , 3 , 2 , 1 } , // f0
@@ -161,6 +171,20 @@ static const uint HEXA_INCIDENT_EDGES[8][3] =
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+static const uint HEXA_CORNERS[8][3] = // verts adjacent to each vert, ordered as a right handed frame
+{
+    { 1, 3, 4 }, // v0
+    { 0, 5, 2 }, // v1
+    { 1, 6, 3 }, // v2
+    { 0, 2, 7 }, // v3
+    { 0, 7, 5 }, // v4
+    { 1, 4, 6 }, // v5
+    { 2, 5, 7 }, // v6
+    { 3, 6, 4 }, // v7
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 }
 
 #endif // CINO_STANDARD_ELEMENTS_TABLES_H
@@ -287,4 +287,32 @@ void VEC_INSERT_AFTER(std::vector<T> & vec, const T & ref_item, const T & new_it
     vec.insert(pos, new_item);
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+void PERMUTE_VEC(std::vector<T> & vec, const std::vector<int> & old2new)
+{
+    assert(vec.size()==old2new.size());
+    std::vector<T> tmp(vec.size());
+    for(uint i=0; i<vec.size(); ++i)
+    {
+        assert(old2new.at(i)>=0 && old2new.at(i)<(int)vec.size());
+        tmp.at(old2new.at(i)) = std::move(vec.at(i));
+    }
+    vec.swap(tmp);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void REMAP_VEC(std::vector<uint> & vec, const std::vector<int> & old2new)
+{
+    for(uint & id : vec)
+    {
+        assert(old2new.at(id)>=0);
+        id = old2new.at(id);
+    }
+}
+
 }
@@ -38,6 +38,7 @@
 
 #include <vector>
 #include <chrono>
+#include <sys/types.h>
 #include <cinolib/cino_inline.h>
 
 namespace cinolib
@@ -169,6 +170,19 @@ template<typename T>
 CINO_INLINE
 void VEC_INSERT_AFTER(std::vector<T> & vec, const T & ref_item, const T & new_item);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// moves each element vec[i] to position old2new[i] (old2new must be a permutation)
+template<typename T>
+CINO_INLINE
+void PERMUTE_VEC(std::vector<T> & vec, const std::vector<int> & old2new);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// replaces each id stored in vec with old2new[id]
+CINO_INLINE
+void REMAP_VEC(std::vector<uint> & vec, const std::vector<int> & old2new);
+
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -34,7 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/subdivision_barycentric.h>
-#include <unordered_map>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
@@ -44,80 +44,72 @@ namespace cinolib
 */
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
-void subdivision_barycentric(Tetmesh<M,V,E,F,P> & m)
+void subdivision_barycentric(Tetmesh<M,V,E,F,P> & m, const uint n_levels)
 {
-    std::unordered_map<uint,uint> e_map,f_map,p_map; // edge midpoints,face centroids,poly centroids
-   
-    for(uint eid=0; eid<m.num_edges(); ++eid) e_map[eid] = m.vert_add(m.edge_sample_at(eid,0.5));
-    for(uint fid=0; fid<m.num_faces(); ++fid) f_map[fid] = m.vert_add(m.face_centroid(fid));
-    for(uint pid=0; pid<m.num_polys(); ++pid) p_map[pid] = m.vert_add(m.poly_centroid(pid));
-
-    uint np = m.num_polys();
-    for(uint pid=0; pid<np; ++pid)
+    for(uint l=0; l<n_levels; ++l)
     {
-        // tet verts
-        uint v[4] =
-        {
-            m.poly_vert_id(pid,0),
-            m.poly_vert_id(pid,1),
-            m.poly_vert_id(pid,2),
-            m.poly_vert_id(pid,3),
-        };
+        m.adjacency_require(ADJ_ALL);
+        uint nv = m.num_verts();
+        uint ne = m.num_edges();
+        uint nf = m.num_faces();
+        uint np = m.num_polys();
 
-        // tet faces
-        uint f[4][3] =
-        {
-            { v[TET_FACES[0][0]], v[TET_FACES[0][1]], v[TET_FACES[0][2]] },
-            { v[TET_FACES[1][0]], v[TET_FACES[1][1]], v[TET_FACES[1][2]] },
-            { v[TET_FACES[2][0]], v[TET_FACES[2][1]], v[TET_FACES[2][2]] },
-            { v[TET_FACES[3][0]], v[TET_FACES[3][1]], v[TET_FACES[3][2]] },
-        };
+        // edge midpoints (nv+eid), face centroids (nv+ne+fid), poly centroids (nv+ne+nf+pid)
+        std::vector<vec3d> new_verts(ne+nf+np);
+        PARALLEL_FOR(0, ne, 10000, [&](const uint eid) { new_verts.at(eid)       = m.edge_sample_at(eid,0.5); });
+        PARALLEL_FOR(0, nf, 10000, [&](const uint fid) { new_verts.at(ne+fid)    = m.face_centroid(fid);      });
+        PARALLEL_FOR(0, np, 10000, [&](const uint pid) { new_verts.at(ne+nf+pid) = m.poly_centroid(pid);      });
 
-        // tet edges (sorted per face)
-        uint e[4][3] =
+        std::vector<std::vector<uint>> tets(24*np);
+        std::vector<int>               tets_src(24*np);
+        PARALLEL_FOR(0, np, 1000, [&](const uint pid)
         {
-            { e_map.at(m.edge_id(f[0][0], f[0][1])),
-              e_map.at(m.edge_id(f[0][1], f[0][2])),
-              e_map.at(m.edge_id(f[0][2], f[0][0])) },
+            // tet verts
+            uint v[4] =
+            {
+                m.poly_vert_id(pid,0),
+                m.poly_vert_id(pid,1),
+                m.poly_vert_id(pid,2),
+                m.poly_vert_id(pid,3),
+            };
 
-            { e_map.at(m.edge_id(f[1][0], f[1][1])),
-              e_map.at(m.edge_id(f[1][1], f[1][2])),
-              e_map.at(m.edge_id(f[1][2], f[1][0])) },
+            // tet centroid
+            uint c = nv + ne + nf + pid;
 
-            { e_map.at(m.edge_id(f[2][0], f[2][1])),
-              e_map.at(m.edge_id(f[2][1], f[2][2])),
-              e_map.at(m.edge_id(f[2][2], f[2][0])) },
+            for(uint i=0; i<4; ++i)
+            {
+                // i^th face (oriented outwards)
+                uint f[3] = { v[TET_FACES[i][0]], v[TET_FACES[i][1]], v[TET_FACES[i][2]] };
 
-            { e_map.at(m.edge_id(f[3][0], f[3][1])),
-              e_map.at(m.edge_id(f[3][1], f[3][2])),
-              e_map.at(m.edge_id(f[3][2], f[3][0])) }
-        };
+                // edge midpoints (sorted along the face)
+                uint e[3] =
+                {
+                    nv + m.poly_edge_id(pid, f[0], f[1]),
+                    nv + m.poly_edge_id(pid, f[1], f[2]),
+                    nv + m.poly_edge_id(pid, f[2], f[0])
+                };
 
-        // face centroids
-        uint fc[4] =
-        {
-            f_map.at(m.face_id({f[0][0], f[0][1], f[0][2]})),
-            f_map.at(m.face_id({f[1][0], f[1][1], f[1][2]})),
-            f_map.at(m.face_id({f[2][0], f[2][1], f[2][2]})),
-            f_map.at(m.face_id({f[3][0], f[3][1], f[3][2]}))
-        };
+                // face centroid (the face of the tet not containing the opposite vertex)
+                uint opp = v[6 - TET_FACES[i][0] - TET_FACES[i][1] - TET_FACES[i][2]];
+                uint fc  = 0;
+                for(uint fid : m.adj_p2f(pid)) if(!m.face_contains_vert(fid,opp)) fc = nv + ne + fid;
 
-        // tet centroid
-        uint c = p_map.at(pid);
+                // split i^th face
+                std::vector<uint> * t = &tets.at(24*pid + 6*i);
+                t[0] = {c, f[0], e[0], fc};
+                t[1] = {c, e[0], f[1], fc};
+                t[2] = {c, f[1], e[1], fc};
+                t[3] = {c, e[1], f[2], fc};
+                t[4] = {c, f[2], e[2], fc};
+                t[5] = {c, e[2], f[0], fc};
+            }
+            for(uint i=0; i<24; ++i) tets_src.at(24*pid+i) = pid;
+        });
 
-        for(short i=0; i<4; ++i)
-        {
-            // split i^th face
-            m.poly_add({c, f[i][0], e[i][0], fc[i]});
-            m.poly_add({c, e[i][0], f[i][1], fc[i]});
-            m.poly_add({c, f[i][1], e[i][1], fc[i]});
-            m.poly_add({c, e[i][1], f[i][2], fc[i]});
-            m.poly_add({c, f[i][2], e[i][2], fc[i]});
-            m.poly_add({c, e[i][2], f[i][0], fc[i]});
-        }
+        // replace the old polys with the new ones
+        for(const vec3d & p : new_verts) m.vert_add(p);
+        MeshIdMaps id_maps;
+        m.polys_rebuild(tets, tets_src, {}, {}, {}, {}, id_maps);
     }
-
-    // remove the old polys
-    for(int pid=np-1; pid>=0; --pid) m.poly_remove(pid);
 }
 }
@@ -43,11 +43,16 @@ namespace cinolib
 
 /* Implementation of barycentric subdivision for simplicial complexes of dimension 3.
  * See also: https://en.wikipedia.org/wiki/Barycentric_subdivision
+ *
+ * Each tetrahedron is split into 24 sub tetrahedra, which inherit its attributes.
+ * New vertices are indexed arithmetically (edge midpoints first, then face and
+ * poly centroids), sub elements are generated in parallel and the connectivity
+ * is rebuilt in one go. n_levels subdivision steps are applied in a single call
 */
 
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
-void subdivision_barycentric(Tetmesh<M,V,E,F,P> & m);
+void subdivision_barycentric(Tetmesh<M,V,E,F,P> & m, const uint n_levels = 1);
 
 }
 
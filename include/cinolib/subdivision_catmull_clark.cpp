@@ -0,0 +1,189 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/subdivision_catmull_clark.h>
+#include <cinolib/parallel_for.h>
+
+namespace cinolib
+{
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void subdivision_catmull_clark(const AbstractPolygonMesh<M,V,E,P> & m_in,
+                                     Quadmesh<M,V,E,P>            & m_out,
+                               const uint                           n_levels)
+{
+    assert((void*)&m_in != (void*)&m_out);
+    if(n_levels==0)
+    {
+        // nothing to subdivide: m_out becomes a copy of m_in, which must be a
+        // quad mesh. Quadmesh adds no members to AbstractPolygonMesh, hence
+        // copying the base copies everything (attributes and layers included)
+        for(uint pid=0; pid<m_in.num_polys(); ++pid) assert(m_in.verts_per_poly(pid)==4);
+        static_cast<AbstractPolygonMesh<M,V,E,P>&>(m_out) = m_in;
+        return;
+    }
+
+    // after the first level the mesh is made of quads only, hence levels
+    // alternate between m_out and a temporary quadmesh, in such a way that
+    // the last one is always written on m_out
+    Quadmesh<M,V,E,P> tmp;
+    const AbstractPolygonMesh<M,V,E,P> * src = &m_in;
+    for(uint l=0; l<n_levels; ++l)
+    {
+        Quadmesh<M,V,E,P> & dst = ((n_levels-1-l)%2==0) ? m_out : tmp;
+        subdivision_catmull_clark_single_level(*src, dst);
+        src = &dst;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void subdivision_catmull_clark_single_level(const AbstractPolygonMesh<M,V,E,P> & m_in,
+                                                  Quadmesh<M,V,E,P>            & m_out)
+{
+    assert((void*)&m_in != (void*)&m_out);
+    m_in.adjacency_require(ADJ_ALL); // soups: complete the mesh before the parallel steps
+
+    uint nv = m_in.num_verts();
+    uint ne = m_in.num_edges();
+    uint np = m_in.num_polys();
+
+    auto is_crease = [&](const uint eid)
+    {
+        return m_in.edge_is_boundary(eid) || !m_in.edge_is_manifold(eid);
+    };
+
+    // 1) face points
+    //
+    std::vector<vec3d> verts(nv+ne+np);
+    PARALLEL_FOR(0, np, 10000, [&](const uint pid)
+    {
+        verts.at(nv+ne+pid) = m_in.poly_centroid(pid);
+    });
+
+    // 2) edge points: crease edges are split at their midpoint
+    //
+    PARALLEL_FOR(0, ne, 10000, [&](const uint eid)
+    {
+        if(is_crease(eid))
+        {
+            verts.at(nv+eid) = m_in.edge_sample_at(eid,0.5);
+        }
+        else
+        {
+            vec3d p = m_in.edge_vert(eid,0) + m_in.edge_vert(eid,1);
+            for(uint pid : m_in.adj_e2p(eid)) p += verts.at(nv+ne+pid);
+            verts.at(nv+eid) = p * 0.25;
+        }
+    });
+
+    // 3) vertex points: crease vertices only depend on their two crease
+    //    neighbors (corners stay in place), the others are (F + 2R + (n-3)P)/n,
+    //    where F is the average of the incident face points and R is the
+    //    average of the incident edge midpoints
+    //
+    PARALLEL_FOR(0, nv, 10000, [&](const uint vid)
+    {
+        std::vector<uint> crease_nbrs;
+        for(uint eid : m_in.adj_v2e(vid)) if(is_crease(eid)) crease_nbrs.push_back(m_in.vert_opposite_to(eid,vid));
+
+        if(crease_nbrs.empty())
+        {
+            vec3d F(0,0,0), R(0,0,0);
+            for(uint pid : m_in.adj_v2p(vid)) F += verts.at(nv+ne+pid);
+            for(uint eid : m_in.adj_v2e(vid)) R += m_in.edge_sample_at(eid,0.5);
+            F /= static_cast<double>(m_in.adj_v2p(vid).size());
+            R /= static_cast<double>(m_in.adj_v2e(vid).size());
+            double n = m_in.adj_v2e(vid).size();
+            verts.at(vid) = (F + 2.0*R + (n-3.0)*m_in.vert(vid)) / n;
+        }
+        else if(crease_nbrs.size()==2)
+        {
+            verts.at(vid) = 0.75  *  m_in.vert(vid) +
+                            0.125 * (m_in.vert(crease_nbrs.front()) + m_in.vert(crease_nbrs.back()));
+        }
+        else verts.at(vid) = m_in.vert(vid);
+    });
+
+    // 4) split each polygon into one quad per vertex
+    //
+    std::vector<uint> p_off(np+1,0);
+    for(uint pid=0; pid<np; ++pid) p_off.at(pid+1) = p_off.at(pid) + m_in.verts_per_poly(pid);
+
+    std::vector<std::vector<uint>> quads(p_off.back());
+    PARALLEL_FOR(0, np, 10000, [&](const uint pid)
+    {
+        const std::vector<uint> & p = m_in.adj_p2v(pid);
+        for(uint i=0; i<p.size(); ++i)
+        {
+            uint prev = (i>0) ? p.at(i-1) : p.back();
+            uint next = p.at((i+1)%p.size());
+            quads.at(p_off.at(pid)+i) =
+            {
+                p.at(i),
+                nv + m_in.poly_edge_id(pid, p.at(i), next),
+                nv + ne + pid,
+                nv + m_in.poly_edge_id(pid, prev, p.at(i))
+            };
+        }
+    });
+
+    // 5) build the output mesh in one go, inheriting the attributes
+    //    of the original elements
+    //
+    m_out.clear();
+    for(const vec3d & p : verts) m_out.vert_add(p);
+    for(uint vid=0; vid<nv; ++vid) m_out.vert_data(vid) = m_in.vert_data(vid);
+    MeshIdMaps id_maps;
+    m_out.polys_rebuild(quads, std::vector<int>(quads.size(),-1), {}, {}, {}, id_maps);
+    assert(m_out.num_polys()==p_off.back());
+    for(uint pid=0; pid<np; ++pid)
+    for(uint i=p_off.at(pid); i<p_off.at(pid+1); ++i) m_out.poly_data(i) = m_in.poly_data(pid);
+    for(uint eid=0; eid<ne; ++eid)
+    {
+        uint vid = id_maps.v_map.at(nv+eid);
+        for(uint i=0; i<2; ++i)
+        {
+            int e = m_out.edge_id(id_maps.v_map.at(m_in.edge_vert_id(eid,i)), vid);
+            if(e>=0) m_out.edge_data(e) = m_in.edge_data(eid);
+        }
+    }
+    m_out.copy_xyz_to_uvw(UVW_param);
+}
+
+}
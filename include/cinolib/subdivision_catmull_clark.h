@@ -0,0 +1,79 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_SUBDIVISION_CATMULL_CLARK_H
+#define CINO_SUBDIVISION_CATMULL_CLARK_H
+
+#include <cinolib/meshes/abstract_polygonmesh.h>
+#include <cinolib/meshes/quadmesh.h>
+
+namespace cinolib
+{
+
+/* This method implements Catmull-Clark subdivision for general polygon meshes, as described in:
+ *
+ * Recursively Generated B-Spline Surfaces on Arbitrary Topological Meshes
+ * E. Catmull, J. Clark
+ * Computer-Aided Design, 1978
+ *
+ * Boundary and non manifold edges are treated as creases. The midpoint of
+ * edge eid has id nv+eid and the centroid of poly pid has id nv+ne+pid.
+ * Each poly is split into one quad per vertex, which inherits its attributes.
+ * Elements are generated in parallel and the output connectivity is built
+ * in one go.
+ *
+ * n_levels subdivision steps are applied in a single call. If n_levels is zero
+ * m_out is a copy of m_in (which in this case must contain quads only)
+*/
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void subdivision_catmull_clark(const AbstractPolygonMesh<M,V,E,P> & m_in,
+                                     Quadmesh<M,V,E,P>            & m_out,
+                               const uint                           n_levels = 1);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void subdivision_catmull_clark_single_level(const AbstractPolygonMesh<M,V,E,P> & m_in,
+                                                  Quadmesh<M,V,E,P>            & m_out);
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "subdivision_catmull_clark.cpp"
+#endif
+
+#endif // CINO_SUBDIVISION_CATMULL_CLARK_H
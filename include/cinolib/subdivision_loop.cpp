@@ -0,0 +1,168 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/subdivision_loop.h>
+#include <cinolib/parallel_for.h>
+
+namespace cinolib
+{
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void subdivision_loop(const Trimesh<M,V,E,P> & m_in,
+                            Trimesh<M,V,E,P> & m_out,
+                      const uint               n_levels)
+{
+    assert(&m_in != &m_out);
+    if(n_levels==0) { m_out = m_in; return; }
+
+    // levels alternate between m_out and a temporary mesh, in such
+    // a way that the last one is always written on m_out
+    Trimesh<M,V,E,P> tmp;
+    const Trimesh<M,V,E,P> * src = &m_in;
+    for(uint l=0; l<n_levels; ++l)
+    {
+        Trimesh<M,V,E,P> & dst = ((n_levels-1-l)%2==0) ? m_out : tmp;
+        subdivision_loop_single_level(*src, dst);
+        src = &dst;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void subdivision_loop_single_level(const Trimesh<M,V,E,P> & m_in,
+                                         Trimesh<M,V,E,P> & m_out)
+{
+    assert(&m_in != &m_out);
+    m_in.adjacency_require(ADJ_ALL); // all elements are generated in parallel
+
+    uint nv = m_in.num_verts();
+    uint ne = m_in.num_edges();
+    uint np = m_in.num_polys();
+
+    auto is_crease = [&](const uint eid)
+    {
+        return m_in.edge_is_boundary(eid) || !m_in.edge_is_manifold(eid);
+    };
+
+    // 1) vertex points: crease vertices only depend on their two crease
+    //    neighbors (corners stay in place), the others on their one ring
+    //
+    std::vector<vec3d> verts(nv+ne);
+    PARALLEL_FOR(0, nv, 10000, [&](const uint vid)
+    {
+        std::vector<uint> crease_nbrs;
+        for(uint eid : m_in.adj_v2e(vid)) if(is_crease(eid)) crease_nbrs.push_back(m_in.vert_opposite_to(eid,vid));
+
+        if(crease_nbrs.empty())
+        {
+            uint   n    = m_in.vert_valence(vid);
+            double beta = (n==3) ? 3.0/16.0 : 3.0/(8.0*n);
+            vec3d  p    = (1.0 - n*beta) * m_in.vert(vid);
+            for(uint nbr : m_in.adj_v2v(vid)) p += beta * m_in.vert(nbr);
+            verts.at(vid) = p;
+        }
+        else if(crease_nbrs.size()==2)
+        {
+            verts.at(vid) = 0.75  *  m_in.vert(vid) +
+                            0.125 * (m_in.vert(crease_nbrs.front()) + m_in.vert(crease_nbrs.back()));
+        }
+        else verts.at(vid) = m_in.vert(vid);
+    });
+
+    // 2) edge points: crease edges are split at their midpoint
+    //
+    PARALLEL_FOR(0, ne, 10000, [&](const uint eid)
+    {
+        if(is_crease(eid))
+        {
+            verts.at(nv+eid) = m_in.edge_sample_at(eid,0.5);
+        }
+        else
+        {
+            std::vector<uint> opp = m_in.verts_opposite_to(eid);
+            verts.at(nv+eid) = 0.375 * (m_in.edge_vert(eid,0) + m_in.edge_vert(eid,1)) +
+                               0.125 * (m_in.vert(opp.front()) + m_in.vert(opp.back()));
+        }
+    });
+
+    // 3) split each triangle into four
+    //
+    std::vector<std::vector<uint>> tris(4*np);
+    PARALLEL_FOR(0, np, 10000, [&](const uint pid)
+    {
+        uint v[3] =
+        {
+            m_in.poly_vert_id(pid,0),
+            m_in.poly_vert_id(pid,1),
+            m_in.poly_vert_id(pid,2)
+        };
+        uint e[3] =
+        {
+            nv + m_in.poly_edge_id(pid, v[0], v[1]),
+            nv + m_in.poly_edge_id(pid, v[1], v[2]),
+            nv + m_in.poly_edge_id(pid, v[2], v[0])
+        };
+        tris.at(4*pid  ) = { v[0], e[0], e[2] };
+        tris.at(4*pid+1) = { v[1], e[1], e[0] };
+        tris.at(4*pid+2) = { v[2], e[2], e[1] };
+        tris.at(4*pid+3) = { e[0], e[1], e[2] };
+    });
+
+    // 4) build the output mesh in one go, inheriting the attributes
+    //    of the original elements
+    //
+    m_out.clear();
+    for(const vec3d & p : verts) m_out.vert_add(p);
+    for(uint vid=0; vid<nv; ++vid) m_out.vert_data(vid) = m_in.vert_data(vid);
+    MeshIdMaps id_maps;
+    m_out.polys_rebuild(tris, std::vector<int>(tris.size(),-1), {}, {}, {}, id_maps);
+    assert(m_out.num_polys()==4*np);
+    for(uint pid=0; pid<m_out.num_polys(); ++pid) m_out.poly_data(pid) = m_in.poly_data(pid/4);
+    for(uint eid=0; eid<ne; ++eid)
+    {
+        uint vid = id_maps.v_map.at(nv+eid);
+        for(uint i=0; i<2; ++i)
+        {
+            int e = m_out.edge_id(id_maps.v_map.at(m_in.edge_vert_id(eid,i)), vid);
+            if(e>=0) m_out.edge_data(e) = m_in.edge_data(eid);
+        }
+    }
+    m_out.copy_xyz_to_uvw(UVW_param);
+}
+
+}
@@ -34,8 +34,8 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/subdivision_midpoint.h>
-#include <cinolib/sort_poly_vertices.h>
-#include <map>
+#include <cinolib/standard_elements_tables.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
@@ -43,10 +43,25 @@ namespace cinolib
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void subdivision_midpoint(const AbstractPolyhedralMesh<M,V,E,F,P> & m_in,
-                                AbstractPolyhedralMesh<M,V,E,F,P> & m_out)
+                                AbstractPolyhedralMesh<M,V,E,F,P> & m_out,
+                          const uint                                n_levels)
 {
-    std::unordered_map<uint,uint> edge_verts,face_verts,poly_verts;
-    subdivision_midpoint(m_in, m_out, edge_verts, face_verts, poly_verts);
+    assert(&m_in != &m_out);
+    if(n_levels==0) { m_out = m_in; return; }
+
+    // levels alternate between m_out and a temporary mesh, in such
+    // a way that the last one is always written on m_out
+    Hexmesh<M,V,E,F,P>        tmp_hex;
+    Polyhedralmesh<M,V,E,F,P> tmp_poly;
+    AbstractPolyhedralMesh<M,V,E,F,P> & tmp = (m_in.mesh_type()==POLYHEDRALMESH) ? (AbstractPolyhedralMesh<M,V,E,F,P>&)tmp_poly
+                                                                                  : (AbstractPolyhedralMesh<M,V,E,F,P>&)tmp_hex;
+    const AbstractPolyhedralMesh<M,V,E,F,P> * src = &m_in;
+    for(uint l=0; l<n_levels; ++l)
+    {
+        AbstractPolyhedralMesh<M,V,E,F,P> & dst = ((n_levels-1-l)%2==0) ? m_out : tmp;
+        subdivision_midpoint_single_level(*src, dst);
+        src = &dst;
+    }
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -59,96 +74,211 @@ void subdivision_midpoint(const AbstractPolyhedralMesh<M,V,E,F,P> & m_in,
                                 std::unordered_map<uint,uint>     & face_verts,
                                 std::unordered_map<uint,uint>     & poly_verts)
 {
+    subdivision_midpoint_single_level(m_in, m_out);
+
+    uint nv = m_in.num_verts();
+    uint ne = m_in.num_edges();
+    uint nf = m_in.num_faces();
     edge_verts.clear();
     face_verts.clear();
     poly_verts.clear();
+    edge_verts.reserve(ne);
+    face_verts.reserve(nf);
+    poly_verts.reserve(m_in.num_polys());
+    for(uint eid=0; eid<ne;                ++eid) edge_verts[eid] = nv + eid;
+    for(uint fid=0; fid<nf;                ++fid) face_verts[fid] = nv + ne + fid;
+    for(uint pid=0; pid<m_in.num_polys(); ++pid) poly_verts[pid] = nv + ne + nf + pid;
+}
 
-    std::vector<vec3d> verts = m_in.vector_verts();
-    std::vector<std::vector<uint>> faces,polys;
-    std::vector<std::vector<bool>> polys_winding;
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void subdivision_midpoint_single_level(const AbstractPolyhedralMesh<M,V,E,F,P> & m_in,
+                                             AbstractPolyhedralMesh<M,V,E,F,P> & m_out)
+{
+    assert(&m_in != &m_out);
+    m_in.adjacency_require(ADJ_ALL); // m_in is only read from here on, also by parallel loops
+
+    uint nv = m_in.num_verts();
+    uint ne = m_in.num_edges();
+    uint nf = m_in.num_faces();
+    uint np = m_in.num_polys();
 
     // 1) add one new vert for each edge/face/poly
     //
-    for(uint eid=0; eid<m_in.num_edges(); ++eid) { edge_verts[eid] = verts.size(); verts.push_back(m_in.edge_sample_at(eid,0.5)); }
-    for(uint fid=0; fid<m_in.num_faces(); ++fid) { face_verts[fid] = verts.size(); verts.push_back(m_in.face_centroid(fid)); }
-    for(uint pid=0; pid<m_in.num_polys(); ++pid) { poly_verts[pid] = verts.size(); verts.push_back(m_in.poly_centroid(pid)); }
-
-    // 2) for each pair (edge,poly), make a quad with:
-    //      - poly centroid
-    //      - incident face centroids
-    //      - edge midpoint
-    //
-    std::map<ipair,uint> eid_pid_fmap;
-    for(uint pid=0; pid<m_in.num_polys(); ++pid)
-    for(uint eid : m_in.adj_p2e(pid))
-    {
-        std::vector<uint> inc_f = m_in.poly_e2f(pid,eid),f;
-        f.push_back(poly_verts.at(pid));
-        f.push_back(face_verts.at(inc_f.front()));
-        f.push_back(edge_verts.at(eid));
-        f.push_back(face_verts.at(inc_f.back()));
-        eid_pid_fmap[std::make_pair(eid,pid)] = faces.size();
-        faces.push_back(f);
-    }
+    std::vector<vec3d> verts = m_in.vector_verts();
+    verts.resize(nv+ne+nf+np);
+    PARALLEL_FOR(0, ne, 10000, [&](const uint eid) { verts.at(nv+eid)       = m_in.edge_sample_at(eid,0.5); });
+    PARALLEL_FOR(0, nf, 10000, [&](const uint fid) { verts.at(nv+ne+fid)    = m_in.face_centroid(fid);      });
+    PARALLEL_FOR(0, np, 10000, [&](const uint pid) { verts.at(nv+ne+nf+pid) = m_in.poly_centroid(pid);      });
 
-    // 3) for each pair (vert,face), make a quad with:
-    //      - poly centroid
-    //      - incident face centroids
-    //      - edge midpoint
-    //
-    std::map<ipair,uint> vid_fid_fmap;
-    for(uint fid = 0; fid<m_in.num_faces(); ++fid)
-    for(uint vid : m_in.adj_f2v(fid))
-    {
-        std::vector<uint> e = m_in.face_v2e(fid,vid),f;
-        f.push_back(face_verts.at(fid));
-        f.push_back(edge_verts.at(e.front()));
-        f.push_back(vid);
-        f.push_back(edge_verts.at(e.back()));
-        vid_fid_fmap[std::make_pair(vid,fid)] = faces.size();
-        faces.push_back(f);
-    }
+    // one new poly for each vertex of each poly
+    std::vector<uint> p_off(np+1,0);
+    for(uint pid=0; pid<np; ++pid) p_off.at(pid+1) = p_off.at(pid) + m_in.verts_per_poly(pid);
 
-    // 4) for each vertex of each poly, make a new polyhedron
-    //    using the faces created at steps (2) and (3)
-    //
-    for(uint pid = 0; pid<m_in.num_polys(); ++pid)
+    switch(m_in.mesh_type())
     {
-        for(uint vid : m_in.adj_p2v(pid))
+        case TETMESH :
+        case HEXMESH :
         {
-            std::vector<uint> f;
-            std::vector<bool> w;
-            for(uint fid : m_in.poly_v2f(pid,vid))
-            {
-                f.push_back(vid_fid_fmap.at(std::make_pair(vid,fid)));                                
-                // TODO: fix winding order
-                w.push_back(true);
-            }
-            for(uint eid : m_in.poly_v2e(pid,vid))
+            // 2) for each corner of each element, make a hexahedron with the corner itself,
+            //    the midpoints of its edges, the centroids of its faces and the element centroid.
+            //    Taking the adjacent corners in right handed order yields a standard hexahedron
+            //
+            std::vector<std::vector<uint>> hexas(p_off.back());
+            std::vector<uint>              hexas_src(p_off.back());
+            PARALLEL_FOR(0, np, 1000, [&](const uint pid)
             {
-                f.push_back(eid_pid_fmap.at(std::make_pair(eid,pid)));
-                // TODO: check on what side the vertex stays w.r.t. oriented plane to assign correct winding
-                w.push_back(true);
-            }
-            polys.push_back(f);
-            polys_winding.push_back(w);
+                // local edges/faces are identified by the bitmask of their local vertices
+                auto local_mask = [&](const std::vector<uint> & vids)
+                {
+                    uint mask = 0;
+                    for(uint vid : vids) mask |= 1 << m_in.poly_vert_offset(pid,vid);
+                    return mask;
+                };
+                std::vector<ipair> e_masks, f_masks;
+                for(uint eid : m_in.adj_p2e(pid)) e_masks.push_back(std::make_pair(local_mask(m_in.adj_e2v(eid)),eid));
+                for(uint fid : m_in.adj_p2f(pid)) f_masks.push_back(std::make_pair(local_mask(m_in.adj_f2v(fid)),fid));
+                auto e_vert = [&](const uint i, const uint j) -> uint
+                {
+                    uint mask = (1<<i) | (1<<j);
+                    for(auto e : e_masks) if(e.first==mask) return nv + e.second;
+                    assert(false);
+                    return 0;
+                };
+                auto f_vert = [&](const uint i, const uint j, const uint k) -> uint
+                {
+                    uint mask = (1<<i) | (1<<j) | (1<<k);
+                    for(auto f : f_masks) if((f.first & mask)==mask) return nv + ne + f.second;
+                    assert(false);
+                    return 0;
+                };
+
+                bool is_tet = (m_in.verts_per_poly(pid)==4);
+                assert(is_tet || m_in.verts_per_poly(pid)==8);
+                uint C = nv + ne + nf + pid;
+                for(uint k=0; k<m_in.verts_per_poly(pid); ++k)
+                {
+                    const uint * c = (is_tet) ? TET_CORNERS[k] : HEXA_CORNERS[k];
+                    hexas.at(p_off.at(pid)+k) =
+                    {
+                        m_in.poly_vert_id(pid,k),
+                        e_vert(k,c[0]),
+                        f_vert(k,c[0],c[1]),
+                        e_vert(k,c[1]),
+                        e_vert(k,c[2]),
+                        f_vert(k,c[0],c[2]),
+                        C,
+                        f_vert(k,c[1],c[2])
+                    };
+                    hexas_src.at(p_off.at(pid)+k) = pid;
+                }
+            });
+
+            // 3) build the output mesh in one go, inheriting element attributes
+            //
+            m_out.clear();
+            for(const vec3d & p : verts) m_out.vert_add(p);
+            for(uint vid=0; vid<nv; ++vid) m_out.vert_data(vid) = m_in.vert_data(vid);
+            MeshIdMaps id_maps;
+            m_out.polys_rebuild(hexas, std::vector<int>(hexas_src.size(),-1), {}, {}, {}, {}, id_maps);
+            for(uint pid=0; pid<m_out.num_polys(); ++pid) m_out.poly_data(pid) = m_in.poly_data(hexas_src.at(pid));
+            m_out.copy_xyz_to_uvw(UVW_param);
+            break;
         }
-    }
 
-    switch(m_in.mesh_type())
-    {
-        case TETMESH :
-        case HEXMESH :
+        case POLYHEDRALMESH :
         {
-            std::vector<std::vector<uint>> hexas;
-            sort_poly_vertices_as_hexa(faces, polys, polys_winding, hexas);
-            m_out = Hexmesh<M,V,E,F,P>(verts, hexas);
+            // 2) for each pair (edge,poly), make a quad with:
+            //      - poly centroid
+            //      - incident face centroids
+            //      - edge midpoint
+            //    quads of poly pid are stored contiguously, in the order of adj_p2e(pid)
+            //
+            std::vector<uint> e_off(np+1,0);
+            for(uint pid=0; pid<np; ++pid) e_off.at(pid+1) = e_off.at(pid) + m_in.adj_p2e(pid).size();
+
+            // 3) for each pair (vert,face), make a quad with:
+            //      - face centroid
+            //      - incident edge midpoints
+            //      - the vertex itself
+            //    quads of face fid are stored contiguously, in the order of adj_f2v(fid)
+            //
+            std::vector<uint> v_off(nf+1,e_off.back());
+            for(uint fid=0; fid<nf; ++fid) v_off.at(fid+1) = v_off.at(fid) + m_in.verts_per_face(fid);
+
+            std::vector<std::vector<uint>> faces(v_off.back());
+            PARALLEL_FOR(0, nf, 10000, [&](const uint fid)
+            {
+                const std::vector<uint> & f = m_in.adj_f2v(fid);
+                for(uint i=0; i<f.size(); ++i)
+                {
+                    uint prev = (i>0) ? f.at(i-1) : f.back();
+                    uint next = f.at((i+1)%f.size());
+                    faces.at(v_off.at(fid)+i) =
+                    {
+                        nv + ne + fid,
+                        nv + m_in.edge_id(prev,f.at(i)),
+                        f.at(i),
+                        nv + m_in.edge_id(f.at(i),next)
+                    };
+                }
+            });
+
+            // 4) for each vertex of each poly, make a new polyhedron
+            //    using the faces created at steps (2) and (3). Quads
+            //    of type (3) have the same winding of the face they
+            //    split, while each quad of type (2) is oriented so
+            //    that its normal points from one endpoint of its
+            //    edge to the other
+            //
+            std::vector<std::vector<uint>> polys(p_off.back());
+            std::vector<std::vector<bool>> polys_winding(p_off.back());
+            PARALLEL_FOR(0, np, 1000, [&](const uint pid)
+            {
+                const std::vector<uint> & p2e = m_in.adj_p2e(pid);
+                for(uint i=0; i<p2e.size(); ++i)
+                {
+                    uint eid = p2e.at(i);
+                    uint v0  = m_in.edge_vert_id(eid,0);
+                    uint v1  = m_in.edge_vert_id(eid,1);
+                    std::vector<uint> e2f = m_in.poly_e2f(pid,eid);
+                    assert(e2f.size()==2);
+                    // let f0 be the face that (looking from outside) goes from v0 to v1
+                    uint f0 = e2f.front();
+                    uint f1 = e2f.back();
+                    uint off = m_in.face_vert_offset(f0,v0);
+                    bool v0_to_v1 = (m_in.face_vert_id(f0,(off+1)%m_in.verts_per_face(f0))==v1);
+                    if(v0_to_v1 != m_in.poly_face_is_CCW(pid,f0)) std::swap(f0,f1);
+                    faces.at(e_off.at(pid)+i) = { nv+ne+nf+pid, nv+ne+f0, nv+eid, nv+ne+f1 };
+                    // the quad normal points towards v1
+                    uint p0 = p_off.at(pid) + m_in.poly_vert_offset(pid,v0);
+                    uint p1 = p_off.at(pid) + m_in.poly_vert_offset(pid,v1);
+                    polys.at(p0).push_back(e_off.at(pid)+i); polys_winding.at(p0).push_back(true);
+                    polys.at(p1).push_back(e_off.at(pid)+i); polys_winding.at(p1).push_back(false);
+                }
+                for(uint fid : m_in.adj_p2f(pid))
+                {
+                    bool CCW = m_in.poly_face_is_CCW(pid,fid);
+                    const std::vector<uint> & f = m_in.adj_f2v(fid);
+                    for(uint i=0; i<f.size(); ++i)
+                    {
+                        uint pi = p_off.at(pid) + m_in.poly_vert_offset(pid,f.at(i));
+                        polys.at(pi).push_back(v_off.at(fid)+i);
+                        polys_winding.at(pi).push_back(CCW);
+                    }
+                }
+            });
+
+            m_out = Polyhedralmesh<M,V,E,F,P>(verts, faces, polys, polys_winding);
+            for(uint pid=0; pid<np; ++pid)
+            for(uint i=p_off.at(pid); i<p_off.at(pid+1); ++i) m_out.poly_data(i) = m_in.poly_data(pid);
             break;
         }
-        case POLYHEDRALMESH : m_out = Polyhedralmesh<M,V,E,F,P>(verts, faces, polys, polys_winding);
-                              break;
 
         default : assert(false);
     }
 }
+
 }
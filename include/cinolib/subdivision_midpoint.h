@@ -37,6 +37,7 @@
 #define CINO_SUBDIVISION_MIDPOINT_H
 
 #include <cinolib/meshes/meshes.h>
+#include <unordered_map>
 
 namespace cinolib
 {
@@ -46,22 +47,43 @@ namespace cinolib
  * Hexahedral Meshing Using Midpoint Subdivision and Integer Programming
  * T.S. Li, R.M. McKeag, C.G. Armstrong
  * Computer Methods in Applied Mechanics and Engineering, 1995
+ *
+ * New vertices are indexed arithmetically: the midpoint of edge eid has
+ * id nv+eid, the centroid of face fid has id nv+ne+fid, and the centroid
+ * of poly pid has id nv+ne+nf+pid. Tetrahedral and hexahedral meshes are
+ * refined into a hexmesh, generating all the elements in parallel and
+ * building the output connectivity in one go. General polyhedral meshes
+ * are refined into polyhedral meshes. Each new poly inherits the
+ * attributes of the poly it was generated from.
+ *
+ * n_levels subdivision steps are applied in a single call
 */
 
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void subdivision_midpoint(const AbstractPolyhedralMesh<M,V,E,F,P> & m_in,
-                                AbstractPolyhedralMesh<M,V,E,F,P> & m_out);
+                                AbstractPolyhedralMesh<M,V,E,F,P> & m_out,
+                          const uint                                n_levels = 1);
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// single subdivision step. The maps link each edge/face/poly of m_in to
+// the vertex of m_out that was generated from it
+//
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void subdivision_midpoint(const AbstractPolyhedralMesh<M,V,E,F,P> & m_in,
                                 AbstractPolyhedralMesh<M,V,E,F,P> & m_out,
-                                std::map<uint,uint>               & edge_verts,
-                                std::map<uint,uint>               & face_verts,
-                                std::map<uint,uint>               & poly_verts);
+                                std::unordered_map<uint,uint>     & edge_verts,
+                                std::unordered_map<uint,uint>     & face_verts,
+                                std::unordered_map<uint,uint>     & poly_verts);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void subdivision_midpoint_single_level(const AbstractPolyhedralMesh<M,V,E,F,P> & m_in,
+                                             AbstractPolyhedralMesh<M,V,E,F,P> & m_out);
 }
 
 #ifndef  CINO_STATIC_LIB
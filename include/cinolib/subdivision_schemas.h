@@ -38,6 +38,8 @@
 
 #include <cinolib/subdivision_midpoint.h>
 #include <cinolib/subdivision_barycentric.h>
+#include <cinolib/subdivision_loop.h>
+#include <cinolib/subdivision_catmull_clark.h>
 #include <cinolib/subdivision_legacy_hexa_schemes.h>
 
 #endif // CINO_SUBDIVISION_SCHEMAS_H
@@ -0,0 +1,112 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/union_find.h>
+#include <cinolib/parallel_for.h>
+
+namespace cinolib
+{
+
+CINO_INLINE
+uint union_find_root(std::vector<std::atomic<uint>> & parent, uint id)
+{
+    // parents always have smaller ids than their children. This allows
+    // to shortcut paths while other threads are merging sets
+    for(;;)
+    {
+        uint p = parent[id].load();
+        if(p==id) return id;
+        uint gp = parent[p].load();
+        if(p!=gp) parent[id].compare_exchange_weak(p,gp); // path halving
+        id = gp;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void union_find_merge(std::vector<std::atomic<uint>> & parent, uint id0, uint id1)
+{
+    for(;;)
+    {
+        id0 = union_find_root(parent, id0);
+        id1 = union_find_root(parent, id1);
+        if(id0==id1) return;
+        if(id0<id1) std::swap(id0,id1);
+        // hook the root with bigger id under the other one. If another
+        // thread modified it in the meanwhile, start over
+        uint expected = id0;
+        if(parent[id0].compare_exchange_strong(expected,id1)) return;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint union_find_labels(std::vector<std::atomic<uint>> & parent,
+                       const std::vector<bool>        & mask,
+                       std::vector<int>               & label,
+                       std::vector<uint>              & set_size)
+{
+    uint n = parent.size();
+    PARALLEL_FOR(0, n, 10000, [&](const uint id)
+    {
+        parent[id].store(union_find_root(parent,id));
+    });
+
+    // roots are the smallest element in their set, hence a
+    // forward sweep assigns labels by smallest element id
+    label.resize(n);
+    set_size.clear();
+    for(uint id=0; id<n; ++id)
+    {
+        if(!mask.empty() && mask[id])
+        {
+            label[id] = -1;
+            continue;
+        }
+        uint root = parent[id].load();
+        if(root==id)
+        {
+            label[id] = set_size.size();
+            set_size.push_back(0);
+        }
+        else label[id] = label[root];
+        ++set_size[label[id]];
+    }
+    return set_size.size();
+}
+
+}
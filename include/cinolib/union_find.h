@@ -0,0 +1,73 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_UNION_FIND_H
+#define CINO_UNION_FIND_H
+
+#include <vector>
+#include <atomic>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+
+namespace cinolib
+{
+
+/* Concurrent union-find (disjoint sets) over the ids 0...n-1, stored as a forest
+ * where each set is rooted at its smallest element. Parents are atomics, hence
+ * union_find_merge can be safely called from parallel threads (e.g. from within a
+ * PARALLEL_FOR). The forest must be initialized with parent[id] = id
+*/
+
+CINO_INLINE
+uint union_find_root(std::vector<std::atomic<uint>> & parent, uint id);
+
+CINO_INLINE
+void union_find_merge(std::vector<std::atomic<uint>> & parent, uint id0, uint id1);
+
+// converts a union-find forest into labels sorted by smallest element id
+// (masked elements get label -1). Returns the number of sets
+//
+CINO_INLINE
+uint union_find_labels(std::vector<std::atomic<uint>> & parent,
+                       const std::vector<bool>        & mask,
+                       std::vector<int>               & label,
+                       std::vector<uint>              & set_size);
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "union_find.cpp"
+#endif
+
+#endif // CINO_UNION_FIND_H
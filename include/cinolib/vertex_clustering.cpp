@@ -34,46 +34,87 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/vertex_clustering.h>
-#include <cinolib/bfs.h>
+#include <cinolib/merge_duplicated_verts.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
 
+template<typename real>
+CINO_INLINE
+vec3d clustering_point(const vec2<real> & p)
+{
+    return vec3d(p.x(), p.y(), 0);
+}
+
+template<typename real>
+CINO_INLINE
+vec3d clustering_point(const vec3<real> & p)
+{
+    return vec3d(p.x(), p.y(), p.z());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class Vertex>
 CINO_INLINE
 void vertex_clustering(const std::vector<Vertex>             & points,
                        const double                            proximity_thresh,
                        std::vector<std::unordered_set<uint>> & clusters)
 {
-    // build v2v connectivity based on point proximity
-    std::vector<std::vector<uint>> v2v(points.size());
-    for(uint vid0=0;      vid0<points.size()-1; ++vid0)
-    for(uint vid1=vid0+1; vid1<points.size();   ++vid1)
+    std::vector<uint> cluster, cluster_beg, cluster_pts;
+    vertex_clustering(points, proximity_thresh, cluster, cluster_beg, cluster_pts);
+
+    // new clusters are appended to the ones already in the list
+    uint offset = clusters.size();
+    clusters.resize(offset + cluster_beg.size()-1);
+    for(uint cid=0; cid+1<cluster_beg.size(); ++cid)
     {
-        if (points.at(vid0).dist(points.at(vid1)) < proximity_thresh)
-        {
-            v2v.at(vid0).push_back(vid1);
-            v2v.at(vid1).push_back(vid0);
-        }
+        clusters.at(offset+cid).insert(cluster_pts.begin() + cluster_beg.at(cid),
+                                       cluster_pts.begin() + cluster_beg.at(cid+1));
     }
+}
 
-    // visit the resulting graph with BFS to
-    // isolate clusters of adjacent vertices
-    uint nv   = points.size(),seed = 0;
-
-    std::vector<bool> visited(nv, false);
-    do
-    {
-        std::unordered_set<uint> cluster;
-        bfs(v2v, seed, cluster);
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        clusters.push_back(cluster);
-        for(uint vid : cluster) visited.at(vid) = true;
+template<class Vertex>
+CINO_INLINE
+void vertex_clustering(const std::vector<Vertex> & points,
+                       const double                proximity_thresh,
+                       std::vector<uint>         & cluster,
+                       std::vector<uint>         & cluster_beg,
+                       std::vector<uint>         & cluster_pts)
+{
+    uint np = points.size();
+    uint nc = 0;
 
-        seed = 0;
-        while (seed < nv && visited.at(seed)) ++seed;
+    // clustering points closer than a threshold is exactly what vertex welding does
+    // (i.e. connected components of the proximity graph, sorted by smallest id)
+    if(proximity_thresh>0)
+    {
+        std::vector<vec3d> pts(np);
+        PARALLEL_FOR(0, np, 10000, [&](const uint pid)
+        {
+            pts[pid] = clustering_point(points[pid]);
+        });
+        std::vector<vec3d> centers;
+        merge_duplicated_verts(pts, centers, cluster, proximity_thresh);
+        nc = centers.size();
     }
-    while (seed < nv);
-}
+    else
+    {
+        cluster.resize(np);
+        for(uint pid=0; pid<np; ++pid) cluster[pid] = pid;
+        nc = np;
+    }
+
+    // CSR lists of points per cluster (counting sort)
+    cluster_beg.assign(nc+1,0);
+    for(uint pid=0; pid<np; ++pid) ++cluster_beg[cluster[pid]+1];
+    for(uint cid=0; cid<nc; ++cid) cluster_beg[cid+1] += cluster_beg[cid];
+    cluster_pts.resize(np);
+    std::vector<uint> pos(cluster_beg.begin(), cluster_beg.end()-1);
+    for(uint pid=0; pid<np; ++pid) cluster_pts[pos[cluster[pid]]++] = pid;
 }
 
+}
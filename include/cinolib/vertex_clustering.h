@@ -40,15 +40,21 @@
 #include <vector>
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec2.h>
+#include <cinolib/geometry/vec3.h>
 
 
 namespace cinolib
 {
 
 /* Groups a list of vertices in clusters of elements closer
- * to each other less than a given proximity threshold
+ * to each other less than a given proximity threshold.
+ * Close pairs are found with a uniform grid (in parallel),
+ * and clusters are merged with a union-find. Clusters are
+ * sorted by their smallest point id, and are appended to
+ * the ones already contained in the output list.
  *
- * NOTE: class Vertex should implement the dist() operator
+ * NOTE: class Vertex should be either a vec2<real> or a vec3<real>
 */
 
 template<class Vertex>
@@ -57,6 +63,19 @@ void vertex_clustering(const std::vector<Vertex>             & points,
                        const double                            proximity_thresh,
                        std::vector<std::unordered_set<uint>> & clusters);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// compact output: point pid belongs to cluster[pid]. The points of the i-th cluster
+// are cluster_pts[cluster_beg[i]...cluster_beg[i+1]-1], sorted by increasing id
+//
+template<class Vertex>
+CINO_INLINE
+void vertex_clustering(const std::vector<Vertex> & points,
+                       const double                proximity_thresh,
+                       std::vector<uint>         & cluster,
+                       std::vector<uint>         & cluster_beg,
+                       std::vector<uint>         & cluster_pts);
+
 }
 
 #ifndef  CINO_STATIC_LIB